@@ -81,3 +81,10 @@ if(BUILD_11_LIBSTEST)
     add_subdirectory(src/11-libsTest)
     message("=-=-=-=-=-=-= Build 11-libsTest =-=-=-=-=-=-=")
 endif()
+
+option(BUILD_12_HXLIBSTEST "Build 12-HXLibsTest" ON)
+
+if(BUILD_12_HXLIBSTEST)
+    add_subdirectory(src/12-HXLibsTest)
+    message("=-=-=-=-=-=-= Build 12-HXLibsTest =-=-=-=-=-=-=")
+endif()
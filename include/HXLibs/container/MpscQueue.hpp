@@ -0,0 +1,111 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-16 14:02:31
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <thread>
+
+namespace HX::container {
+
+/**
+ * @brief 侵入式 MPSC 队列的节点, 需要入队的类型继承它即可
+ */
+struct MpscNode {
+    std::atomic<MpscNode*> _mpscNext{nullptr};
+};
+
+/**
+ * @brief 侵入式的无锁 多生产者-单消费者 队列 (Vyukov MPSC)
+ * @note push 是 wait-free 的 (一次 exchange); 节点的所有权由使用者管理
+ * @warning pop 只能由同一个线程调用
+ */
+class MpscQueue {
+public:
+    MpscQueue() noexcept
+        : _head{&_stub}
+        , _tail{&_stub}
+        , _stub{}
+    {}
+
+    MpscQueue& operator=(MpscQueue&&) noexcept = delete;
+
+    /**
+     * @brief 入队 (线程安全)
+     * @param node
+     */
+    void push(MpscNode* node) noexcept {
+        node->_mpscNext.store(nullptr, std::memory_order_relaxed);
+        auto* prev = _head.exchange(node, std::memory_order_seq_cst);
+        prev->_mpscNext.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @brief 出队 (仅消费者线程)
+     * @return MpscNode* 队列为空时返回 nullptr
+     */
+    MpscNode* pop() noexcept {
+        MpscNode* tail = _tail;
+        MpscNode* next = tail->_mpscNext.load(std::memory_order_acquire);
+        if (tail == &_stub) {
+            if (!next) {
+                if (_head.load(std::memory_order_seq_cst) == &_stub) {
+                    return nullptr;
+                }
+                next = _waitNext(tail);
+            }
+            _tail = tail = next;
+            next = tail->_mpscNext.load(std::memory_order_acquire);
+        }
+        if (!next) {
+            if (tail == _head.load(std::memory_order_seq_cst)) {
+                // 只剩最后一个节点, 放回 stub 以便取出它
+                push(&_stub);
+            }
+            next = _waitNext(tail);
+        }
+        _tail = next;
+        return tail;
+    }
+
+    /**
+     * @brief 是否为空 (仅消费者线程)
+     * @note 已经开始入队 (exchange 了 _head) 但还没链接完成的节点也算作非空
+     */
+    bool empty() const noexcept {
+        return _tail == &_stub && _head.load(std::memory_order_seq_cst) == &_stub;
+    }
+
+private:
+    /**
+     * @brief 生产者已经 exchange 了 _head, 但还没来得及链接 next, 等它一下
+     */
+    static MpscNode* _waitNext(MpscNode* node) noexcept {
+        MpscNode* next;
+        while (!(next = node->_mpscNext.load(std::memory_order_acquire))) [[unlikely]] {
+            std::this_thread::yield();
+        }
+        return next;
+    }
+
+    std::atomic<MpscNode*> _head;   // 生产者端
+    MpscNode* _tail;                // 消费者端
+    MpscNode _stub;
+};
+
+} // namespace HX::container
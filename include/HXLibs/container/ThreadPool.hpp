@@ -147,6 +147,19 @@ struct ThreadPool {
         return res;
     }
 
+    /**
+     * @brief 添加不需要结果的任务 (不创建 FutureResult, 没有额外的共享状态)
+     * @tparam Func 右值传入, 无参数; 应当在内部处理异常
+     * @param func 
+     */
+    template <typename Func>
+    void post(Func&& func) {
+        using Lambda = std::decay_t<Func>;
+        _taskQueue.emplace(std::make_unique<MoveOnlyFunctionAny<Lambda>>(
+            Lambda{std::forward<Func>(func)}));
+        _cv.notify_one();
+    }
+
     /**
      * @brief 启动线程池
      * @tparam Md 运行模式 (默认为新建一个管理者线程 (异步))
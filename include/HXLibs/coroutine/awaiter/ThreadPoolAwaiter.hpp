@@ -0,0 +1,98 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 15:42:18
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <utility>
+#include <exception>
+#include <coroutine>
+#include <type_traits>
+
+#include <HXLibs/container/Try.hpp>
+#include <HXLibs/container/NonVoidHelper.hpp>
+#include <HXLibs/container/ThreadPool.hpp>
+#include <HXLibs/coroutine/sync/WaiterList.hpp>
+
+namespace HX::coroutine {
+
+namespace internal {
+
+template <typename Func, typename Res>
+struct [[nodiscard]] ThreadPoolAwaiter : SyncWaiter {
+    ThreadPoolAwaiter(container::ThreadPool& pool, Func&& func)
+        : _pool{pool}
+        , _func{std::forward<Func>(func)}
+        , _res{}
+    {}
+
+    ThreadPoolAwaiter& operator=(ThreadPoolAwaiter&&) noexcept = delete;
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        prepare(handle);
+        _pool.post([this]() noexcept {
+            try {
+                if constexpr (std::is_void_v<Res>) {
+                    std::move(_func)();
+                    _res.setVal(container::NonVoidType<>{});
+                } else {
+                    _res.setVal(std::move(_func)());
+                }
+            } catch (...) {
+                _res.setException(std::current_exception());
+            }
+            wake(); // 线程池的线程不在事件循环中, 因此会投递回原来的事件循环
+        });
+    }
+
+    Res await_resume() {
+        if (!_res.isVal()) [[unlikely]] {
+            _res.rethrow();
+        }
+        if constexpr (!std::is_void_v<Res>) {
+            return _res.move();
+        }
+    }
+private:
+    container::ThreadPool& _pool;
+    std::decay_t<Func> _func;
+    container::Try<Res> _res;
+};
+
+} // namespace internal
+
+/**
+ * @brief 在线程池中执行任务, 协程挂起等待, 完成后回到原来的事件循环上恢复:
+ *        `auto res = co_await coroutine::schedule(pool, [] { return heavy(); });`
+ * @note 执行期间事件循环不会被阻塞 (也不会因为没有 IO 而退出); 任务抛出的异常会在 co_await 处重新抛出.
+ *       不在事件循环中 co_await 时, 协程直接在线程池的线程上恢复
+ * @warning 事件循环需要比任务活得更久 (同 EventLoop::post)
+ * @tparam Func 右值传入, 无参数
+ * @param pool
+ * @param func
+ * @return auto 等待结果为 func 的返回值
+ */
+template <typename Func, typename Res = std::invoke_result_t<Func>>
+auto schedule(container::ThreadPool& pool, Func&& func) {
+    return internal::ThreadPoolAwaiter<Func, Res>{pool, std::forward<Func>(func)};
+}
+
+} // namespace HX::coroutine
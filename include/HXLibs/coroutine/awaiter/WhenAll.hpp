@@ -0,0 +1,199 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-16 17:28:04
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <tuple>
+#include <span>
+#include <vector>
+#include <utility>
+#include <exception>
+
+#include <HXLibs/container/Uninitialized.hpp>
+#include <HXLibs/container/NonVoidHelper.hpp>
+#include <HXLibs/coroutine/concepts/Awaiter.hpp>
+#include <HXLibs/coroutine/task/Task.hpp>
+#include <HXLibs/coroutine/promise/FrameAllocator.hpp>
+
+namespace HX::coroutine {
+
+template <AwaitableLike... Ts>
+using WhenAllReturnType = std::tuple<
+    container::NonVoidType<AwaiterReturnValue<Ts>>...
+>;
+
+namespace internal {
+
+/**
+ * @brief WhenAll 控制块 (所有子协程共用一个)
+ */
+struct WhenAllCtlBlock {
+    std::size_t count;              // 未完成的子协程数 (+1, 为启动阶段的 whenAll 自己)
+    std::coroutine_handle<> previous;
+    std::exception_ptr exception;   // 第一个异常
+};
+
+/**
+ * @brief 子协程结束时: 如果是最后一个, 则恢复 whenAll 协程
+ */
+struct WhenAllFinalAwaiter {
+    constexpr bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<>) const noexcept {
+        if (--ctlBlock->count == 0) {
+            return ctlBlock->previous;
+        }
+        return std::noop_coroutine();
+    }
+    constexpr void await_resume() const noexcept {}
+
+    WhenAllCtlBlock* ctlBlock;
+};
+
+struct WhenAllPromise : PooledFrame {
+    using InitStrategy = std::suspend_always;
+    using DeleStrategy = WhenAllFinalAwaiter;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    auto get_return_object() noexcept {
+        return std::coroutine_handle<WhenAllPromise>::from_promise(*this);
+    }
+    WhenAllFinalAwaiter final_suspend() noexcept {
+        return {_ctlBlock};
+    }
+    void return_value(WhenAllCtlBlock* ctlBlock) noexcept {
+        _ctlBlock = ctlBlock;
+    }
+    void unhandled_exception() noexcept {
+        std::terminate(); // 子协程内部已经捕获了, 不会到这里
+    }
+    WhenAllCtlBlock* _ctlBlock;
+};
+
+using WhenAllTask = Task<WhenAllCtlBlock*, WhenAllPromise>;
+
+struct WhenAllAwaiter {
+    constexpr bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> coroutine) const noexcept {
+        ctlBlock.previous = coroutine;
+        for (auto const& co : cos) {
+            static_cast<std::coroutine_handle<>>(co).resume();
+        }
+        // 启动阶段持有的一个计数, 保证子协程不会在此之前恢复 whenAll;
+        // 如果全部都同步完成了, 就不挂起
+        return --ctlBlock.count != 0;
+    }
+    constexpr void await_resume() const noexcept {}
+
+    std::span<WhenAllTask const> cos;
+    WhenAllCtlBlock& ctlBlock;
+};
+
+template <AwaitableLike T, typename Res>
+WhenAllTask start(T&& t, Res& res, WhenAllCtlBlock& ctlBlock) {
+    try {
+        if constexpr (std::is_void_v<AwaiterReturnValue<T>>) {
+            co_await t;
+            res.set(container::NonVoidHelper<>{});
+        } else {
+            res.set(co_await t);
+        }
+    } catch (...) {
+        if (!ctlBlock.exception) {
+            ctlBlock.exception = std::current_exception();
+        }
+    }
+    co_return &ctlBlock;
+}
+
+template <
+    std::size_t... Idx,
+    AwaitableLike... Ts,
+    typename ResType = WhenAllReturnType<Ts...>
+>
+Task<ResType> whenAll(std::index_sequence<Idx...>, Ts&&... ts) {
+    // 1. 存储所有的返回值
+    std::tuple<container::Uninitialized<AwaiterReturnValue<Ts>>...> res;
+
+    // 2. 创建所有协程
+    WhenAllCtlBlock block{sizeof...(Ts) + 1, nullptr, nullptr};
+    std::array<WhenAllTask, sizeof...(Ts)> cos {
+        start(std::forward<Ts>(ts), std::get<Idx>(res), block)...
+    };
+
+    // 3. 启动, 并等待全部完成 (挂起)
+    co_await WhenAllAwaiter{cos, block};
+
+    if (block.exception) [[unlikely]] {
+        std::rethrow_exception(block.exception);
+    }
+    co_return ResType{std::get<Idx>(res).move()...};
+}
+
+} // namespace internal
+
+/**
+ * @brief 并发等待所有协程完成
+ * @note 会按顺序启动所有协程, 最后一个完成时才恢复; 如果有异常, 则等待全部完成后重新抛出第一个异常
+ * @warning 所有协程应该在同一个事件循环上完成 (计数不是线程安全的)
+ * @tparam Ts
+ * @param ts
+ * @return Task<std::tuple<...>> 返回值 (void 对应 container::NonVoidHelper<>)
+ */
+template <AwaitableLike... Ts>
+[[nodiscard]] auto whenAll(Ts&&... ts) {
+    return internal::whenAll(
+        std::make_index_sequence<sizeof...(ts)>(),
+        std::forward<Ts>(ts)...
+    );
+}
+
+/**
+ * @brief 并发等待所有协程完成 (数量在运行时确定)
+ * @note 同 whenAll(Ts&&...)
+ * @tparam T
+ * @param ts
+ * @return Task<std::vector<...>> 按顺序的返回值
+ */
+template <
+    AwaitableLike T,
+    typename Res = container::NonVoidType<AwaiterReturnValue<T>>
+>
+[[nodiscard]] Task<std::vector<Res>> whenAll(std::vector<T> ts) {
+    std::vector<container::Uninitialized<AwaiterReturnValue<T>>> res(ts.size());
+    internal::WhenAllCtlBlock block{ts.size() + 1, nullptr, nullptr};
+    std::vector<internal::WhenAllTask> cos;
+    cos.reserve(ts.size());
+    for (std::size_t i = 0; i < ts.size(); ++i) {
+        cos.push_back(internal::start(ts[i], res[i], block));
+    }
+
+    co_await internal::WhenAllAwaiter{cos, block};
+
+    if (block.exception) [[unlikely]] {
+        std::rethrow_exception(block.exception);
+    }
+    std::vector<Res> ans;
+    ans.reserve(res.size());
+    for (auto& r : res) {
+        ans.push_back(r.move());
+    }
+    co_return ans;
+}
+
+} // namespace HX::coroutine
@@ -25,6 +25,7 @@
 #include <HXLibs/container/UninitializedNonVoidVariant.hpp>
 #include <HXLibs/coroutine/concepts/Awaiter.hpp>
 #include <HXLibs/coroutine/task/Task.hpp>
+#include <HXLibs/coroutine/promise/FrameAllocator.hpp>
 
 namespace HX::coroutine {
 
@@ -42,7 +43,7 @@ struct WhenAnyCtlBlock {
     std::coroutine_handle<> previous;
 };
 
-struct WhenAnyPromise {
+struct WhenAnyPromise : PooledFrame {
     using InitStrategy = std::suspend_always;
     using DeleStrategy = PreviousAwaiter;
 
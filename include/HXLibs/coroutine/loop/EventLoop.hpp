@@ -18,22 +18,40 @@
  * limitations under the License.
  */
 
-#include <thread>
+#include <atomic>
+#include <cerrno>
 #include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <coroutine>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
 
-#if defined (_WIN32)
+#if defined(__linux__)
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#elif defined (_WIN32)
 #include <array>
 #endif
 
 #include <HXLibs/platform/EventLoopApi.hpp>
 
 #include <HXLibs/container/Try.hpp>
+#include <HXLibs/container/MpscQueue.hpp>
 #include <HXLibs/coroutine/task/Task.hpp>
 #include <HXLibs/coroutine/task/AioTask.hpp>
 #include <HXLibs/coroutine/loop/TimerLoop.hpp>
+#include <HXLibs/coroutine/loop/LoopMetrics.hpp>
+#include <HXLibs/coroutine/loop/ProvidedBufRing.hpp>
+#include <HXLibs/coroutine/loop/FixedBufPool.hpp>
 #include <HXLibs/coroutine/concepts/Awaiter.hpp>
 #include <HXLibs/coroutine/awaiter/WhenAny.hpp>
+#include <HXLibs/coroutine/awaiter/WhenAll.hpp>
 #include <HXLibs/exception/ErrorHandlingTools.hpp>
 
 namespace HX::coroutine {
@@ -54,7 +72,7 @@ constexpr struct ::__kernel_timespec durationToKernelTimespec(
 
 #elif defined (_WIN32)
 
-inline DWORD toDwMilliseconds(std::chrono::system_clock::duration dur) {
+inline DWORD toDwMilliseconds(std::chrono::steady_clock::duration dur) {
     using namespace std::chrono;
 
     // 转换为毫秒（有符号 64 位整数）
@@ -73,6 +91,30 @@ inline DWORD toDwMilliseconds(std::chrono::system_clock::duration dur) {
     #error "Does not support the current operating system."
 #endif
 
+/**
+ * @brief io_uring 环的创建方式 (Windows 下忽略)
+ * @note 如果内核不支持, 会自动依次回退到更保守的方式, 直至 Default
+ */
+enum class RingProfile : uint8_t {
+    Default,        // 中断驱动 (flags = 0)
+    CoopTaskrun,    // 完成事件不再通过中断打断线程, 而是在下次进入内核时处理 (5.19+)
+    SingleIssuer,   // 只有创建环的线程提交 + 仅在等待时处理完成事件 (6.1+), 事件循环是单线程的, 正好合适
+    SqPoll,         // 内核线程轮询提交队列, 提交无需系统调用; 会常驻占用一个 CPU 直至空闲超时
+};
+
+/**
+ * @brief 事件循环的配置
+ */
+struct EventLoopConfig {
+    unsigned int ringSize = 1024U;          // 环形队列的长度
+    RingProfile profile = RingProfile::Default;
+    unsigned int sqThreadIdle = 1000U;      // (SqPoll) 内核线程空闲多久后休眠 (单位: 毫秒)
+    int sqThreadCpu = -1;                   // (SqPoll) 内核线程绑定的 CPU, -1 为不绑定
+    // 不小于它的 net::IO::fullySendZc 使用零拷贝发送 (仅 io_uring);
+    // 默认关闭: 零拷贝需要等待通知、固定页面, 只有大块发送且网卡支持时才可能更快, 请按实测开启
+    std::size_t sendZcThreshold = static_cast<std::size_t>(-1);
+};
+
 namespace internal {
 
 #if defined(__linux__)
@@ -96,18 +138,68 @@ inline unsigned int getIoUringMaxSize() {
 }
 
 struct IoUring {
-    explicit IoUring(unsigned int size = 1024U)
+    explicit IoUring(EventLoopConfig const& config = {})
         : _ring{}
         , _numSqesPending{}
+        , _bufRing{}
+        , _isBufRingUnsupported{false}
+        , _fixedBufPool{}
+        , _isFixedBufUnsupported{false}
+        , _fixedFileNum{}
+        , _sendZcThreshold{config.sendZcThreshold}
+        , _sendmsgZcThreshold{config.sendZcThreshold}
+        , _freePipes{}
+        , _profile{config.profile}
+        , _wakeupFd{::eventfd(0, EFD_CLOEXEC)}
+        , _wakeupBuf{}
+        , _isWakeupArmed{false}
+        , _metrics{}
     {
-        unsigned int flags = 0;
-        exception::IoUringErrorHandlingTools::check(
-            ::io_uring_queue_init(size, &_ring, flags)
-        );
+        if (_wakeupFd < 0) [[unlikely]] {
+            throw std::system_error(errno, std::system_category());
+        }
+        // 内核拒绝 (旧内核不认识的 flag 返回 -EINVAL, 无权限的 SQPOLL 返回 -EPERM) 时逐级回退
+        for (;;) {
+            ::io_uring_params params{};
+            params.flags = _profileFlags(_profile);
+            if (_profile == RingProfile::SqPoll) {
+                params.sq_thread_idle = config.sqThreadIdle;
+                if (config.sqThreadCpu >= 0) {
+                    params.flags |= IORING_SETUP_SQ_AFF;
+                    params.sq_thread_cpu = static_cast<__u32>(config.sqThreadCpu);
+                }
+            }
+            int res = ::io_uring_queue_init_params(config.ringSize, &_ring, &params);
+            if (res == 0) [[likely]] {
+                break;
+            }
+            if (_profile == RingProfile::Default || (res != -EINVAL && res != -EPERM)) {
+                exception::IoUringErrorHandlingTools::check(res);
+            }
+            _profile = _fallback(_profile);
+        }
+        if (_sendZcThreshold != static_cast<std::size_t>(-1)) {
+            _probeSendZc();
+        }
     }
 
     ~IoUring() noexcept {
+        for (auto const& pipe : _freePipes) {
+            ::close(pipe.rd);
+            ::close(pipe.wr);
+        }
+        _bufRing.reset();
+        _fixedBufPool.reset();
         ::io_uring_queue_exit(&_ring);
+        ::close(_wakeupFd);
+    }
+
+    /**
+     * @brief 唤醒阻塞在 run() 中的事件循环 (线程安全)
+     */
+    void wakeup() noexcept {
+        uint64_t one = 1;
+        [[maybe_unused]] auto _ = ::write(_wakeupFd, &one, sizeof(one));
     }
 
     AioTask makeAioTask() {
@@ -117,13 +209,143 @@ struct IoUring {
         return AioTask{getSqe()};
     }
 
+    MultishotAioTask makeMultishotAioTask() {
+        return MultishotAioTask{getSqe()};
+    }
+
     bool isRun() const noexcept {
         return _numSqesPending;
     }
 
-    void run(std::optional<std::chrono::system_clock::duration> timeout) {
+    /**
+     * @brief 获取实际生效的环创建方式 (可能因内核不支持而回退)
+     * @return RingProfile
+     */
+    RingProfile profile() const noexcept {
+        return _profile;
+    }
+
+    /**
+     * @brief 注册稀疏的文件表 (registered files), 之后 accept_direct 等可以把 fd 直接放入其中
+     * @param num 表的大小 (不会超过 RLIMIT_NOFILE)
+     * @return true 已经注册 (重复调用不会重复注册)
+     * @return false 内核不支持
+     */
+    bool registerFixedFiles(unsigned int num) {
+        if (_fixedFileNum) {
+            return true;
+        }
+        if (::rlimit lim; !::getrlimit(RLIMIT_NOFILE, &lim) && lim.rlim_cur < num) {
+            num = static_cast<unsigned int>(lim.rlim_cur);
+        }
+        if (::io_uring_register_files_sparse(&_ring, num) < 0) [[unlikely]] {
+            return false;
+        }
+        _fixedFileNum = num;
+        return true;
+    }
+
+    /**
+     * @brief 用于 splice 的管道 (文件 -> 管道 -> 套接字)
+     */
+    struct SplicePipe {
+        int rd;             // 读端
+        int wr;             // 写端
+        unsigned int size;  // 管道容量, 即单次 splice 的最大字节数
+    };
+
+    /**
+     * @brief 借出一个用于 splice 的管道 (事件循环内复用, 不够时创建)
+     * @note 管道同时只能被一个传输使用, 否则数据会交错, 因此需要借出与归还
+     * @return SplicePipe 
+     */
+    SplicePipe acquirePipe() {
+        if (!_freePipes.empty()) [[likely]] {
+            auto pipe = _freePipes.back();
+            _freePipes.pop_back();
+            return pipe;
+        }
+        int fds[2];
+        if (::pipe2(fds, O_CLOEXEC) < 0) [[unlikely]] {
+            throw std::system_error(errno, std::system_category());
+        }
+        // 尽量加大管道, 以减少 splice 的次数; 超过 /proc/sys/fs/pipe-max-size 时保持默认
+        int size = ::fcntl(fds[1], F_SETPIPE_SZ, kSplicePipeSize);
+        if (size < 0) {
+            size = ::fcntl(fds[1], F_GETPIPE_SZ);
+        }
+        return {fds[0], fds[1], static_cast<unsigned int>(size > 0 ? size : 1 << 16)};
+    }
+
+    /**
+     * @brief 归还管道
+     * @param pipe 
+     * @param isDirty 管道中可能还有残留的数据 (如传输出错), 此时直接关闭而不复用
+     */
+    void releasePipe(SplicePipe pipe, bool isDirty) noexcept {
+        if (isDirty || _freePipes.size() >= kMaxFreePipeNum) [[unlikely]] {
+            ::close(pipe.rd);
+            ::close(pipe.wr);
+            return;
+        }
+        _freePipes.push_back(pipe);
+    }
+
+    /**
+     * @brief 获取 provided buffer ring (第一次调用时注册)
+     * @return ProvidedBufRing* 如果内核不支持, 则为 nullptr
+     */
+    ProvidedBufRing* getProvidedBufRing() {
+        if (!_bufRing && !_isBufRingUnsupported) [[unlikely]] {
+            try {
+                _bufRing = std::make_unique<ProvidedBufRing>(
+                    _ring, kBufRingGroupId, kBufRingEntries, kBufRingBufSize);
+            } catch (std::system_error const&) {
+                _isBufRingUnsupported = true;
+            }
+        }
+        return _bufRing.get();
+    }
+
+    /**
+     * @brief 获取注册缓冲区池 (第一次调用时注册)
+     * @return FixedBufPool* 如果内核不支持 (或超出 RLIMIT_MEMLOCK), 则为 nullptr
+     */
+    FixedBufPool* getFixedBufPool() {
+        if (!_fixedBufPool && !_isFixedBufUnsupported) [[unlikely]] {
+            try {
+                _fixedBufPool = std::make_unique<FixedBufPool>(
+                    _ring, kFixedBufNum, kFixedBufSize);
+            } catch (std::system_error const&) {
+                _isFixedBufUnsupported = true;
+            }
+        }
+        return _fixedBufPool.get();
+    }
+
+    /**
+     * @brief 零拷贝发送 (IORING_OP_SEND_ZC) 的阈值: 不小于它的发送才值得使用零拷贝
+     * @return std::size_t 未开启或内核不支持时为 std::size_t 的最大值
+     */
+    std::size_t sendZcThreshold() const noexcept {
+        return _sendZcThreshold;
+    }
+
+    /**
+     * @brief 零拷贝聚集发送 (IORING_OP_SENDMSG_ZC) 的阈值, 同 sendZcThreshold
+     * @return std::size_t 未开启或内核不支持时为 std::size_t 的最大值
+     */
+    std::size_t sendmsgZcThreshold() const noexcept {
+        return _sendmsgZcThreshold;
+    }
+
+    void run(std::optional<std::chrono::steady_clock::duration> timeout) {
         ::io_uring_cqe* cqe = nullptr;
 
+        if (!_isWakeupArmed) [[unlikely]] {
+            _armWakeup();
+        }
+
         ::__kernel_timespec timespec; // 设置超时为无限阻塞
         ::__kernel_timespec* timespecPtr = nullptr;
         if (timeout.has_value()) {
@@ -132,9 +354,12 @@ struct IoUring {
         }
 
         // 阻塞等待内核, 返回是错误码; cqe是完成队列, 为传出参数
+        auto waitBegin = LoopMetrics::now();
+        unsigned numSubmit = ::io_uring_sq_ready(&_ring);
         int res = ::io_uring_submit_and_wait_timeout(
             &_ring, &cqe, 1, timespecPtr, nullptr);
-        
+        _metrics.onWait(waitBegin, numSubmit);
+
         // 超时
         if (res == -ETIME) {
             // 内部直接 if (nr) { ... }, 此处调用传参 0, 毫无作用
@@ -147,27 +372,140 @@ struct IoUring {
             throw std::system_error(-res, std::system_category());
         }
 
-        unsigned head, numGot = 0;
+        auto resumeBegin = LoopMetrics::now();
+        unsigned head, numGot = 0, numDone = 0;
         io_uring_for_each_cqe(&_ring, head, cqe) {
             ++numGot;
-            if (cqe->res == -ECANCELED) { // 操作已取消 (比如超时了)
+            if (cqe->user_data == LIBURING_UDATA_TIMEOUT) [[unlikely]] {
+                // 旧内核不支持 IORING_ENTER_EXT_ARG 时, liburing 会自行提交一个超时 sqe
+                continue;
+            }
+            if (cqe->user_data == kWakeupUserData) { // 被 wakeup() 唤醒, 不计入任务数
+                _isWakeupArmed = false;
+                continue;
+            }
+            if (cqe->user_data & MultishotAioTask::kUserDataTag) {
+                // 多发任务: 带有 IORING_CQE_F_MORE 说明该 sqe 仍然有效, 不算完成
+                bool isMore = cqe->flags & IORING_CQE_F_MORE;
+                numDone += !isMore;
+                auto* task = reinterpret_cast<MultishotAioTask*>(
+                    cqe->user_data & ~MultishotAioTask::kUserDataTag);
+                if (auto h = task->_pushResult(cqe->res, isMore)) {
+                    tasks.push_back(h);
+                }
+                continue;
+            }
+            if (cqe->user_data == AioTask::kDetachedUserData) { // 不关心结果的任务
+                numDone += !(cqe->flags & IORING_CQE_F_MORE);
+                continue;
+            }
+            if (cqe->user_data & SendZcNotifier::kUserDataTag) {
+                // 零拷贝发送: 发送结果立即恢复, 通知只释放缓冲区的引用
+                auto* state = reinterpret_cast<SendZcNotifier::State*>(
+                    cqe->user_data & ~SendZcNotifier::kUserDataTag);
+                if (!(cqe->flags & IORING_CQE_F_NOTIF)) {
+                    auto* task = std::exchange(state->task, nullptr);
+                    task->_res = cqe->res;
+                    tasks.push_back(task->_previous);
+                    if (cqe->flags & IORING_CQE_F_MORE) { // 之后还有通知, sqe 仍未完成
+                        continue;
+                    }
+                }
+                ++numDone;
+                if (auto h = SendZcNotifier::_release(state)) {
+                    tasks.push_back(h);
+                }
+                continue;
+            }
+            auto* task = reinterpret_cast<AioTask*>(
+                cqe->user_data & ~AioTask::kCancelableTag);
+            ++numDone;
+            if (cqe->res == -ECANCELED // 操作已取消 (比如超时了)
+                && !(cqe->user_data & AioTask::kCancelableTag) // 可取消的任务仍需恢复
+            ) {
                 continue;
             }
-            auto* task = reinterpret_cast<AioTask*>(cqe->user_data);
             task->_res = cqe->res;
+            task->_cqeFlags = cqe->flags;
             tasks.push_back(task->_previous);
         }
 
         // 手动前进完成队列的头部 (相当于批量io_uring_cqe_seen)
         ::io_uring_cq_advance(&_ring, numGot);
-        _numSqesPending -= static_cast<std::size_t>(numGot);
+        _numSqesPending -= static_cast<std::size_t>(numDone);
         for (const auto& it : tasks) {
             it.resume();
         }
+        _metrics.onResume(resumeBegin, numGot, tasks.size(), _numSqesPending);
         tasks.clear();
     }
 
+    /**
+     * @brief 获取事件循环的指标
+     * @return LoopMetrics&
+     */
+    LoopMetrics& metrics() noexcept {
+        return _metrics;
+    }
+
 private:
+    static unsigned int _profileFlags(RingProfile profile) noexcept {
+        switch (profile) {
+        case RingProfile::CoopTaskrun:
+            return IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG;
+        case RingProfile::SingleIssuer:
+            // DEFER_TASKRUN 要求 SINGLE_ISSUER, 完成事件只在 io_uring_enter(GETEVENTS) 时处理,
+            // 而 run() 每次都是 submit_and_wait, 因此不会饿死
+            return IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+        case RingProfile::SqPoll:
+            return IORING_SETUP_SQPOLL;
+        default:
+            return 0;
+        }
+    }
+
+    static RingProfile _fallback(RingProfile profile) noexcept {
+        switch (profile) {
+        case RingProfile::SingleIssuer:
+            return RingProfile::CoopTaskrun;
+        default:
+            return RingProfile::Default;
+        }
+    }
+
+    /**
+     * @brief 探测内核是否支持零拷贝发送 (SEND_ZC: 6.0+, SENDMSG_ZC: 6.1+), 不支持的阈值改为最大值
+     * @note 只在创建环时探测一次; 单次发送的错误 (如 -EINVAL) 由调用方就地回退, 不影响整个事件循环
+     */
+    void _probeSendZc() noexcept {
+        ::io_uring_probe* probe = ::io_uring_get_probe_ring(&_ring);
+        if (!probe || !::io_uring_opcode_supported(probe, IORING_OP_SEND_ZC)) [[unlikely]] {
+            _sendZcThreshold = static_cast<std::size_t>(-1);
+        }
+        if (!probe || !::io_uring_opcode_supported(probe, IORING_OP_SENDMSG_ZC)) [[unlikely]] {
+            _sendmsgZcThreshold = static_cast<std::size_t>(-1);
+        }
+        if (probe) [[likely]] {
+            ::io_uring_free_probe(probe);
+        }
+    }
+
+    /**
+     * @brief 在 eventfd 上挂一个读, 用于跨线程唤醒; 它不计入 _numSqesPending,
+     *        因此不会让 isRun() 一直为真
+     * @note eventfd 是阻塞的: 没有数据时由内核挂起等待; 如果是 EFD_NONBLOCK, 部分内核会直接以 -EAGAIN 完成,
+     *       每一轮都会重新挂读并立即返回, 事件循环空转
+     */
+    void _armWakeup() noexcept {
+        ::io_uring_sqe* sqe = ::io_uring_get_sqe(&_ring);
+        if (!sqe) [[unlikely]] {
+            return; // 队列满了, 下次再挂
+        }
+        ::io_uring_prep_read(sqe, _wakeupFd, &_wakeupBuf, sizeof(_wakeupBuf), 0);
+        ::io_uring_sqe_set_data64(sqe, kWakeupUserData);
+        _isWakeupArmed = true;
+    }
+
     ::io_uring_sqe* getSqe() {
         // 获取一个任务
         ::io_uring_sqe* sqe = ::io_uring_get_sqe(&_ring);
@@ -184,7 +522,11 @@ private:
             // 提交了, 应该有空位, 那可以
             sqe = ::io_uring_get_sqe(&_ring);
 #else
+            _metrics.onSqFull();
+            auto waitBegin = LoopMetrics::now();
+            unsigned numSubmit = ::io_uring_sq_ready(&_ring);
             ::io_uring_submit_and_wait(&_ring, 1); // 直接挂起等待操作系统完成了再说
+            _metrics.onWait(waitBegin, numSubmit);
             sqe = ::io_uring_get_sqe(&_ring);
             if (!sqe) {
                 throw std::runtime_error("Still failed to get sqe after wait");
@@ -195,8 +537,31 @@ private:
         return sqe;
     }
 
+    // 不会是合法的 AioTask 指针, 也没有 MultishotAioTask::kUserDataTag (先于 AioTask::kCancelableTag 判断)
+    inline static constexpr __u64 kWakeupUserData = 2;
+    inline static constexpr unsigned short kBufRingGroupId = 0;
+    inline static constexpr unsigned int kBufRingEntries = 256;
+    inline static constexpr std::size_t kBufRingBufSize = 1 << 14; // 16kb, 同 net::IO::kBufMaxSize
+    inline static constexpr unsigned int kFixedBufNum = 8;
+    inline static constexpr std::size_t kFixedBufSize = 1 << 18; // 256kb, 共 2mb, 低于常见的 RLIMIT_MEMLOCK (8mb)
+    inline static constexpr int kSplicePipeSize = 1 << 20;  // 期望的管道容量 (1mb)
+    inline static constexpr std::size_t kMaxFreePipeNum = 16;   // 最多缓存的空闲管道数
+
     ::io_uring _ring;
     std::size_t _numSqesPending; // 未完成的任务数
+    std::unique_ptr<ProvidedBufRing> _bufRing;  // 懒注册
+    bool _isBufRingUnsupported;
+    std::unique_ptr<FixedBufPool> _fixedBufPool; // 懒注册
+    bool _isFixedBufUnsupported;
+    unsigned int _fixedFileNum; // 注册文件表的大小, 0 为未注册
+    std::size_t _sendZcThreshold; // 零拷贝发送的阈值, 不支持时为最大值
+    std::size_t _sendmsgZcThreshold; // 零拷贝聚集发送的阈值, 不支持时为最大值
+    std::vector<SplicePipe> _freePipes; // 空闲的 splice 管道
+    RingProfile _profile;       // 实际生效的环创建方式
+    int _wakeupFd;              // 跨线程唤醒用的 eventfd
+    uint64_t _wakeupBuf;
+    bool _isWakeupArmed;
+    LoopMetrics _metrics;
     std::vector<std::coroutine_handle<>> tasks; // 协程任务队列
                                                 // 提取为成员, 避免频繁构造临时变量导致频繁扩容
 };
@@ -204,7 +569,7 @@ private:
 #elif defined(_WIN32)
 
 struct Iocp {
-    Iocp() 
+    explicit Iocp(EventLoopConfig const& = {})
         : _iocpHandle{exception::checkWinError(::CreateIoCompletionPort(
             INVALID_HANDLE_VALUE,
             nullptr,
@@ -212,6 +577,7 @@ struct Iocp {
             0))}
         , _taskCnt{}
         , _tasks{}
+        , _metrics{}
     {
         platform::internal::InitWin32Api::ensure();
     }
@@ -232,7 +598,14 @@ struct Iocp {
         return _taskCnt._numSqesPending || _taskCnt._runingHandle.size();
     }
 
-    void run(std::optional<std::chrono::system_clock::duration> timeout) {
+    /**
+     * @brief 唤醒阻塞在 run() 中的事件循环 (线程安全)
+     */
+    void wakeup() noexcept {
+        ::PostQueuedCompletionStatus(_iocpHandle, 0, 0, nullptr);
+    }
+
+    void run(std::optional<std::chrono::steady_clock::duration> timeout) {
 /*
 // 只能一次获取一个
 BOOL GetQueuedCompletionStatus(
@@ -260,6 +633,7 @@ BOOL GetQueuedCompletionStatusEx(
         if (timeout) {
             dw = toDwMilliseconds(*timeout);
         }
+        auto waitBegin = LoopMetrics::now();
         bool ok = ::GetQueuedCompletionStatusEx(
             _iocpHandle,
             arr.data(),
@@ -268,13 +642,20 @@ BOOL GetQueuedCompletionStatusEx(
             dw,
             false
         );
+        _metrics.onWait(waitBegin, 0);
 
         if (!ok) [[unlikely]] { // 超时
             return;
         }
 
+        auto resumeBegin = LoopMetrics::now();
+        ::ULONG wakeupCnt = 0;
         for (::ULONG i = 0; i < n; ++i) {
             auto ptr = arr[i];
+            if (!ptr.lpOverlapped) { // 被 wakeup() 唤醒, 不计入任务数
+                ++wakeupCnt;
+                continue;
+            }
             auto task = std::unique_ptr<AioTask::_AioIocpData>{
                 reinterpret_cast<AioTask::_AioIocpData*>(ptr.lpOverlapped)
             };
@@ -293,10 +674,19 @@ BOOL GetQueuedCompletionStatusEx(
             t.resume();
         }
         
-        _taskCnt._numSqesPending -= static_cast<std::size_t>(n);
+        _taskCnt._numSqesPending -= static_cast<std::size_t>(n - wakeupCnt);
+        _metrics.onResume(resumeBegin, n, _tasks.size(), _taskCnt._numSqesPending);
         _tasks.clear();
     }
 
+    /**
+     * @brief 获取事件循环的指标
+     * @return LoopMetrics&
+     */
+    LoopMetrics& metrics() noexcept {
+        return _metrics;
+    }
+
     ~Iocp() noexcept {
         if (_iocpHandle) {
             ::CloseHandle(_iocpHandle);
@@ -307,6 +697,7 @@ private:
     ::HANDLE _iocpHandle;
     TaskCnt _taskCnt;
     std::vector<std::coroutine_handle<>> _tasks;
+    LoopMetrics _metrics;
 };
 
 #else
@@ -323,17 +714,77 @@ using EventDrive
     #error "Does not support the current operating system."
 #endif
 
+/**
+ * @brief 投递到事件循环的任务
+ */
+struct PostTask : container::MpscNode {
+    virtual void run() = 0;
+    virtual void destroy() noexcept = 0; // 事件循环析构时, 丢弃未执行的任务
+protected:
+    // 派生的等待体 (如 SyncWaiter) 不会通过基类指针删除, 这里声明为虚函数只是为了满足 -Wnon-virtual-dtor
+    virtual ~PostTask() noexcept = default;
+};
+
+template <typename Func>
+struct PostTaskAny final : PostTask {
+    PostTaskAny(Func&& func)
+        : _func{std::move(func)}
+    {}
+
+    void run() override {
+        std::unique_ptr<PostTaskAny> self{this};
+        _func();
+    }
+
+    void destroy() noexcept override {
+        delete this;
+    }
+private:
+    Func _func;
+};
+
 } // namespace internal
 
 /**
  * @brief 协程事件循环
  */
 struct EventLoop {
-    EventLoop() 
-        : _eventDrive{}
+    /**
+     * @brief 创建事件循环
+     * @param config 事件循环的配置 (如 io_uring 环的创建方式)
+     */
+    explicit EventLoop(EventLoopConfig const& config = {})
+        : _eventDrive{config}
         , _timerLoop{}
+        , _postQueue{}
+        , _isPostPending{false}
+        , _postingNum{0}
+        , _retainNum{0}
     {}
 
+    EventLoop& operator=(EventLoop&&) noexcept = delete;
+
+    ~EventLoop() noexcept {
+        // postGuarded() 的投递方入队后, 本线程可能已经执行完任务并析构, 而投递方还在 wakeup(), 需要等它离开
+        while (_postingNum.load(std::memory_order_acquire)) [[unlikely]] {
+            std::this_thread::yield();
+        }
+        while (auto* task = _postQueue.pop()) {
+            static_cast<internal::PostTask*>(task)->destroy();
+        }
+        if (_current == this) {
+            _current = nullptr;
+        }
+    }
+
+    /**
+     * @brief 获取当前线程最近一次 start / run / runOnce 的事件循环
+     * @return EventLoop* 没有则为 nullptr
+     */
+    static EventLoop* current() noexcept {
+        return _current;
+    }
+
     /**
      * @brief 启动协程, 协程内部如果挂起, 应该调用 run() 进入事件循环, 以恢复挂起.
      * @tparam T 
@@ -341,6 +792,7 @@ struct EventLoop {
      */
     template <CoroutineObject T>
     void start(T& mainTask) {
+        _current = this;
         static_cast<std::coroutine_handle<>>(mainTask).resume();
     }
 
@@ -393,18 +845,246 @@ struct EventLoop {
      * @brief 启动事件循环
      */
     void run() {
+        _current = this;
+        RunningGuard _{this};
         for (;;) {
-            auto timeout = _timerLoop.run();
-            if (_eventDrive.isRun()) [[likely]] {
+            _runPosted();
+            auto timeout = _runTimer();
+            // 定时器恢复的协程可能在本线程投递了任务 (不会唤醒), 需要在阻塞前检查标记
+            if (_isPostPending.load(std::memory_order_acquire)) [[unlikely]] {
+                timeout = std::chrono::steady_clock::duration{};
+            }
+            if (_eventDrive.isRun() || timeout || _retainNum || _hasIncomingPost()) [[likely]] {
+                // 即便只有定时器, 也阻塞在内核的等待中 (io_uring 的超时等待 / IOCP 的超时),
+                // 这样下一个定时器到期或者有 IO 完成时, 都能及时醒来
                 _eventDrive.run(timeout);
-            } else if (timeout) {
-                std::this_thread::sleep_for(*timeout);
             } else [[unlikely]] {
                 break;
             }
         }
     }
 
+    /**
+     * @brief 执行一轮事件循环, 供上层调度器 (如 Scheduler) 驱动
+     * @param isBlock true: 阻塞直到 IO 完成 / 定时器到期 / 被 post、wakeup 唤醒 (即便没有任何 IO 与定时器);
+     *                false: 只处理已经就绪的事件
+     */
+    void runOnce(bool isBlock) {
+        _current = this;
+        RunningGuard _{this};
+        _runPosted();
+        auto timeout = _runTimer();
+        if (_isPostPending.load(std::memory_order_acquire) || !isBlock) {
+            timeout = std::chrono::steady_clock::duration{};
+        }
+        _eventDrive.run(timeout);
+    }
+
+    /**
+     * @brief 唤醒阻塞在内核中的事件循环 (线程安全)
+     */
+    void wakeup() noexcept {
+        _eventDrive.wakeup();
+    }
+
+    /**
+     * @brief 投递一个可调用对象, 由该事件循环的线程执行 (线程安全)
+     * @note 如果事件循环正阻塞在内核中, 会被唤醒; 如果事件循环当前没有在 run(),
+     *       则会在下一次 run() 时执行
+     * @warning 事件循环析构时, 未执行的任务会被直接丢弃; 投递返回之前事件循环不能析构
+     *          (任务的执行可能导致事件循环随即析构时, 使用 postGuarded)
+     * @tparam Func 形如 void()
+     * @param func
+     */
+    template <typename Func>
+        requires(std::is_invocable_v<Func>)
+    void post(Func&& func) {
+        _post(new internal::PostTaskAny<std::decay_t<Func>>{
+            std::decay_t<Func>{std::forward<Func>(func)}});
+    }
+
+    /**
+     * @brief 登记一个不在本事件循环内完成的等待 (如等待其他线程的同步原语),
+     *        计数不为 0 时, 即便没有 IO 与定时器, run() 也不会退出, 而是阻塞直到被投递唤醒
+     * @note 正在投递的与已经投递还未执行的任务 (post / schedule) 不需要登记, 它们同样会阻止 run() 退出;
+     *       需要登记的是投递开始之前的等待
+     * @warning 只能在事件循环的线程上调用, 并且需要与 release() 配对
+     */
+    void retain() noexcept {
+        ++_retainNum;
+    }
+
+    /**
+     * @brief 撤销 retain() 的登记
+     */
+    void release() noexcept {
+        --_retainNum;
+    }
+
+    /**
+     * @brief 投递一个任务节点, 由该事件循环的线程执行它的 run() (线程安全)
+     * @note 不需要额外的内存分配, 节点由调用者持有, 在 run() 或 destroy() 之前必须保持有效
+     * @param task
+     */
+    void post(internal::PostTask* task) noexcept {
+        _post(task);
+    }
+
+    /**
+     * @brief 同 post(task), 并且保证本次调用返回之前事件循环不会析构 (析构时会等待投递方离开)
+     * @note 用于任务的执行可能导致事件循环随即析构的场景, 如从其他线程唤醒 sync() 中等待的协程;
+     *       比 post 多两次原子操作, 在本事件循环的线程上调用时没有额外开销
+     * @param task
+     */
+    void postGuarded(internal::PostTask* task) noexcept {
+        if (_running == this) {
+            _post(task);
+            return;
+        }
+        _postingNum.fetch_add(1, std::memory_order_relaxed);
+        _post(task);
+        _postingNum.fetch_sub(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief 投递一个协程, 由该事件循环的线程恢复 (线程安全)
+     * @param handle
+     */
+    void post(std::coroutine_handle<> handle) {
+        post([handle] {
+            handle.resume();
+        });
+    }
+
+    /**
+     * @brief 切换到该事件循环: `co_await loop.schedule();` 之后, 协程在该事件循环的线程上继续执行
+     * @note 不需要额外的内存分配 (任务节点就在 awaiter 内部)
+     * @return auto
+     */
+    auto schedule() noexcept {
+        struct [[nodiscard]] ScheduleAwaiter : internal::PostTask {
+            ScheduleAwaiter(EventLoop& loop) noexcept
+                : _loop{loop}
+                , _handle{}
+            {}
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) noexcept {
+                _handle = handle;
+                _loop._post(this);
+            }
+
+            void await_resume() const noexcept {}
+
+            void run() override {
+                _handle.resume();
+            }
+
+            void destroy() noexcept override {}
+        private:
+            EventLoop& _loop;
+            std::coroutine_handle<> _handle;
+        };
+        return ScheduleAwaiter{*this};
+    }
+
+    /**
+     * @brief 在事件循环的线程上响应停止请求, 由 onStop 创建
+     * @note 请求停止可以发生在任意线程, func 总是被投递到事件循环上执行;
+     *       如果执行前本对象已经析构, 则不会再执行 (因此 func 可以安全地引用协程帧中的对象)
+     * @warning 只能在事件循环的线程上析构
+     * @tparam Func 形如 void()
+     */
+    template <typename Func>
+    class [[nodiscard]] StopCallback {
+        struct State {
+            State(Func func)
+                : _func{std::move(func)}
+                , _isAlive{true}
+            {}
+
+            Func _func;
+            bool _isAlive;
+        };
+
+        struct Poster {
+            EventLoop* _loop;
+            std::shared_ptr<State> _state;
+
+            void operator()() const {
+                _loop->post([state = _state] {
+                    if (state->_isAlive) {
+                        state->_func();
+                    }
+                });
+            }
+        };
+    public:
+        StopCallback(EventLoop& loop, std::stop_token const& token, Func func)
+            : _state{std::make_shared<State>(std::move(func))}
+            , _callback{token, Poster{&loop, _state}}
+        {}
+
+        StopCallback& operator=(StopCallback&&) noexcept = delete;
+
+        ~StopCallback() noexcept {
+            _state->_isAlive = false;
+        }
+    private:
+        std::shared_ptr<State> _state;
+        std::stop_callback<Poster> _callback;
+    };
+
+    /**
+     * @brief 注册停止回调: token 被请求停止时, 在该事件循环的线程上执行 func
+     * @tparam Func 形如 void()
+     * @param token
+     * @param func
+     * @return StopCallback<Func> 析构时注销
+     */
+    template <typename Func>
+        requires(std::is_invocable_v<Func&>)
+    StopCallback<std::decay_t<Func>> onStop(std::stop_token const& token, Func&& func) {
+        return {*this, token, std::forward<Func>(func)};
+    }
+
+#if defined(__linux__)
+    /**
+     * @brief 可取消地等待异步IO: token 被请求停止时, 通过 io_uring_prep_cancel 取消它
+     * @note 取消是异步的: 如果操作已经完成, 仍然得到原本的结果
+     * @param task 形如 `loop.makeAioTask().prepRecv(...)`
+     * @param token
+     * @return Task<int> 同 co_await task; 被取消时为 -ECANCELED
+     */
+    Task<int> cancelable(AioTask&& task, std::stop_token token) {
+        auto userData = std::move(task).cancelable().userData();
+        auto _ = onStop(token, [this, userData] {
+            // 此时 task 一定仍在等待 (协程帧还活着), 故 userData 不会指向别的任务
+            _eventDrive.makeAioTask().prepCancel(userData, 0).detach();
+        });
+        co_return co_await task;
+    }
+#endif
+
+    /**
+     * @brief 可取消地等待定时器: token 被请求停止时, 立即恢复
+     * @param timer 形如 `loop.makeTimer().sleepFor(1s)`
+     * @param token
+     * @return Task<int> 到期为 0; 被取消时为 -ECANCELED
+     */
+    Task<int> cancelable(TimerLoop::TimerAwaiter&& timer, std::stop_token token) {
+        bool isCanceled = false;
+        auto _ = onStop(token, [&] {
+            isCanceled = true;
+            timer.cancelAndResume();
+        });
+        co_await timer;
+        co_return isCanceled ? -ECANCELED : 0;
+    }
+
     /**
      * @brief 创建协程定时器
      * @return auto 
@@ -421,6 +1101,25 @@ struct EventLoop {
         return _eventDrive.makeAioTask();
     }
 
+#if defined(__linux__)
+    /**
+     * @brief 创建多发(multishot)异步IO协程任务, 一个 sqe 可以多次 co_await
+     * @return MultishotAioTask
+     */
+    MultishotAioTask makeMultishotAioTask() {
+        return _eventDrive.makeMultishotAioTask();
+    }
+#endif
+
+    /**
+     * @brief 获取事件循环的指标 (线程安全, 可以在其他线程上读取)
+     * @note 关闭 HX_LOOP_METRICS (CMake 选项) 则不统计, 计数全部为 0
+     * @return LoopMetricsSnapshot
+     */
+    LoopMetricsSnapshot metrics() noexcept {
+        return _eventDrive.metrics().snapshot();
+    }
+
     /**
      * @brief 获取事件循环的底层引擎
      * @return auto& 
@@ -429,8 +1128,92 @@ struct EventLoop {
         return _eventDrive;
     }
 private:
+    inline static constexpr std::size_t kMaxPostBatch = 1024; // 单次最多执行的投递任务数, 避免饿死 IO
+
+    inline static thread_local EventLoop* _current = nullptr;
+
+    // 本线程正在 run() / runOnce() 中执行的事件循环, 它此时必然不在内核中阻塞
+    inline static thread_local EventLoop* _running = nullptr;
+
+    struct RunningGuard {
+        EventLoop* _prev;
+
+        explicit RunningGuard(EventLoop* loop) noexcept
+            : _prev{std::exchange(_running, loop)}
+        {}
+
+        RunningGuard& operator=(RunningGuard&&) noexcept = delete;
+
+        ~RunningGuard() noexcept {
+            _running = _prev;
+        }
+    };
+
+    void _post(internal::PostTask* task) noexcept {
+        _postQueue.push(task);
+        // 只有从 false -> true 的那个生产者需要唤醒, 其余的由同一次唤醒一并处理;
+        // 事件循环自己的线程投递时不需要唤醒, 它在阻塞前会检查标记
+        if (!_isPostPending.exchange(true, std::memory_order_seq_cst) && _running != this) {
+            _eventDrive.wakeup();
+        }
+    }
+
+    /**
+     * @brief 是否有正在投递, 或者已经投递还未执行的任务; 它们相当于 retain(), run() 不能在执行它们之前退出
+     * @note 只在 run() 没有其他事情可做 (将要退出) 时检查, 投递本身不增加额外的原子操作.
+     *       队列非空而标记为 false 时, 投递方还没有置标记, 它之后一定会唤醒, 阻塞等待不会错过
+     */
+    bool _hasIncomingPost() const noexcept {
+        return _isPostPending.load(std::memory_order_acquire) || !_postQueue.empty();
+    }
+
+    /**
+     * @brief 执行投递的任务
+     * @return true 还有未执行的任务 (本批次达到上限)
+     */
+    bool _runPosted() {
+        if (!_isPostPending.load(std::memory_order_acquire)) [[likely]] {
+            return false;
+        }
+        // 先清标记再取: 之后入队的生产者看到 false, 会负责再次唤醒
+        _isPostPending.store(false, std::memory_order_seq_cst);
+        auto begin = LoopMetrics::now();
+        std::size_t i = 0;
+        for (; i < kMaxPostBatch; ++i) {
+            auto* task = _postQueue.pop();
+            if (!task) {
+                _eventDrive.metrics().onPost(begin, i);
+                return false;
+            }
+            static_cast<internal::PostTask*>(task)->run();
+        }
+        _eventDrive.metrics().onPost(begin, i);
+        _isPostPending.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief 唤醒到期的定时器
+     * @return std::optional<TimerLoop::Clock::duration> 同 TimerLoop::run()
+     */
+    std::optional<TimerLoop::Clock::duration> _runTimer() {
+        if constexpr (kEnableLoopMetrics) {
+            auto begin = LoopMetrics::now();
+            auto firedNum = _timerLoop.firedNum();
+            auto timeout = _timerLoop.run();
+            _eventDrive.metrics().onTimer(begin, _timerLoop.firedNum() - firedNum);
+            return timeout;
+        } else {
+            return _timerLoop.run();
+        }
+    }
+
     internal::EventDrive _eventDrive;
     TimerLoop _timerLoop;
+    container::MpscQueue _postQueue;
+    std::atomic_bool _isPostPending; // 是否有待执行的投递任务 (同时表示已经发出过唤醒)
+    std::atomic_size_t _postingNum; // 正在 postGuarded() 中的投递方数
+    std::size_t _retainNum;         // retain() 的计数
 };
 
 } // namespace HX::coroutine
@@ -0,0 +1,153 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 14:02:31
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <span>
+#include <vector>
+#include <cstdlib>
+#include <memory>
+#include <system_error>
+
+#include <HXLibs/platform/EventLoopApi.hpp>
+
+#if defined(__linux__)
+
+namespace HX::coroutine {
+
+/**
+ * @brief 对齐的内存 (如用于 O_DIRECT)
+ */
+struct AlignedFree {
+    void operator()(char* ptr) const noexcept {
+        std::free(ptr);
+    }
+};
+
+using AlignedBufPtr = std::unique_ptr<char[], AlignedFree>;
+
+/**
+ * @brief 分配对齐的内存
+ * @param align 对齐, 2 的幂
+ * @param size 大小, 需要是 align 的倍数
+ * @return AlignedBufPtr
+ * @throw 分配失败时抛出 std::bad_alloc
+ */
+inline AlignedBufPtr makeAlignedBuf(std::size_t align, std::size_t size) {
+    auto* ptr = static_cast<char*>(std::aligned_alloc(align, size));
+    if (!ptr) [[unlikely]] {
+        throw std::bad_alloc{};
+    }
+    return AlignedBufPtr{ptr};
+}
+
+/**
+ * @brief io_uring 的注册缓冲区池 (registered buffers, 用于 READ_FIXED / WRITE_FIXED)
+ * @note 缓冲区在注册时就被内核固定 (pin) 并映射, 之后的读写不需要每次再去固定用户页;
+ *       缓冲区按 kAlign 对齐, 可以直接用于 O_DIRECT. 同时只能被一个文件使用, 因此需要借出与归还
+ * @warning 注册的内存计入 RLIMIT_MEMLOCK
+ */
+class FixedBufPool {
+public:
+    inline static constexpr std::size_t kAlign = 4096; // 满足常见设备的逻辑块大小
+
+    /**
+     * @brief 分配并注册缓冲区
+     * @param ring io_uring
+     * @param num 缓冲区个数
+     * @param bufSize 每个缓冲区的大小, 需要是 kAlign 的倍数
+     * @throw 如果内核不支持 (或超出 RLIMIT_MEMLOCK), 则抛出 std::system_error
+     */
+    FixedBufPool(
+        ::io_uring& ring,
+        unsigned int num,
+        std::size_t bufSize
+    )
+        : _ring{ring}
+        , _bufs{makeAlignedBuf(kAlign, num * bufSize)}
+        , _freeIdx{}
+        , _bufSize{bufSize}
+    {
+        std::vector<::iovec> iovs(num);
+        for (unsigned int i = 0; i < num; ++i) {
+            iovs[i].iov_base = _bufs.get() + i * _bufSize;
+            iovs[i].iov_len = _bufSize;
+        }
+        if (int res = ::io_uring_register_buffers(&_ring, iovs.data(), num); res < 0) [[unlikely]] {
+            throw std::system_error(-res, std::system_category());
+        }
+        _freeIdx.reserve(num);
+        for (unsigned int i = num; i; --i) {
+            _freeIdx.push_back(static_cast<int>(i - 1));
+        }
+    }
+
+    FixedBufPool& operator=(FixedBufPool&&) noexcept = delete;
+
+    ~FixedBufPool() noexcept {
+        ::io_uring_unregister_buffers(&_ring);
+    }
+
+    /**
+     * @brief 获取每个缓冲区的大小
+     * @return std::size_t
+     */
+    std::size_t bufSize() const noexcept {
+        return _bufSize;
+    }
+
+    /**
+     * @brief 借出一个缓冲区
+     * @return int 缓冲区下标 (即 buf_index), 没有空闲的时为 -1
+     */
+    int acquire() noexcept {
+        if (_freeIdx.empty()) [[unlikely]] {
+            return -1;
+        }
+        int idx = _freeIdx.back();
+        _freeIdx.pop_back();
+        return idx;
+    }
+
+    /**
+     * @brief 归还缓冲区
+     * @param idx
+     */
+    void release(int idx) noexcept {
+        _freeIdx.push_back(idx);
+    }
+
+    /**
+     * @brief 获取缓冲区
+     * @param idx 缓冲区下标
+     * @return std::span<char>
+     */
+    std::span<char> getBuf(int idx) noexcept {
+        return {_bufs.get() + static_cast<std::size_t>(idx) * _bufSize, _bufSize};
+    }
+
+private:
+    ::io_uring& _ring;
+    AlignedBufPtr _bufs;
+    std::vector<int> _freeIdx;
+    std::size_t _bufSize;
+};
+
+} // namespace HX::coroutine
+
+#endif // !defined(__linux__)
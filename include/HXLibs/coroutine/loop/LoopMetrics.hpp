@@ -0,0 +1,206 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 10:12:36
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// 事件循环指标的编译期开关, 定义为 0 时所有统计都是空操作 (不读时钟).
+// 通过 CMake 的 HX_LOOP_METRICS 选项统一设置; 计数器总是存在, 因此各个翻译单元的类布局一致
+#ifndef HX_LOOP_METRICS
+    #define HX_LOOP_METRICS 1
+#endif
+
+namespace HX::coroutine {
+
+inline constexpr bool kEnableLoopMetrics = HX_LOOP_METRICS;
+
+/**
+ * @brief 事件循环指标的快照 (可以跨线程读取, 可以累加以聚合多个事件循环)
+ * @note 计数类都是自事件循环创建以来的累计值; 时间单位都是纳秒
+ */
+struct LoopMetricsSnapshot {
+    uint64_t loopNum;       // 聚合的事件循环数
+    uint64_t waitNum;       // 进入内核等待的次数 (即迭代次数)
+    uint64_t submitNum;     // 提交给内核的 sqe 数 (Windows 下为 0)
+    uint64_t cqeNum;        // 收割的完成事件数
+    uint64_t sqFullNum;     // 获取 sqe 时提交队列已满, 被迫阻塞等待内核的次数
+    uint64_t resumeNum;     // 因 IO 完成而恢复的协程数
+    uint64_t timerNum;      // 到期的定时器数
+    uint64_t postNum;       // 执行的投递任务数
+    uint64_t waitNs;        // 阻塞在内核中的时间
+    uint64_t resumeNs;      // 恢复协程的时间 (IO 完成、定时器、投递任务)
+    uint64_t pendingIoNum;  // 当前未完成的 IO 数 (瞬时值, 在每次迭代时更新)
+
+    LoopMetricsSnapshot& operator+=(LoopMetricsSnapshot const& that) noexcept {
+        loopNum += that.loopNum;
+        waitNum += that.waitNum;
+        submitNum += that.submitNum;
+        cqeNum += that.cqeNum;
+        sqFullNum += that.sqFullNum;
+        resumeNum += that.resumeNum;
+        timerNum += that.timerNum;
+        postNum += that.postNum;
+        waitNs += that.waitNs;
+        resumeNs += that.resumeNs;
+        pendingIoNum += that.pendingIoNum;
+        return *this;
+    }
+};
+
+/**
+ * @brief 单个事件循环的指标
+ * @note 只由事件循环的线程写入 (relaxed 的读-改-写, 无锁前缀), 任意线程都可以通过 snapshot() 读取
+ * @note 关闭 HX_LOOP_METRICS 时只去掉更新, 成员保持不变 (snapshot() 中的计数全部为 0)
+ */
+class LoopMetrics {
+    class Counter {
+    public:
+        void add(uint64_t n) noexcept {
+            _val.store(_val.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        void set(uint64_t n) noexcept {
+            _val.store(n, std::memory_order_relaxed);
+        }
+
+        uint64_t get() const noexcept {
+            return _val.load(std::memory_order_relaxed);
+        }
+    private:
+        std::atomic_uint64_t _val{0};
+    };
+public:
+    using Tick = std::chrono::steady_clock::time_point;
+
+    /**
+     * @brief 获取当前时间, 用作 onWait / onResume 等的起点
+     * @return Tick
+     */
+    static Tick now() noexcept {
+        if constexpr (kEnableLoopMetrics) {
+            return std::chrono::steady_clock::now();
+        } else {
+            return {};
+        }
+    }
+
+    /**
+     * @brief 从内核等待返回
+     * @param begin 进入等待前的时间
+     * @param submitNum 本次提交的 sqe 数
+     */
+    void onWait(Tick begin, uint64_t submitNum) noexcept {
+        if constexpr (kEnableLoopMetrics) {
+            _waitNs.add(_elapsedNs(begin));
+            _waitNum.add(1);
+            _submitNum.add(submitNum);
+        }
+    }
+
+    /**
+     * @brief 提交队列已满, 被迫阻塞提交
+     */
+    void onSqFull() noexcept {
+        if constexpr (kEnableLoopMetrics) {
+            _sqFullNum.add(1);
+        }
+    }
+
+    /**
+     * @brief 恢复了因 IO 完成的协程
+     * @param begin 开始恢复前的时间
+     * @param cqeNum 收割的完成事件数
+     * @param resumeNum 恢复的协程数
+     * @param pendingIoNum 剩余未完成的 IO 数
+     */
+    void onResume(Tick begin, uint64_t cqeNum, uint64_t resumeNum, uint64_t pendingIoNum) noexcept {
+        if constexpr (kEnableLoopMetrics) {
+            _resumeNs.add(_elapsedNs(begin));
+            _cqeNum.add(cqeNum);
+            _resumeNum.add(resumeNum);
+            _pendingIoNum.set(pendingIoNum);
+        }
+    }
+
+    /**
+     * @brief 唤醒了到期的定时器
+     * @param begin 开始唤醒前的时间
+     * @param timerNum 到期的定时器数
+     */
+    void onTimer(Tick begin, uint64_t timerNum) noexcept {
+        if constexpr (kEnableLoopMetrics) {
+            if (timerNum) {
+                _resumeNs.add(_elapsedNs(begin));
+                _timerNum.add(timerNum);
+            }
+        }
+    }
+
+    /**
+     * @brief 执行了投递的任务
+     * @param begin 开始执行前的时间
+     * @param postNum 执行的任务数
+     */
+    void onPost(Tick begin, uint64_t postNum) noexcept {
+        if constexpr (kEnableLoopMetrics) {
+            _resumeNs.add(_elapsedNs(begin));
+            _postNum.add(postNum);
+        }
+    }
+
+    /**
+     * @brief 读取指标 (线程安全)
+     * @return LoopMetricsSnapshot
+     */
+    LoopMetricsSnapshot snapshot() const noexcept {
+        return {
+            1,
+            _waitNum.get(),
+            _submitNum.get(),
+            _cqeNum.get(),
+            _sqFullNum.get(),
+            _resumeNum.get(),
+            _timerNum.get(),
+            _postNum.get(),
+            _waitNs.get(),
+            _resumeNs.get(),
+            _pendingIoNum.get(),
+        };
+    }
+private:
+    static uint64_t _elapsedNs(Tick begin) noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now() - begin).count());
+    }
+
+    Counter _waitNum;
+    Counter _submitNum;
+    Counter _cqeNum;
+    Counter _sqFullNum;
+    Counter _resumeNum;
+    Counter _timerNum;
+    Counter _postNum;
+    Counter _waitNs;
+    Counter _resumeNs;
+    Counter _pendingIoNum;
+};
+
+} // namespace HX::coroutine
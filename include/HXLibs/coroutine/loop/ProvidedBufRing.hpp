@@ -0,0 +1,131 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-16 10:21:07
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <span>
+#include <memory>
+#include <system_error>
+
+#include <HXLibs/platform/EventLoopApi.hpp>
+
+#if defined(__linux__)
+
+namespace HX::coroutine {
+
+/**
+ * @brief io_uring 的 provided buffer ring (内核提供的缓冲区环)
+ * @note 在 recv 时不指定缓冲区, 而是由内核在数据到达时从环中挑选一个;
+ *       因此空闲的连接不需要持有任何接收缓冲区. 用完后需要 recycle 归还到环中.
+ * @warning 需要 Linux 5.19+
+ */
+class ProvidedBufRing {
+public:
+    /**
+     * @brief 注册一个 provided buffer ring
+     * @param ring io_uring
+     * @param bgid 缓冲区组 id
+     * @param entries 缓冲区个数, 必须为 2 的幂
+     * @param bufSize 每个缓冲区的大小
+     * @throw 如果内核不支持, 则抛出 std::system_error
+     */
+    ProvidedBufRing(
+        ::io_uring& ring,
+        unsigned short bgid,
+        unsigned int entries,
+        std::size_t bufSize
+    )
+        : _ring{ring}
+        , _br{nullptr}
+        , _bufs{std::make_unique_for_overwrite<char[]>(entries * bufSize)}
+        , _bufSize{bufSize}
+        , _entries{entries}
+        , _mask{::io_uring_buf_ring_mask(entries)}
+        , _bgid{bgid}
+    {
+        int res = 0;
+        _br = ::io_uring_setup_buf_ring(&_ring, _entries, _bgid, 0, &res);
+        if (!_br) [[unlikely]] {
+            throw std::system_error(-res, std::system_category());
+        }
+        for (unsigned short bid = 0; bid < _entries; ++bid) {
+            _add(bid);
+        }
+        ::io_uring_buf_ring_advance(_br, static_cast<int>(_entries));
+    }
+
+    ProvidedBufRing& operator=(ProvidedBufRing&&) noexcept = delete;
+
+    ~ProvidedBufRing() noexcept {
+        ::io_uring_free_buf_ring(&_ring, _br, _entries, _bgid);
+    }
+
+    /**
+     * @brief 获取缓冲区组 id, 用于 `AioTask::prepRecvBufSelect`
+     * @return unsigned short
+     */
+    unsigned short bgid() const noexcept {
+        return _bgid;
+    }
+
+    /**
+     * @brief 获取每个缓冲区的大小
+     * @return std::size_t
+     */
+    std::size_t bufSize() const noexcept {
+        return _bufSize;
+    }
+
+    /**
+     * @brief 获取缓冲区
+     * @param bid 缓冲区 id (来自 cqe->flags >> IORING_CQE_BUFFER_SHIFT)
+     * @return std::span<char>
+     */
+    std::span<char> getBuf(unsigned short bid) noexcept {
+        return {_bufs.get() + bid * _bufSize, _bufSize};
+    }
+
+    /**
+     * @brief 把缓冲区归还到环中, 以供内核再次挑选
+     * @param bid 缓冲区 id
+     */
+    void recycle(unsigned short bid) noexcept {
+        _add(bid);
+        ::io_uring_buf_ring_advance(_br, 1);
+    }
+
+private:
+    void _add(unsigned short bid) noexcept {
+        ::io_uring_buf_ring_add(
+            _br, _bufs.get() + bid * _bufSize, static_cast<unsigned int>(_bufSize),
+            bid, _mask, 0
+        );
+    }
+
+    ::io_uring& _ring;
+    ::io_uring_buf_ring* _br;
+    std::unique_ptr<char[]> _bufs;
+    std::size_t _bufSize;
+    unsigned int _entries;
+    int _mask;
+    unsigned short _bgid;
+};
+
+} // namespace HX::coroutine
+
+#endif // !defined(__linux__)
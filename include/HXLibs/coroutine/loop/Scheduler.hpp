@@ -0,0 +1,331 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-16 15:37:12
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <deque>
+#include <mutex>
+#include <latch>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <optional>
+#include <coroutine>
+#include <stdexcept>
+
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+#include <HXLibs/coroutine/task/RootTask.hpp>
+#include <HXLibs/coroutine/concepts/Awaiter.hpp>
+
+namespace HX::coroutine {
+
+/**
+ * @brief 多事件循环的 M:N 协程调度器 (带工作窃取)
+ * @note 每个线程一个 EventLoop 与一个就绪队列; 空闲的线程会从最忙的线程的就绪队列中窃取一半.
+ *       只会窃取 "就绪" 的协程 (spawn / yield / migrate 放入队列的), 正在等待 IO 的协程不会被移动.
+ * @note 它不接管 HttpServer: 连接的 IO (fd、固定文件槽、缓冲区环) 绑定在接受它的事件循环上,
+ *       连接之间的负载仍由 SO_REUSEPORT 分配, 本调度器只均衡通过 spawn / yield / migrate 交给它的协程.
+ * @warning 协程在 yield() / migrate() 之后可能运行在另一个线程上, 因此不能跨越它们持有
+ *          与事件循环绑定的资源 (如 net::IO、定时器); 之后应通过 currentLoop() 获取当前的事件循环.
+ */
+class Scheduler {
+    struct Worker {
+        std::optional<EventLoop> _loop{};  // 在工作线程内创建, 但是随调度器析构, 以便停止时仍可唤醒
+        std::mutex _mtx{};
+        std::deque<std::coroutine_handle<>> _readyQueue{};
+        std::atomic_size_t _readySize{0};   // 无锁读取的队列长度, 用于负载估计
+        std::atomic_bool _isIdle{false};    // 是否 (即将) 阻塞在内核中
+    };
+
+    struct [[nodiscard]] PushAwaiter {
+        Scheduler& _scheduler;
+        bool _isMigrate;
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            Worker* self = _current && _current->_scheduler == &_scheduler
+                ? _current->_worker
+                : nullptr;
+            Worker* target = self;
+            if (_isMigrate || !self) {
+                target = &_scheduler._leastLoaded(self);
+            }
+            return _scheduler._push(*target, handle);
+        }
+
+        void await_resume() const {
+            if (_scheduler._isStop.load(std::memory_order_acquire)) [[unlikely]] {
+                throw std::runtime_error{"Scheduler is stopped"};
+            }
+        }
+    };
+public:
+    /**
+     * @brief 创建调度器, 并启动工作线程
+     * @param threadNum 线程数 (至少为 1)
+     * @param config 每个线程的事件循环的配置
+     * @param isSteal 空闲的线程是否窃取其他线程的就绪协程 (关闭后每个线程只运行自己队列中的, 用于对比)
+     */
+    explicit Scheduler(
+        std::size_t threadNum = std::thread::hardware_concurrency(),
+        EventLoopConfig const& config = {},
+        bool isSteal = true
+    )
+        : _workers{}
+        , _isSteal{isSteal}
+        , _isStop{false}
+        , _threads{}
+    {
+        threadNum = threadNum ? threadNum : 1;
+        _workers.reserve(threadNum);
+        for (std::size_t i = 0; i < threadNum; ++i) {
+            _workers.push_back(std::make_unique<Worker>());
+        }
+        std::latch ready{static_cast<std::ptrdiff_t>(threadNum)};
+        _threads.reserve(threadNum);
+        for (std::size_t i = 0; i < threadNum; ++i) {
+            _threads.emplace_back([this, &ready, &config, &worker = *_workers[i]] {
+                // 在本线程内创建事件循环, 以满足 RingProfile::SingleIssuer 的要求
+                worker._loop.emplace(config);
+                ready.count_down();
+                _workerRun(worker);
+            });
+        }
+        ready.wait();
+    }
+
+    Scheduler& operator=(Scheduler&&) noexcept = delete;
+
+    /**
+     * @brief 停止调度器, 并等待所有线程退出
+     * @note 线程退出后, 在调用线程上清空就绪队列: 还没开始的 spawn 协程直接结束;
+     *       停在 yield() / migrate() 的协程被恢复, 并从中抛出 std::runtime_error, 由异常展开释放协程帧.
+     *       停止之后的 yield() / migrate() 同样直接抛出, 停止之后 spawn 的协程不会运行
+     * @warning 仍在等待 IO / 定时器的协程不会再被恢复
+     */
+    void stop() {
+        if (_threads.empty()) {
+            return;
+        }
+        _isStop.store(true, std::memory_order_seq_cst);
+        for (auto& worker : _workers) {
+            worker->_loop->wakeup();
+        }
+        _threads.clear();
+        for (auto& worker : _workers) {
+            while (auto handle = _pop(*worker)) {
+                handle.resume();
+            }
+        }
+    }
+
+    ~Scheduler() noexcept {
+        stop();
+    }
+
+    /**
+     * @brief 把协程交给调度器运行 (放入最空闲的线程的就绪队列)
+     * @note 协程抛出的异常会被忽略, 请在协程内部处理
+     * @tparam T
+     * @param task
+     */
+    template <CoroutineObject T>
+    void spawn(T&& task) {
+        auto root = [](Scheduler& self, std::remove_cvref_t<T> t) -> RootTask<> {
+            if (self._isStop.load(std::memory_order_acquire)) [[unlikely]] {
+                co_return; // 停止时还没开始的, 不再运行
+            }
+            co_await t;
+        }(*this, std::forward<T>(task));
+        if (!_push(_leastLoaded(nullptr), root)) [[unlikely]] {
+            static_cast<std::coroutine_handle<>>(root).resume();
+        }
+    }
+
+    /**
+     * @brief 让出当前线程: 协程放回本线程的就绪队列尾部, 期间可能被其他空闲线程窃取
+     * @return PushAwaiter
+     */
+    PushAwaiter yield() noexcept {
+        return {*this, false};
+    }
+
+    /**
+     * @brief 迁移到最空闲的其他线程上继续执行
+     * @return PushAwaiter
+     */
+    PushAwaiter migrate() noexcept {
+        return {*this, true};
+    }
+
+    /**
+     * @brief 获取当前线程的事件循环
+     * @throw 如果当前线程不是调度器的工作线程, 则抛出 std::runtime_error
+     * @return EventLoop&
+     */
+    static EventLoop& currentLoop() {
+        if (!_current) [[unlikely]] {
+            throw std::runtime_error{"Not in a scheduler thread"};
+        }
+        return *_current->_worker->_loop;
+    }
+
+    std::size_t threadNum() const noexcept {
+        return _workers.size();
+    }
+
+private:
+    inline static constexpr std::size_t kMaxReadyBatch = 64; // 每轮最多恢复的就绪协程数, 避免饿死 IO
+
+    struct Current {
+        Scheduler* _scheduler;
+        Worker* _worker;
+    };
+
+    inline static thread_local Current* _current = nullptr;
+
+    Worker& _leastLoaded(Worker* except) noexcept {
+        Worker* res = nullptr;
+        std::size_t minSize = static_cast<std::size_t>(-1);
+        for (auto& worker : _workers) {
+            if (worker.get() == except && _workers.size() > 1) {
+                continue;
+            }
+            auto size = worker->_readySize.load(std::memory_order_relaxed);
+            if (size < minSize) {
+                minSize = size;
+                res = worker.get();
+            }
+        }
+        return *res;
+    }
+
+    /**
+     * @brief 放入就绪队列
+     * @return false 调度器已经停止, 没有放入 (由调用方恢复协程)
+     */
+    bool _push(Worker& worker, std::coroutine_handle<> handle) {
+        std::size_t size;
+        {
+            std::lock_guard _{worker._mtx};
+            // 在锁内检查: stop() 先置标记再加锁清空队列, 因此放入的协程一定会被它看到
+            if (_isStop.load(std::memory_order_seq_cst)) [[unlikely]] {
+                return false;
+            }
+            worker._readyQueue.push_back(handle);
+            size = worker._readySize.fetch_add(1, std::memory_order_seq_cst) + 1;
+        }
+        if (worker._isIdle.load(std::memory_order_seq_cst)) {
+            worker._loop->wakeup();
+        } else if (_isSteal && size > 1) {
+            // 有富余, 叫醒一个空闲的线程来窃取
+            for (auto& other : _workers) {
+                if (other.get() != &worker
+                    && other->_isIdle.load(std::memory_order_seq_cst)
+                ) {
+                    other->_loop->wakeup();
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::coroutine_handle<> _pop(Worker& worker) {
+        std::lock_guard _{worker._mtx};
+        if (worker._readyQueue.empty()) {
+            return nullptr;
+        }
+        auto handle = worker._readyQueue.front();
+        worker._readyQueue.pop_front();
+        worker._readySize.fetch_sub(1, std::memory_order_relaxed);
+        return handle;
+    }
+
+    /**
+     * @brief 从最忙的线程的就绪队列尾部窃取一半
+     * @return true 窃取到了
+     */
+    bool _steal(Worker& thief) {
+        Worker* victim = nullptr;
+        std::size_t maxSize = 0;
+        for (auto& worker : _workers) {
+            auto size = worker->_readySize.load(std::memory_order_seq_cst);
+            if (worker.get() != &thief && size > maxSize) {
+                maxSize = size;
+                victim = worker.get();
+            }
+        }
+        if (!victim) {
+            return false;
+        }
+        std::vector<std::coroutine_handle<>> stolen;
+        {
+            std::lock_guard _{victim->_mtx};
+            auto n = (victim->_readyQueue.size() + 1) / 2;
+            stolen.assign(victim->_readyQueue.end() - static_cast<std::ptrdiff_t>(n),
+                          victim->_readyQueue.end());
+            victim->_readyQueue.resize(victim->_readyQueue.size() - n);
+            victim->_readySize.fetch_sub(n, std::memory_order_relaxed);
+        }
+        if (stolen.empty()) {
+            return false;
+        }
+        std::lock_guard _{thief._mtx};
+        thief._readyQueue.insert(thief._readyQueue.end(), stolen.begin(), stolen.end());
+        thief._readySize.fetch_add(stolen.size(), std::memory_order_seq_cst);
+        return true;
+    }
+
+    void _workerRun(Worker& worker) {
+        Current current{this, &worker};
+        _current = &current;
+        while (!_isStop.load(std::memory_order_acquire)) {
+            for (std::size_t i = 0; i < kMaxReadyBatch; ++i) {
+                auto handle = _pop(worker);
+                if (!handle) {
+                    break;
+                }
+                handle.resume();
+            }
+            if (worker._readySize.load(std::memory_order_relaxed)) {
+                worker._loop->runOnce(false);
+                continue;
+            }
+            // 先声明空闲, 再检查一次: 之后 push 的一方一定能看到空闲并唤醒我们
+            worker._isIdle.store(true, std::memory_order_seq_cst);
+            bool isBusy = (_isSteal && _steal(worker))
+                       || worker._readySize.load(std::memory_order_seq_cst)
+                       || _isStop.load(std::memory_order_seq_cst);
+            worker._loop->runOnce(!isBusy);
+            worker._isIdle.store(false, std::memory_order_relaxed);
+        }
+        _current = nullptr;
+    }
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    bool _isSteal;
+    std::atomic_bool _isStop;
+    std::vector<std::jthread> _threads; // 放在最后: 先于其他成员析构, 线程退出后才销毁它们
+};
+
+} // namespace HX::coroutine
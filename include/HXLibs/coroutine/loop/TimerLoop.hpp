@@ -18,80 +18,360 @@
  * limitations under the License.
  */
 
+#include <array>
+#include <bit>
 #include <chrono>
-#include <map>
+#include <cstdint>
+#include <optional>
 #include <coroutine>
 
 namespace HX::coroutine {
 
+namespace internal {
+
 /**
- * @brief 定时器循环
+ * @brief 侵入式双向循环链表的节点
+ */
+struct TimerListNode {
+    TimerListNode* _prev;
+    TimerListNode* _next;
+};
+
+} // namespace internal
+
+/**
+ * @brief 定时器循环 (分层时间轮, 基于 steady_clock, 精度 1ms)
+ * @note 4 层, 每层 256 个槽, 覆盖 2^32 ms (约 49.7 天), 更远的定时器会在最高层反复降级;
+ *       插入、取消都是 O(1) 且无内存分配 (节点就在 TimerAwaiter 内部).
  */
 struct TimerLoop {
-    using TimerTree = std::multimap<std::chrono::system_clock::time_point, std::coroutine_handle<>>;
+    using Clock = std::chrono::steady_clock;
+
+    TimerLoop()
+        : _slots{}
+        , _bitmaps{}
+        , _readyList{}
+        , _curTick{_toTick(Clock::now())}
+        , _size{}
+        , _firedNum{}
+    {
+        for (auto& level : _slots) {
+            for (auto& head : level) {
+                _initHead(head);
+            }
+        }
+        _initHead(_readyList);
+    }
 
     TimerLoop& operator=(TimerLoop&&) = delete;
 
-    std::optional<std::chrono::system_clock::duration> run() {
-        while (_timerTree.size()) {
-            auto nowTime = std::chrono::system_clock::now();
-            auto it = _timerTree.begin();
-            if (it->first <= nowTime) {
-                it->second.resume();
-                _timerTree.erase(it);
-            } else {
-                return it->first - nowTime;
-            }
+    /**
+     * @brief 唤醒所有已经到期的定时器
+     * @return std::optional<Clock::duration> 距离下一个定时器到期的时间, 没有定时器则为空
+     */
+    std::optional<Clock::duration> run() {
+        return run(Clock::now());
+    }
+
+    /**
+     * @brief 以 nowTime 作为当前时间, 唤醒所有已经到期的定时器
+     * @note 时间只能向前推进; 主要用于测试 (不必真的等待很久)
+     * @param nowTime 当前时间
+     * @return std::optional<Clock::duration> 距离下一个定时器到期的时间, 没有定时器则为空
+     */
+    std::optional<Clock::duration> run(Clock::time_point nowTime) {
+        if (!_size) {
+            return {};
+        }
+        _advance(_toTick(nowTime));
+        while (_readyList._next != &_readyList) {
+            auto* node = static_cast<TimerNode*>(_readyList._next);
+            _unlink(node);
+            ++_firedNum;
+            node->_handle.resume();
         }
-        return {};
+        if (!_size) {
+            return {};
+        }
+        if (_readyList._next != &_readyList) { // 被唤醒的协程又添加了已经到期的定时器
+            return Clock::duration{};
+        }
+        auto next = Clock::time_point{std::chrono::milliseconds{_nextTick()}};
+        return next > nowTime ? next - nowTime : Clock::duration{};
     }
 
-    TimerTree::iterator addTimer(
-        std::chrono::system_clock::time_point expireTime,
-        std::coroutine_handle<> coroutine
-    ) {
-        return _timerTree.insert({expireTime, coroutine});
+    /**
+     * @brief 累计到期 (由 run() 唤醒) 的定时器数
+     * @return uint64_t
+     */
+    uint64_t firedNum() const noexcept {
+        return _firedNum;
     }
 
+    /**
+     * @brief 时间轮中的定时器节点
+     */
+    struct TimerNode : internal::TimerListNode {
+        std::coroutine_handle<> _handle;
+        uint64_t _expireTick;   // 到期的 tick (ms)
+        uint16_t _slotId;       // 所在的槽 (level * kSlotNum + idx), kReadySlotId 为就绪链表 (另见 _expireSlot)
+    };
+
     struct [[nodiscard]] TimerAwaiter {
         TimerAwaiter(TimerLoop* timerLoop)
             : _timerLoop{timerLoop}
             , _expireTime{}
-            , _it{}
+            , _node{}
         {}
 
         TimerAwaiter(TimerAwaiter const&) = delete;
         TimerAwaiter& operator=(TimerAwaiter const&) noexcept = delete;
 
-        TimerAwaiter(TimerAwaiter&&) = default;
-        TimerAwaiter& operator=(TimerAwaiter&&) noexcept = default;
+        TimerAwaiter(TimerAwaiter&& that) noexcept
+            : _timerLoop{that._timerLoop}
+            , _expireTime{that._expireTime}
+            , _node{}
+        {
+            _stealNode(that);
+        }
+
+        TimerAwaiter& operator=(TimerAwaiter&& that) noexcept {
+            if (this != &that) [[likely]] {
+                cancel();
+                _timerLoop = that._timerLoop;
+                _expireTime = that._expireTime;
+                _stealNode(that);
+            }
+            return *this;
+        }
 
         bool await_ready() const noexcept {
             return false;
         }
-        void await_suspend(std::coroutine_handle<> coroutine) const noexcept {
-            _it = _timerLoop->addTimer(_expireTime, coroutine);
+        void await_suspend(std::coroutine_handle<> coroutine) noexcept {
+            _node._handle = coroutine;
+            _timerLoop->_addTimer(_node, _expireTime);
         }
         void await_resume() const noexcept {
-            _it.reset(); // 如果继续, 说明是从 TimerTree::run() 来的
-                         // 之后外界会执行 _timerTree.erase(_it)
-                         // 因此内部要执行 _it = {}, 防止多次 erase
+            // 如果继续, 说明是从 TimerLoop::run() 来的, 节点已经被摘下
         }
-        TimerAwaiter&& setExpireTime(std::chrono::system_clock::time_point expireTime) && noexcept {
+        TimerAwaiter&& setExpireTime(Clock::time_point expireTime) && noexcept {
             _expireTime = expireTime;
             return std::move(*this);
         }
-        ~TimerAwaiter() noexcept {
-            if (_it) {
-                _timerLoop->_timerTree.erase(*_it);
+
+        /**
+         * @brief 取消定时器 (O(1)), 如果未在等待则什么也不做
+         */
+        void cancel() noexcept {
+            if (_node._prev) {
+                _timerLoop->_unlink(&_node);
             }
         }
+
+        /**
+         * @brief 取消定时器, 并立即恢复等待它的协程 (需要在事件循环的线程上调用)
+         * @return true 已恢复; false 定时器未在等待, 什么也不做
+         */
+        bool cancelAndResume() {
+            if (!_node._prev) {
+                return false;
+            }
+            _timerLoop->_unlink(&_node);
+            // 恢复后协程可能已经结束, 本对象随之析构, 因此恢复必须是最后一步
+            _node._handle.resume();
+            return true;
+        }
+
+        ~TimerAwaiter() noexcept {
+            cancel();
+        }
     private:
+        // 节点已经在链表中时, 需要让邻居指向新的地址
+        void _stealNode(TimerAwaiter& that) noexcept {
+            if (!that._node._prev) {
+                return;
+            }
+            _node = that._node;
+            _node._prev->_next = &_node;
+            _node._next->_prev = &_node;
+            that._node._prev = that._node._next = nullptr;
+        }
+
         TimerLoop* _timerLoop;
-        std::chrono::system_clock::time_point _expireTime;  // 过期时间
-        mutable std::optional<TimerTree::iterator> _it;     // 红黑树迭代器
+        Clock::time_point _expireTime;  // 过期时间
+        TimerNode _node;                // 侵入式节点
     };
 private:
+    inline static constexpr std::size_t kLevelNum = 4;
+    inline static constexpr std::size_t kSlotBits = 8;
+    inline static constexpr std::size_t kSlotNum = 1 << kSlotBits;
+    inline static constexpr uint64_t kSlotMask = kSlotNum - 1;
+    inline static constexpr uint64_t kMaxDelta = (uint64_t{1} << (kSlotBits * kLevelNum)) - 1;
+    inline static constexpr uint16_t kReadySlotId = kLevelNum * kSlotNum;
+
+    using Bitmap = std::array<uint64_t, kSlotNum / 64>;
+
+    static uint64_t _toTick(Clock::time_point t) noexcept {
+        return static_cast<uint64_t>(
+            std::chrono::floor<std::chrono::milliseconds>(t.time_since_epoch()).count());
+    }
+
+    static void _initHead(internal::TimerListNode& head) noexcept {
+        head._prev = head._next = &head;
+    }
+
+    static void _pushBack(internal::TimerListNode& head, internal::TimerListNode* node) noexcept {
+        node->_prev = head._prev;
+        node->_next = &head;
+        head._prev->_next = node;
+        head._prev = node;
+    }
+
+    /**
+     * @brief 从 idx 的下一个槽开始 (环形) 查找非空的槽
+     * @return uint64_t 距离 [1, kSlotNum], 0 表示该层为空
+     */
+    static uint64_t _nextDistance(Bitmap const& bits, uint64_t idx) noexcept {
+        for (uint64_t d = 1; d <= kSlotNum;) {
+            uint64_t i = (idx + d) & kSlotMask;
+            if (uint64_t w = bits[i >> 6] >> (i & 63)) {
+                d += static_cast<uint64_t>(std::countr_zero(w));
+                return d <= kSlotNum ? d : 0;
+            }
+            d += 64 - (i & 63);
+        }
+        return 0;
+    }
+
+    void _addTimer(TimerNode& node, Clock::time_point expireTime) noexcept {
+        if (!_size) {
+            // 时间轮为空, 可以直接对齐到当前时间, 以免 _advance 空转
+            _curTick = _toTick(Clock::now());
+        }
+        node._expireTick = static_cast<uint64_t>(
+            std::chrono::ceil<std::chrono::milliseconds>(expireTime.time_since_epoch()).count());
+        ++_size;
+        _place(&node);
+    }
+
+    /**
+     * @brief 把节点放入相对于 _curTick 合适的层与槽
+     */
+    void _place(TimerNode* node) noexcept {
+        if (node->_expireTick <= _curTick) {
+            node->_slotId = kReadySlotId;
+            _pushBack(_readyList, node);
+            return;
+        }
+        uint64_t delta = node->_expireTick - _curTick;
+        uint64_t tick = node->_expireTick;
+        if (delta > kMaxDelta) [[unlikely]] {
+            tick = _curTick + kMaxDelta; // 超出范围, 先放在最高层, 降级时重新计算
+            delta = kMaxDelta;
+        }
+        std::size_t level = 0;
+        while ((delta >> (kSlotBits * (level + 1))) && level + 1 < kLevelNum) {
+            ++level;
+        }
+        auto idx = static_cast<std::size_t>((tick >> (kSlotBits * level)) & kSlotMask);
+        node->_slotId = static_cast<uint16_t>(level * kSlotNum + idx);
+        _pushBack(_slots[level][idx], node);
+        _bitmaps[level][idx >> 6] |= uint64_t{1} << (idx & 63);
+    }
+
+    void _unlink(TimerNode* node) noexcept {
+        node->_prev->_next = node->_next;
+        node->_next->_prev = node->_prev;
+        node->_prev = node->_next = nullptr;
+        --_size;
+        if (node->_slotId != kReadySlotId) {
+            std::size_t level = node->_slotId / kSlotNum;
+            std::size_t idx = node->_slotId % kSlotNum;
+            if (_slots[level][idx]._next == &_slots[level][idx]) {
+                _bitmaps[level][idx >> 6] &= ~(uint64_t{1} << (idx & 63));
+            }
+        }
+    }
+
+    /**
+     * @brief 取出一个槽中的所有节点, 重新放置 (降级或者就绪)
+     */
+    void _cascade(std::size_t level, std::size_t idx) noexcept {
+        auto& head = _slots[level][idx];
+        if (head._next == &head) {
+            return;
+        }
+        internal::TimerListNode list;
+        list._next = head._next;
+        list._prev = head._prev;
+        list._next->_prev = &list;
+        list._prev->_next = &list;
+        _initHead(head);
+        _bitmaps[level][idx >> 6] &= ~(uint64_t{1} << (idx & 63));
+        while (list._next != &list) {
+            auto* node = static_cast<TimerNode*>(list._next);
+            list._next = node->_next;
+            _place(node);
+        }
+    }
+
+    /**
+     * @brief 下一个需要处理的 tick (最低层为精确的到期时间, 更高层为其降级的时间)
+     * @return uint64_t 0 表示时间轮为空
+     */
+    uint64_t _nextTick() const noexcept {
+        uint64_t res = 0;
+        for (std::size_t level = 0; level < kLevelNum; ++level) {
+            auto shift = kSlotBits * level;
+            if (auto d = _nextDistance(_bitmaps[level], (_curTick >> shift) & kSlotMask)) {
+                uint64_t tick = ((_curTick >> shift) + d) << shift;
+                if (!res || tick < res) {
+                    res = tick;
+                }
+            }
+        }
+        return res;
+    }
+
+    /**
+     * @brief 推进时间轮到 target, 途经的到期定时器会进入就绪链表
+     */
+    void _advance(uint64_t target) noexcept {
+        while (_curTick < target) {
+            uint64_t tick = _nextTick();
+            if (!tick || tick > target) {
+                _curTick = target;
+                return;
+            }
+            _curTick = tick;
+            // 自高向低降级, 这样降级到低层的节点可以被继续处理
+            for (std::size_t level = kLevelNum - 1; level; --level) {
+                if (!(tick & ((uint64_t{1} << (kSlotBits * level)) - 1))) {
+                    _cascade(level, (tick >> (kSlotBits * level)) & kSlotMask);
+                }
+            }
+            _expireSlot(tick & kSlotMask);
+        }
+    }
+
+    /**
+     * @brief 最低层的槽到期: 整个链表直接接到就绪链表的尾部 (O(1), 不逐个访问节点)
+     * @note 节点的 _slotId 仍然指向原来的槽; 这不影响 _unlink: 槽为空时清除位图总是正确的
+     */
+    void _expireSlot(std::size_t idx) noexcept {
+        auto& head = _slots[0][idx];
+        if (head._next == &head) {
+            return;
+        }
+        head._next->_prev = _readyList._prev;
+        _readyList._prev->_next = head._next;
+        head._prev->_next = &_readyList;
+        _readyList._prev = head._prev;
+        _initHead(head);
+        _bitmaps[0][idx >> 6] &= ~(uint64_t{1} << (idx & 63));
+    }
+
     struct [[nodiscard]] TimerAwaiterBuilder {
         TimerAwaiterBuilder(TimerLoop* timerLoop)
             : _timerLoop{timerLoop}
@@ -103,32 +383,44 @@ private:
          * @brief 暂停一段时间
          * @param duration 比如 3s
          */
-        TimerAwaiter sleepFor(std::chrono::system_clock::duration duration) && {
-            return TimerAwaiter{_timerLoop}.setExpireTime(
-                std::chrono::system_clock::now() + duration);
+        TimerAwaiter sleepFor(Clock::duration duration) && {
+            return TimerAwaiter{_timerLoop}.setExpireTime(Clock::now() + duration);
         }
         /**
          * @brief 暂停指定时间点
-         * @param timerLoop 计时器循环对象
+         * @param expireTime 时间点 (steady_clock)
+         */
+        TimerAwaiter sleepUntil(Clock::time_point expireTime) && {
+            return TimerAwaiter{_timerLoop}.setExpireTime(expireTime);
+        }
+        /**
+         * @brief 暂停指定时间点
+         * @note 会换算为 steady_clock 的时间点, 因此之后的系统时间跳变不会影响它
          * @param expireTime 时间点, 如 2024-8-4 22:12:23
          */
         TimerAwaiter sleepUntil(std::chrono::system_clock::time_point expireTime) && {
-            return TimerAwaiter{_timerLoop}.setExpireTime(expireTime);
+            return TimerAwaiter{_timerLoop}.setExpireTime(
+                Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                    expireTime - std::chrono::system_clock::now()));
         }
         TimerLoop* _timerLoop;
     };
 public:
     /**
      * @brief 创建一个定时器工厂, 需要用户指定定时的时间
-     * @param timerLoop 
-     * @return TimerAwaiterBuilder 
+     * @param timerLoop
+     * @return TimerAwaiterBuilder
      */
     static TimerAwaiterBuilder makeTimer(TimerLoop& timerLoop) {
         return {&timerLoop};
     }
 private:
-    TimerTree _timerTree;
+    std::array<std::array<internal::TimerListNode, kSlotNum>, kLevelNum> _slots;
+    std::array<Bitmap, kLevelNum> _bitmaps;     // 每层非空槽的位图, 用于快速查找下一个到期时间
+    internal::TimerListNode _readyList;         // 已经到期, 等待唤醒
+    uint64_t _curTick;                          // 时间轮当前所处的 tick (ms)
+    std::size_t _size;                          // 定时器个数 (含就绪)
+    uint64_t _firedNum;                         // 累计到期的定时器数
 };
 
 } // namespace HX::coroutine
-
@@ -0,0 +1,176 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-16 16:45:20
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <cstddef>
+#include <new>
+
+// 协程帧池的编译期开关, 定义为 0 时每个帧都直接使用全局 operator new / delete (计数仍然有效), 用于对比
+#ifndef HX_FRAME_POOL
+    #define HX_FRAME_POOL 1
+#endif
+
+namespace HX::coroutine {
+
+inline constexpr bool kEnableFramePool = HX_FRAME_POOL;
+
+/**
+ * @brief 协程帧分配计数 (线程局部)
+ */
+struct FrameAllocStats {
+    std::size_t allocNum;   // 分配次数
+    std::size_t freeNum;    // 释放次数
+    std::size_t reuseNum;   // 其中直接复用缓存的次数 (无 malloc)
+    std::size_t heapNum;    // 其中调用全局 operator new 的次数
+};
+
+/**
+ * @brief 协程帧分配器: 线程局部的按尺寸分级的空闲链表
+ * @note 事件循环是一线程一个的, 因此线程局部即为事件循环局部.
+ *       释放的帧进入 "释放者" 线程的空闲链表 (协程可能跨线程恢复), 因此不超过 kMaxSize 的帧
+ *       总是按所在级别的块大小分配, 无论它来自哪个线程都可以安全地放入任意线程的缓存.
+ *       每个线程缓存的总字节数有上限, 超出的直接归还全局堆.
+ */
+class FrameAllocator {
+public:
+    /**
+     * @brief 分配协程帧
+     * @param size
+     * @return void*
+     */
+    static void* allocate(std::size_t size) {
+        if (_isPoolDead) [[unlikely]] { // 线程退出时, 局部池已经析构了
+            // 仍需按级别取整: 该帧可能在其他线程释放, 并进入那个线程的缓存
+            return ::operator new(_blockSize(size));
+        }
+        auto& pool = _pool();
+        ++pool._stats.allocNum;
+        if (kEnableFramePool && size <= kMaxSize) [[likely]] {
+            auto cls = _sizeClass(size);
+            if (auto* node = pool._heads[cls]) [[likely]] {
+                pool._heads[cls] = node->_next;
+                pool._cachedBytes -= (cls + 1) * kGranularity;
+                ++pool._stats.reuseNum;
+                return node;
+            }
+        }
+        ++pool._stats.heapNum;
+        return ::operator new(_blockSize(size));
+    }
+
+    /**
+     * @brief 释放协程帧
+     * @param ptr
+     * @param size 与 allocate 时相同的大小
+     */
+    static void deallocate(void* ptr, std::size_t size) noexcept {
+        if (_isPoolDead) [[unlikely]] { // 线程退出时, 局部池已经析构了
+            ::operator delete(ptr);
+            return;
+        }
+        auto& pool = _pool();
+        ++pool._stats.freeNum;
+        if (kEnableFramePool && size <= kMaxSize) [[likely]] {
+            auto cls = _sizeClass(size);
+            auto blockSize = (cls + 1) * kGranularity;
+            if (pool._cachedBytes + blockSize <= kMaxCachedBytes) [[likely]] {
+                auto* node = static_cast<FreeNode*>(ptr);
+                node->_next = pool._heads[cls];
+                pool._heads[cls] = node;
+                pool._cachedBytes += blockSize;
+                return;
+            }
+        }
+        ::operator delete(ptr);
+    }
+
+    /**
+     * @brief 获取当前线程的分配计数
+     * @return FrameAllocStats const&
+     */
+    static FrameAllocStats const& stats() noexcept {
+        return _pool()._stats;
+    }
+
+private:
+    inline static constexpr std::size_t kGranularity = 64;
+    inline static constexpr std::size_t kMaxSize = 4096;        // 更大的帧不缓存
+    inline static constexpr std::size_t kClassNum = kMaxSize / kGranularity;
+    inline static constexpr std::size_t kMaxCachedBytes = 4 << 20; // 每个线程最多缓存的字节数
+
+    struct FreeNode {
+        FreeNode* _next;
+    };
+
+    struct Pool {
+        std::array<FreeNode*, kClassNum> _heads{};
+        std::size_t _cachedBytes{};
+        FrameAllocStats _stats{};
+
+        ~Pool() noexcept {
+            _isPoolDead = true;
+            for (auto* head : _heads) {
+                while (head) {
+                    auto* next = head->_next;
+                    ::operator delete(head);
+                    head = next;
+                }
+            }
+        }
+    };
+
+    static std::size_t _sizeClass(std::size_t size) noexcept {
+        return size ? (size - 1) / kGranularity : 0;
+    }
+
+    /**
+     * @brief 实际向全局堆申请的大小: 可缓存的帧取整到所在级别的块大小
+     * @param size
+     * @return std::size_t
+     */
+    static std::size_t _blockSize(std::size_t size) noexcept {
+        return kEnableFramePool && size <= kMaxSize
+            ? (_sizeClass(size) + 1) * kGranularity
+            : size;
+    }
+
+    static Pool& _pool() noexcept {
+        thread_local Pool pool;
+        return pool;
+    }
+
+    // 平凡析构, 在 Pool 析构之后仍可访问
+    inline static thread_local bool _isPoolDead = false;
+};
+
+/**
+ * @brief 继承它的 promise_type, 其协程帧会从 FrameAllocator 分配
+ */
+struct PooledFrame {
+    static void* operator new(std::size_t size) {
+        return FrameAllocator::allocate(size);
+    }
+
+    static void operator delete(void* ptr, std::size_t size) noexcept {
+        FrameAllocator::deallocate(ptr, size);
+    }
+};
+
+} // namespace HX::coroutine
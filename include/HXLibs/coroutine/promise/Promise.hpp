@@ -23,12 +23,13 @@
 
 #include <HXLibs/coroutine/awaiter/StopAwaiter.hpp>
 #include <HXLibs/coroutine/awaiter/PreviousAwaiter.hpp>
+#include <HXLibs/coroutine/promise/FrameAllocator.hpp>
 #include <HXLibs/container/Uninitialized.hpp>
 
 namespace HX::coroutine {
 
 /**
- * @brief 协程控制体
+ * @brief 协程控制体 (协程帧从 FrameAllocator 分配)
  * @tparam T 返回类型
  * @tparam Init 初始化体 (initial_suspend)
  * @tparam Dele 删除体 (final_suspend)
@@ -38,7 +39,7 @@ template <
     typename Init = StopAwaiter<true>,
     typename Dele = PreviousAwaiter
 >
-struct Promise {
+struct Promise : PooledFrame {
     using InitStrategy = Init;
     using DeleStrategy = Dele;
 
@@ -100,7 +101,7 @@ private:
 };
 
 template <typename Init, typename Dele>
-struct Promise<void, Init, Dele> {
+struct Promise<void, Init, Dele> : PooledFrame {
     using InitStrategy = Init;
     using DeleStrategy = Dele;
 
@@ -0,0 +1,108 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 11:47:05
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mutex>
+
+#include <HXLibs/coroutine/sync/WaiterList.hpp>
+
+namespace HX::coroutine {
+
+/**
+ * @brief 协程事件 (手动重置): set() 之后, 所有等待者以及之后的 wait() 都直接通过, 直到 reset()
+ * @note 可以跨事件循环使用 (等待者会在自己的事件循环上恢复)
+ * @note 唤醒总是投递到等待者的事件循环, 在下一轮循环中恢复 (同一个事件循环也是)
+ */
+class AsyncEvent {
+    struct [[nodiscard]] WaitAwaiter : internal::SyncWaiter {
+        WaitAwaiter(AsyncEvent& event) noexcept
+            : _event{event}
+        {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            std::lock_guard _{_event._mtx};
+            if (_event._isSet) {
+                return false;
+            }
+            prepare(handle);
+            _event._waiters.pushBack(this);
+            return true;
+        }
+
+        void await_resume() const noexcept {}
+    private:
+        AsyncEvent& _event;
+    };
+public:
+    /**
+     * @brief 创建事件
+     * @param isSet 初始是否已经触发
+     */
+    explicit AsyncEvent(bool isSet = false) noexcept
+        : _mtx{}
+        , _waiters{}
+        , _isSet{isSet}
+    {}
+
+    AsyncEvent& operator=(AsyncEvent&&) noexcept = delete;
+
+    /**
+     * @brief 等待事件触发: `co_await event.wait();`
+     * @return WaitAwaiter
+     */
+    WaitAwaiter wait() noexcept {
+        return {*this};
+    }
+
+    /**
+     * @brief 触发事件, 唤醒所有等待者
+     */
+    void set() {
+        internal::SyncWaiter* head;
+        {
+            std::lock_guard _{_mtx};
+            _isSet = true;
+            head = _waiters.popAll();
+        }
+        internal::wakeAll(head);
+    }
+
+    /**
+     * @brief 重置为未触发
+     */
+    void reset() noexcept {
+        std::lock_guard _{_mtx};
+        _isSet = false;
+    }
+
+    bool isSet() noexcept {
+        std::lock_guard _{_mtx};
+        return _isSet;
+    }
+private:
+    std::mutex _mtx;
+    internal::WaiterList<WaitAwaiter> _waiters;
+    bool _isSet;
+};
+
+} // namespace HX::coroutine
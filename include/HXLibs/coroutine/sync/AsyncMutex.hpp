@@ -0,0 +1,154 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 11:21:40
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mutex>
+#include <utility>
+
+#include <HXLibs/coroutine/sync/WaiterList.hpp>
+
+namespace HX::coroutine {
+
+/**
+ * @brief 协程互斥锁: 拿不到锁时挂起协程, 而不是阻塞事件循环的线程
+ * @note 先进先出; 解锁时直接把锁交给队首的等待者. 可以跨事件循环使用 (等待者会在自己的事件循环上恢复)
+ * @note 唤醒总是投递到等待者的事件循环, 在下一轮循环中恢复 (同一个事件循环也是), unlock() 不会在内部运行等待者
+ */
+class AsyncMutex {
+public:
+    /**
+     * @brief 自动解锁
+     */
+    class [[nodiscard]] Guard {
+    public:
+        explicit Guard(AsyncMutex& mtx) noexcept
+            : _mtx{&mtx}
+        {}
+
+        Guard(Guard&& that) noexcept
+            : _mtx{std::exchange(that._mtx, nullptr)}
+        {}
+
+        Guard& operator=(Guard&&) noexcept = delete;
+
+        /**
+         * @brief 提前解锁
+         */
+        void unlock() {
+            if (_mtx) {
+                std::exchange(_mtx, nullptr)->unlock();
+            }
+        }
+
+        ~Guard() noexcept {
+            unlock();
+        }
+    private:
+        AsyncMutex* _mtx;
+    };
+
+private:
+    struct [[nodiscard]] LockAwaiter : internal::SyncWaiter {
+        LockAwaiter(AsyncMutex& mtx) noexcept
+            : _mtx{mtx}
+        {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            std::lock_guard _{_mtx._mtx};
+            if (!_mtx._isLocked) {
+                _mtx._isLocked = true;
+                return false;
+            }
+            prepare(handle);
+            _mtx._waiters.pushBack(this);
+            return true;
+        }
+
+        void await_resume() const noexcept {}
+    protected:
+        AsyncMutex& _mtx;
+    };
+
+    struct [[nodiscard]] ScopedLockAwaiter : LockAwaiter {
+        using LockAwaiter::LockAwaiter;
+
+        Guard await_resume() const noexcept {
+            return Guard{_mtx};
+        }
+    };
+public:
+    AsyncMutex() noexcept
+        : _mtx{}
+        , _waiters{}
+        , _isLocked{false}
+    {}
+
+    AsyncMutex& operator=(AsyncMutex&&) noexcept = delete;
+
+    /**
+     * @brief 加锁: `co_await mtx.lock();`
+     * @return LockAwaiter
+     */
+    LockAwaiter lock() noexcept {
+        return {*this};
+    }
+
+    /**
+     * @brief 加锁, 并返回自动解锁的 Guard: `auto _ = co_await mtx.scopedLock();`
+     * @return ScopedLockAwaiter
+     */
+    ScopedLockAwaiter scopedLock() noexcept {
+        return {*this};
+    }
+
+    /**
+     * @brief 尝试加锁, 不会挂起
+     * @return true 加锁成功
+     */
+    bool tryLock() noexcept {
+        std::lock_guard _{_mtx};
+        return !std::exchange(_isLocked, true);
+    }
+
+    /**
+     * @brief 解锁, 如果有等待者, 则锁直接交给队首的等待者
+     */
+    void unlock() {
+        internal::SyncWaiter* next;
+        {
+            std::lock_guard _{_mtx};
+            next = _waiters.popFront();
+            if (!next) {
+                _isLocked = false;
+                return;
+            }
+        }
+        next->wake();
+    }
+private:
+    std::mutex _mtx;
+    internal::WaiterList<LockAwaiter> _waiters;
+    bool _isLocked;
+};
+
+} // namespace HX::coroutine
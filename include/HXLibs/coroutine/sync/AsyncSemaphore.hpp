@@ -0,0 +1,129 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 11:38:52
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mutex>
+#include <cstddef>
+
+#include <HXLibs/coroutine/sync/WaiterList.hpp>
+
+namespace HX::coroutine {
+
+/**
+ * @brief 协程计数信号量: 没有许可时挂起协程, 而不是阻塞事件循环的线程
+ * @note 先进先出; 释放时许可直接交给队首的等待者. 可以跨事件循环使用 (等待者会在自己的事件循环上恢复)
+ * @note 唤醒总是投递到等待者的事件循环, 在下一轮循环中恢复 (同一个事件循环也是)
+ */
+class AsyncSemaphore {
+    struct [[nodiscard]] AcquireAwaiter : internal::SyncWaiter {
+        AcquireAwaiter(AsyncSemaphore& sem) noexcept
+            : _sem{sem}
+        {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            std::lock_guard _{_sem._mtx};
+            if (_sem._count) {
+                --_sem._count;
+                return false;
+            }
+            prepare(handle);
+            _sem._waiters.pushBack(this);
+            return true;
+        }
+
+        void await_resume() const noexcept {}
+    private:
+        AsyncSemaphore& _sem;
+    };
+public:
+    /**
+     * @brief 创建信号量
+     * @param count 初始的许可数
+     */
+    explicit AsyncSemaphore(std::size_t count) noexcept
+        : _mtx{}
+        , _waiters{}
+        , _count{count}
+    {}
+
+    AsyncSemaphore& operator=(AsyncSemaphore&&) noexcept = delete;
+
+    /**
+     * @brief 获取一个许可: `co_await sem.acquire();`
+     * @return AcquireAwaiter
+     */
+    AcquireAwaiter acquire() noexcept {
+        return {*this};
+    }
+
+    /**
+     * @brief 尝试获取一个许可, 不会挂起
+     * @return true 获取成功
+     */
+    bool tryAcquire() noexcept {
+        std::lock_guard _{_mtx};
+        if (!_count) {
+            return false;
+        }
+        --_count;
+        return true;
+    }
+
+    /**
+     * @brief 释放许可, 优先交给等待者
+     * @param n 许可数
+     */
+    void release(std::size_t n = 1) {
+        internal::SyncWaiter* head = nullptr;
+        internal::SyncWaiter** tail = &head;
+        {
+            std::lock_guard _{_mtx};
+            for (; n; --n) {
+                auto* node = _waiters.popFront();
+                if (!node) {
+                    _count += n;
+                    break;
+                }
+                *tail = node;
+                tail = &node->_next;
+            }
+        }
+        *tail = nullptr;
+        internal::wakeAll(head);
+    }
+
+    /**
+     * @brief 当前可用的许可数
+     * @return std::size_t
+     */
+    std::size_t available() noexcept {
+        std::lock_guard _{_mtx};
+        return _count;
+    }
+private:
+    std::mutex _mtx;
+    internal::WaiterList<AcquireAwaiter> _waiters;
+    std::size_t _count;
+};
+
+} // namespace HX::coroutine
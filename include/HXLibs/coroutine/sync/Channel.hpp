@@ -0,0 +1,274 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 12:06:27
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mutex>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <optional>
+#include <type_traits>
+
+#include <HXLibs/coroutine/sync/WaiterList.hpp>
+
+namespace HX::coroutine {
+
+/**
+ * @brief 有界的多生产者-多消费者协程通道
+ * @note 缓冲区满时 send 挂起, 空时 recv 挂起; 有等待的一方时直接交接, 不经过缓冲区.
+ *       容量为 0 时为无缓冲通道 (send 等到有 recv 取走为止). 可以跨事件循环使用 (等待者会在自己的事件循环上恢复)
+ * @note 唤醒总是投递到等待者的事件循环, 在下一轮循环中恢复 (同一个事件循环也是)
+ * @tparam T 元素类型, 需要可移动构造
+ */
+template <typename T>
+class Channel {
+    struct [[nodiscard]] SendAwaiter : internal::SyncWaiter {
+        SendAwaiter(Channel& ch, T&& val)
+            : _ch{ch}
+            , _val{std::move(val)}
+            , _isOk{false}
+        {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            std::unique_lock lock{_ch._mtx};
+            if (_ch._isClosed) {
+                return false;
+            }
+            _isOk = true;
+            if (auto* receiver = _ch._receivers.popFront()) {
+                receiver->_val.emplace(std::move(_val));
+                lock.unlock();
+                receiver->wake();
+                return false;
+            }
+            if (_ch._size < _ch._buf.size()) {
+                _ch._push(std::move(_val));
+                return false;
+            }
+            _isOk = false;
+            prepare(handle);
+            _ch._senders.pushBack(this);
+            return true;
+        }
+
+        /**
+         * @return true 已送达 (进入缓冲区或者交给接收者)
+         * @return false 通道已经关闭, 元素被丢弃
+         */
+        bool await_resume() const noexcept {
+            return _isOk;
+        }
+
+        Channel& _ch;
+        T _val;
+        bool _isOk;
+    };
+
+    struct [[nodiscard]] RecvAwaiter : internal::SyncWaiter {
+        RecvAwaiter(Channel& ch) noexcept
+            : _ch{ch}
+            , _val{}
+        {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            std::unique_lock lock{_ch._mtx};
+            if (auto val = _ch._tryRecv()) {
+                _val.emplace(std::move(val->first));
+                lock.unlock();
+                if (val->second) {
+                    val->second->wake();
+                }
+                return false;
+            }
+            if (_ch._isClosed) {
+                return false;
+            }
+            prepare(handle);
+            _ch._receivers.pushBack(this);
+            return true;
+        }
+
+        /**
+         * @return std::optional<T> 通道已经关闭并且没有剩余元素时为空
+         */
+        std::optional<T> await_resume() noexcept(std::is_nothrow_move_constructible_v<T>) {
+            return std::move(_val);
+        }
+
+        Channel& _ch;
+        std::optional<T> _val;
+    };
+public:
+    /**
+     * @brief 创建通道
+     * @param capacity 缓冲区容量 (预先分配), 0 为无缓冲
+     */
+    explicit Channel(std::size_t capacity)
+        : _mtx{}
+        , _buf(capacity)
+        , _head{}
+        , _size{}
+        , _senders{}
+        , _receivers{}
+        , _isClosed{false}
+    {}
+
+    Channel& operator=(Channel&&) noexcept = delete;
+
+    /**
+     * @brief 发送: `bool ok = co_await ch.send(val);`
+     * @param val
+     * @return SendAwaiter 通道已经关闭时为 false
+     */
+    SendAwaiter send(T val) {
+        return {*this, std::move(val)};
+    }
+
+    /**
+     * @brief 接收: `std::optional<T> val = co_await ch.recv();`
+     * @return RecvAwaiter 通道已经关闭并且没有剩余元素时为空
+     */
+    RecvAwaiter recv() noexcept {
+        return {*this};
+    }
+
+    /**
+     * @brief 尝试发送, 不会挂起
+     * @param val 失败时不会被移动
+     * @return true 发送成功; false 缓冲区已满 (且没有等待的接收者) 或者通道已经关闭
+     */
+    bool trySend(T& val) {
+        std::unique_lock lock{_mtx};
+        if (_isClosed) {
+            return false;
+        }
+        if (auto* receiver = _receivers.popFront()) {
+            receiver->_val.emplace(std::move(val));
+            lock.unlock();
+            receiver->wake();
+            return true;
+        }
+        if (_size < _buf.size()) {
+            _push(std::move(val));
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief 尝试发送临时值, 不会挂起: `ch.trySend(std::move(val))`, `ch.trySend(T{...})`
+     * @param val 失败时同样不会被移动
+     * @return 同 trySend(T&)
+     */
+    bool trySend(T&& val) {
+        return trySend(val);
+    }
+
+    /**
+     * @brief 尝试接收, 不会挂起
+     * @return std::optional<T> 没有可用的元素时为空
+     */
+    std::optional<T> tryRecv() {
+        std::unique_lock lock{_mtx};
+        auto val = _tryRecv();
+        if (!val) {
+            return {};
+        }
+        lock.unlock();
+        if (val->second) {
+            val->second->wake();
+        }
+        return std::move(val->first);
+    }
+
+    /**
+     * @brief 关闭通道: 唤醒所有等待者, 等待的 send 返回 false, 等待的 recv 返回空;
+     *        缓冲区中剩余的元素仍然可以被接收
+     */
+    void close() {
+        internal::SyncWaiter* senders;
+        internal::SyncWaiter* receivers;
+        {
+            std::lock_guard _{_mtx};
+            _isClosed = true;
+            senders = _senders.popAll();
+            receivers = _receivers.popAll();
+        }
+        internal::wakeAll(senders);
+        internal::wakeAll(receivers);
+    }
+
+    bool isClosed() noexcept {
+        std::lock_guard _{_mtx};
+        return _isClosed;
+    }
+
+    std::size_t capacity() const noexcept {
+        return _buf.size();
+    }
+private:
+    void _push(T&& val) {
+        _buf[(_head + _size) % _buf.size()].emplace(std::move(val));
+        ++_size;
+    }
+
+    /**
+     * @brief 取出一个元素 (需要持有锁): 优先从缓冲区取, 并把一个等待的发送者的元素补入缓冲区;
+     *        缓冲区为空时 (无缓冲通道) 直接从等待的发送者处取
+     * @return std::optional<std::pair<T, SendAwaiter*>> 元素, 以及需要在锁外唤醒的发送者
+     */
+    std::optional<std::pair<T, SendAwaiter*>> _tryRecv() {
+        auto* sender = _senders.popFront();
+        if (_size) {
+            auto& slot = _buf[_head];
+            std::pair<T, SendAwaiter*> res{std::move(*slot), sender};
+            slot.reset();
+            _head = (_head + 1) % _buf.size();
+            --_size;
+            if (sender) {
+                _push(std::move(sender->_val));
+                sender->_isOk = true;
+            }
+            return res;
+        }
+        if (sender) {
+            sender->_isOk = true;
+            return std::pair<T, SendAwaiter*>{std::move(sender->_val), sender};
+        }
+        return {};
+    }
+
+    std::mutex _mtx;
+    std::vector<std::optional<T>> _buf;     // 环形缓冲区
+    std::size_t _head;
+    std::size_t _size;
+    internal::WaiterList<SendAwaiter> _senders;
+    internal::WaiterList<RecvAwaiter> _receivers;
+    bool _isClosed;
+};
+
+} // namespace HX::coroutine
@@ -0,0 +1,144 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 11:03:18
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <coroutine>
+
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+
+namespace HX::coroutine::internal {
+
+/**
+ * @brief 同步原语的等待者 (侵入式节点, 就在 awaiter 内部, 无内存分配)
+ * @note 挂起时记录当前的事件循环; 唤醒时总是投递到挂起时的事件循环上恢复 (同一个事件循环也不在唤醒方内部恢复,
+ *       否则被唤醒者的下一次释放又会在其内部恢复下一个等待者, 栈深度随等待者数增长),
+ *       挂起时不在任何事件循环中的才直接恢复. 等待期间通过 EventLoop::retain() 使事件循环不会退出
+ * @warning 跨事件循环使用时, 等待者的事件循环需要比唤醒操作活得更久 (同 EventLoop::post)
+ */
+struct SyncWaiter : PostTask {
+    SyncWaiter() noexcept
+        : _handle{}
+        , _loop{}
+        , _next{}
+    {}
+
+    SyncWaiter& operator=(SyncWaiter&&) noexcept = delete;
+
+    void run() override {
+        _loop->release();
+        _handle.resume();
+    }
+
+    void destroy() noexcept override {}
+
+    /**
+     * @brief 确定要挂起时 (入队前) 调用, 记录协程与当前的事件循环
+     * @param handle
+     */
+    void prepare(std::coroutine_handle<> handle) noexcept {
+        _handle = handle;
+        _loop = EventLoop::current();
+        if (_loop) {
+            _loop->retain();
+        }
+    }
+
+    /**
+     * @brief 唤醒 (不能持有同步原语内部的锁)
+     * @warning 之后不能再访问本对象, 协程可能已经恢复, 本对象随之析构
+     */
+    void wake() {
+        if (_loop) [[likely]] {
+            _loop->postGuarded(this); // 等待者可能在 sync() 中, 恢复后事件循环随即析构
+        } else {
+            _handle.resume();
+        }
+    }
+
+    std::coroutine_handle<> _handle;
+    EventLoop* _loop;
+    SyncWaiter* _next;
+};
+
+/**
+ * @brief 先进先出的侵入式等待队列 (不是线程安全的, 由同步原语加锁保护)
+ * @tparam Node 继承自 SyncWaiter
+ */
+template <typename Node>
+class WaiterList {
+public:
+    WaiterList() noexcept
+        : _head{}
+        , _tail{}
+    {}
+
+    WaiterList& operator=(WaiterList&&) noexcept = delete;
+
+    bool empty() const noexcept {
+        return !_head;
+    }
+
+    void pushBack(Node* node) noexcept {
+        node->_next = nullptr;
+        if (_tail) {
+            _tail->_next = node;
+        } else {
+            _head = node;
+        }
+        _tail = node;
+    }
+
+    Node* popFront() noexcept {
+        auto* node = _head;
+        if (node) {
+            _head = static_cast<Node*>(node->_next);
+            if (!_head) {
+                _tail = nullptr;
+            }
+        }
+        return node;
+    }
+
+    /**
+     * @brief 取出整个队列, 以便在锁外逐个唤醒
+     * @return Node* 链表头, 通过 _next 遍历
+     */
+    Node* popAll() noexcept {
+        auto* node = _head;
+        _head = _tail = nullptr;
+        return node;
+    }
+private:
+    Node* _head;
+    Node* _tail;
+};
+
+/**
+ * @brief 唤醒由 WaiterList::popAll 取出的链表
+ * @param node
+ */
+inline void wakeAll(SyncWaiter* node) {
+    while (node) {
+        auto* next = node->_next; // 唤醒后节点可能已经析构
+        node->wake();
+        node = next;
+    }
+}
+
+} // namespace HX::coroutine::internal
@@ -19,6 +19,9 @@
  */
 
 #include <span>
+#include <deque>
+#include <stdexcept>
+#include <utility>
 
 #include <HXLibs/platform/EventLoopApi.hpp>
 #include <HXLibs/platform/LocalFdApi.hpp>
@@ -34,9 +37,115 @@ struct IoUring;
 
 } // namespace internal
 
+struct AioTask;
+
+/**
+ * @brief 零拷贝发送 (IORING_OP_SEND_ZC) 的缓冲区通知
+ * @note 零拷贝发送会产生两个 cqe: 发送结果 (带有 IORING_CQE_F_MORE), 以及之后
+ *       内核不再引用缓冲区时的通知 (IORING_CQE_F_NOTIF). co_await 发送任务在第一个 cqe
+ *       时就返回, 而缓冲区需要存活到 `co_await wait()` 返回, 期间可以继续发送 (共用一个通知器).
+ *       共享状态按引用计数管理 (通知器 + 每个未通知的 sqe), 因此通知器先析构也不会悬垂.
+ * @warning 同一时刻只能有一个发送在等待结果 (结果的 cqe 只能找到一个任务): 上一次 co_await 返回之前
+ *          再次关联会抛出 std::logic_error; 通知则可以有多个未到达
+ */
+struct SendZcNotifier {
+    /**
+     * @brief user_data 的标记位, 用于 IoUring::run 区分零拷贝发送
+     * @note 状态按 new 的对齐分配, 低 3 位一定为 0 (1 / 2 已被 MultishotAioTask / AioTask 使用)
+     */
+    inline static constexpr ::__u64 kUserDataTag = 4;
+
+    SendZcNotifier() noexcept
+        : _state{nullptr}
+    {}
+
+    SendZcNotifier& operator=(SendZcNotifier&&) noexcept = delete;
+
+    ~SendZcNotifier() noexcept {
+        if (_state) {
+            _release(_state);
+        }
+    }
+
+    struct WaitAwaiter {
+        bool await_ready() const noexcept {
+            return !_notifier->_state || _notifier->_state->refNum == 1;
+        }
+        void await_suspend(std::coroutine_handle<> coroutine) const noexcept {
+            _notifier->_state->waiter = coroutine;
+        }
+        constexpr void await_resume() const noexcept {}
+        SendZcNotifier const* _notifier;
+    };
+
+    /**
+     * @brief 等待之前所有零拷贝发送的通知, 返回后缓冲区即可释放或复用
+     * @return WaitAwaiter
+     */
+    [[nodiscard]] WaitAwaiter wait() const noexcept {
+        return {this};
+    }
+
+private:
+    friend AioTask;
+    friend internal::IoUring;
+
+    struct State {
+        std::size_t refNum;                 // 通知器自身 + 尚未收到通知的 sqe
+        std::coroutine_handle<> waiter;     // 阻塞在 wait() 的协程
+        AioTask* task;                      // 当前在等待发送结果的任务, 收到结果后置空
+    };
+
+    /**
+     * @brief 是否有发送仍在等待结果
+     */
+    bool _isSending() const noexcept {
+        return _state && _state->task;
+    }
+
+    ::__u64 _attach(AioTask* task) {
+        if (!_state) {
+            _state = new State{1, {}, nullptr};
+        }
+        ++_state->refNum;
+        _state->task = task;
+        return reinterpret_cast<::__u64>(_state) | kUserDataTag;
+    }
+
+    /**
+     * @brief 释放一个引用
+     * @return std::coroutine_handle<> 只剩通知器时, 返回需要恢复的 wait() 协程 (可能为空)
+     */
+    static std::coroutine_handle<> _release(State* state) noexcept {
+        if (--state->refNum == 0) {
+            delete state;
+            return {};
+        }
+        if (state->refNum == 1) {
+            return std::exchange(state->waiter, {});
+        }
+        return {};
+    }
+
+    State* _state;
+};
+
 struct AioTask {
+    /**
+     * @brief user_data 的标记位: 带有它的任务被取消时, 也会以 -ECANCELED 恢复
+     * @note 对象至少按指针对齐, 故低位一定为 0, 可以借用 (最低位已被 MultishotAioTask 使用)
+     */
+    inline static constexpr ::__u64 kCancelableTag = 2;
+
+    /**
+     * @brief 不关心结果的任务的 user_data, 其 cqe 会被直接丢弃
+     */
+    inline static constexpr ::__u64 kDetachedUserData = 0;
+
     AioTask(::io_uring_sqe* sqe) noexcept
         : _sqe{sqe}
+        , _previous{}
+        , _cqeFlags{}
     {
         ::io_uring_sqe_set_data(_sqe, this);
     }
@@ -67,14 +176,65 @@ struct AioTask {
         return {this};
     }
 
+    /**
+     * @brief 获取完成时 cqe 的 flags (如 `IORING_CQE_F_BUFFER`), 仅在 co_await 完成后有效
+     * @return unsigned int
+     */
+    unsigned int cqeFlags() const noexcept {
+        return _cqeFlags;
+    }
+
+    /**
+     * @brief 获取该任务 `cancelable()` 之后在 io_uring 中的 user_data (用于取消)
+     * @return ::__u64
+     */
+    ::__u64 userData() const noexcept {
+        return reinterpret_cast<::__u64>(this) | kCancelableTag;
+    }
+
+    /**
+     * @brief 标记为可取消: 被 `prepCancel(userData())` 取消时, 会以 -ECANCELED 恢复等待的协程
+     * @note 普通任务被取消时不会恢复 (如 linkTimeout 中输掉的一方), 因此需要显式标记;
+     *       一般通过 EventLoop::cancelable 使用, 而不是直接调用
+     * @warning 需要在 prepXxx 之后, co_await 之前调用
+     * @return AioTask&&
+     */
+    [[nodiscard]] AioTask&& cancelable() && {
+        ::io_uring_sqe_set_data64(_sqe, userData());
+        return std::move(*this);
+    }
+
+    /**
+     * @brief 不等待该任务的结果 (完成时 cqe 直接丢弃), 用于取消、关闭读写等不关心结果的操作
+     * @warning 之后不可以再 co_await 它
+     */
+    void detach() && noexcept {
+        ::io_uring_sqe_set_data64(_sqe, kDetachedUserData);
+    }
+
 private:
     friend internal::IoUring;
 
+    /**
+     * @brief 把零拷贝发送关联到通知器
+     * @throw std::logic_error 通知器上一次的发送还没有得到结果; 此时 sqe 改为空操作并丢弃其 cqe
+     * @return ::__u64 sqe 的 user_data
+     */
+    ::__u64 _attachZc(SendZcNotifier& notifier) {
+        if (notifier._isSending()) [[unlikely]] {
+            ::io_uring_prep_nop(_sqe);
+            ::io_uring_sqe_set_data64(_sqe, kDetachedUserData);
+            throw std::logic_error{"SendZcNotifier: the previous send has not completed yet"};
+        }
+        return notifier._attach(this);
+    }
+
     union {
         int _res;
         ::io_uring_sqe* _sqe;
     };
     std::coroutine_handle<> _previous;
+    unsigned int _cqeFlags;
 
 public:
     /**
@@ -95,6 +255,26 @@ public:
         return std::move(*this);
     }
 
+    /**
+     * @brief 异步获取文件元数据
+     * @param dirfd 目录文件描述符; `AT_FDCWD`, 则表示相对于当前工作目录
+     * @param path 文件路径; 为 `""` 且 flags 含 `AT_EMPTY_PATH` 时, 获取 dirfd 本身的元数据
+     * @param flags 如 `AT_EMPTY_PATH`
+     * @param mask 需要的字段, 如 `STATX_SIZE | STATX_MTIME`
+     * @param statxbuf [out] 元数据
+     * @return AioTask&& 
+     */
+    [[nodiscard]] AioTask&& prepStatx(
+        int dirfd,
+        char const* path,
+        int flags,
+        unsigned int mask,
+        struct ::statx* statxbuf
+    ) && {
+        ::io_uring_prep_statx(_sqe, dirfd, path, flags, mask, statxbuf);
+        return std::move(*this);
+    }
+
     /**
      * @brief 异步创建一个套接字
      * @param domain 指定 socket 的协议族 (AF_INET(ipv4)/AF_INET6(ipv6)/AF_UNIX/AF_LOCAL(本地))
@@ -131,6 +311,26 @@ public:
         return std::move(*this);
     }
 
+    /**
+     * @brief 异步建立连接, 并且把新的套接字直接放入注册文件表 (registered files)
+     * @note 结果是注册文件表的下标, 而不是 fd; 之后的操作需要 `useFixedFile()`
+     * @warning 需要先 `IoUring::registerFixedFiles`
+     * @param fd 服务端套接字
+     * @param addr [out] 客户端信息
+     * @param addrlen [out] 客户端信息长度指针
+     * @param flags 
+     * @return AioTask&& 
+     */
+    [[nodiscard]] AioTask&& prepAcceptDirect(
+        int fd, 
+        struct ::sockaddr *addr, 
+        ::socklen_t *addrlen,
+        int flags
+    ) && {
+        ::io_uring_prep_accept_direct(_sqe, fd, addr, addrlen, flags, IORING_FILE_INDEX_ALLOC);
+        return std::move(*this);
+    }
+
     /**
      * @brief 异步的向服务端创建连接
      * @param fd 客户端套接字
@@ -197,6 +397,44 @@ public:
         return std::move(*this);
     }
 
+    /**
+     * @brief 异步读取文件到注册缓冲区 (IORING_OP_READ_FIXED)
+     * @param fd 文件描述符
+     * @param buf [out] 读取到的数据, 需要位于注册缓冲区 bufIndex 之内
+     * @param offset 文件偏移量
+     * @param bufIndex 注册缓冲区下标, 见 `FixedBufPool`
+     * @return AioTask&& 
+     */
+    [[nodiscard]] AioTask&& prepReadFixed(
+        int fd,
+        std::span<char> buf,
+        std::uint64_t offset,
+        int bufIndex
+    ) && {
+        ::io_uring_prep_read_fixed(
+            _sqe, fd, buf.data(), static_cast<unsigned int>(buf.size()), offset, bufIndex);
+        return std::move(*this);
+    }
+
+    /**
+     * @brief 从注册缓冲区异步写入文件 (IORING_OP_WRITE_FIXED)
+     * @param fd 文件描述符
+     * @param buf [in] 写入的数据, 需要位于注册缓冲区 bufIndex 之内
+     * @param offset 文件偏移量
+     * @param bufIndex 注册缓冲区下标, 见 `FixedBufPool`
+     * @return AioTask&& 
+     */
+    [[nodiscard]] AioTask&& prepWriteFixed(
+        int fd,
+        std::span<char const> buf,
+        std::uint64_t offset,
+        int bufIndex
+    ) && {
+        ::io_uring_prep_write_fixed(
+            _sqe, fd, buf.data(), static_cast<unsigned int>(buf.size()), offset, bufIndex);
+        return std::move(*this);
+    }
+
     /**
      * @brief 异步读取网络套接字文件
      * @param fd 文件描述符
@@ -214,6 +452,26 @@ public:
         return std::move(*this);
     }
 
+    /**
+     * @brief 异步读取网络套接字文件, 由内核从 provided buffer ring 中挑选缓冲区
+     * @note 成功时 `cqeFlags()` 带有 `IORING_CQE_F_BUFFER`, 缓冲区 id 为
+     *       `cqeFlags() >> IORING_CQE_BUFFER_SHIFT`; 环中没有缓冲区时得到 -ENOBUFS
+     * @param fd 文件描述符
+     * @param bgid 缓冲区组 id (`ProvidedBufRing::bgid()`)
+     * @param flags 
+     * @return AioTask&& 
+     */
+    [[nodiscard]] AioTask&& prepRecvBufSelect(
+        int fd,
+        unsigned short bgid,
+        int flags
+    ) && {
+        ::io_uring_prep_recv(_sqe, fd, nullptr, 0, flags);
+        _sqe->flags |= IOSQE_BUFFER_SELECT;
+        _sqe->buf_group = bgid;
+        return std::move(*this);
+    }
+
     /**
      * @brief 异步写入网络套接字文件
      * @param fd 文件描述符
@@ -230,6 +488,91 @@ public:
         return std::move(*this);
     }
 
+    /**
+     * @brief 异步在两个 fd 之间移动数据 (其中至少一个是管道), 数据不经过用户态
+     * @param fdIn 输入 fd
+     * @param offIn 输入的偏移量, 管道为 -1
+     * @param fdOut 输出 fd (注册文件表模式下需要 `useFixedFile()`)
+     * @param offOut 输出的偏移量, 管道或套接字为 -1
+     * @param nbytes 最多移动的字节数
+     * @param flags 如 `SPLICE_F_MOVE`
+     * @return AioTask&& 结果: 移动的字节数; 不支持 splice 的文件得到 -EINVAL
+     */
+    [[nodiscard]] AioTask&& prepSplice(
+        int fdIn,
+        int64_t offIn,
+        int fdOut,
+        int64_t offOut,
+        unsigned int nbytes,
+        unsigned int flags
+    ) && {
+        ::io_uring_prep_splice(_sqe, fdIn, offIn, fdOut, offOut, nbytes, flags);
+        return std::move(*this);
+    }
+
+    /**
+     * @brief 异步聚集写入网络套接字文件 (一次写入多段数据)
+     * @param fd 文件描述符
+     * @param msg [in] 其 msg_iov 指向要写入的多段数据, 需要存活到 co_await 返回
+     * @param flags 
+     * @return AioTask&& 
+     */
+    [[nodiscard]] AioTask&& prepSendmsg(
+        int fd, 
+        ::msghdr const* msg, 
+        unsigned int flags
+    ) && {
+        ::io_uring_prep_sendmsg(_sqe, fd, msg, flags);
+        return std::move(*this);
+    }
+
+    /**
+     * @brief 异步零拷贝聚集写入网络套接字文件 (IORING_OP_SENDMSG_ZC)
+     * @note 同 prepSendZc, co_await 在发送结果时返回, 数据需要存活到 `co_await notifier.wait()` 返回
+     * @warning 需要 Linux 6.1+, 否则得到 -EINVAL
+     * @param fd 文件描述符
+     * @param msg [in] 同 prepSendmsg
+     * @param flags 如 `MSG_WAITALL`
+     * @param notifier 缓冲区通知
+     * @return AioTask&& 
+     */
+    [[nodiscard]] AioTask&& prepSendmsgZc(
+        int fd, 
+        ::msghdr const* msg, 
+        unsigned int flags,
+        SendZcNotifier& notifier
+    ) && {
+        auto userData = _attachZc(notifier);
+        ::io_uring_prep_sendmsg_zc(_sqe, fd, msg, flags);
+        ::io_uring_sqe_set_data64(_sqe, userData);
+        return std::move(*this);
+    }
+
+    /**
+     * @brief 异步零拷贝写入网络套接字文件 (IORING_OP_SEND_ZC)
+     * @note co_await 在发送结果的 cqe 时就返回, 此时内核可能仍在引用 buf;
+     *       需要 `co_await notifier.wait()` 之后, buf 才可以释放或复用
+     * @warning 需要 Linux 6.0+, 否则得到 -EINVAL; 不支持零拷贝的套接字得到 -EOPNOTSUPP
+     * @param fd 文件描述符
+     * @param buf [in] 写入的数据, 需要存活到 notifier.wait() 返回
+     * @param flags 如 `MSG_WAITALL`
+     * @param zcFlags 如 `IORING_SEND_ZC_REPORT_USAGE`
+     * @param notifier 缓冲区通知
+     * @return AioTask&& 
+     */
+    [[nodiscard]] AioTask&& prepSendZc(
+        int fd, 
+        std::span<char const> buf, 
+        int flags,
+        unsigned int zcFlags,
+        SendZcNotifier& notifier
+    ) && {
+        auto userData = _attachZc(notifier);
+        ::io_uring_prep_send_zc(_sqe, fd, buf.data(), buf.size(), flags, zcFlags);
+        ::io_uring_sqe_set_data64(_sqe, userData);
+        return std::move(*this);
+    }
+
     /**
      * @brief 异步关闭文件
      * @param fd 文件描述符
@@ -240,6 +583,27 @@ public:
         return std::move(*this);
     }
 
+    /**
+     * @brief 异步关闭注册文件表中的文件
+     * @param fileIndex 注册文件表的下标
+     * @return AioTask&& 
+     */
+    [[nodiscard]] AioTask&& prepCloseDirect(unsigned int fileIndex) && {
+        ::io_uring_prep_close_direct(_sqe, fileIndex);
+        return std::move(*this);
+    }
+
+    /**
+     * @brief 把 prep 时传入的 fd 视为注册文件表的下标 (IOSQE_FIXED_FILE),
+     *        这样内核不需要每次都 fget/fput
+     * @warning 需要在 prep 之后调用 (prep 会重置 flags)
+     * @return AioTask&& 
+     */
+    [[nodiscard]] AioTask&& useFixedFile() && {
+        _sqe->flags |= IOSQE_FIXED_FILE;
+        return std::move(*this);
+    }
+
     /**
      * @brief 监测一个fd的pool事件
      * @param fd 需要监测的fd
@@ -254,6 +618,48 @@ public:
         return std::move(*this);
     }
 
+    /**
+     * @brief 异步取消一个已提交的任务
+     * @param userData 需要取消的任务的 user_data (如: `MultishotAioTask::userData()`)
+     * @param flags 如 `IORING_ASYNC_CANCEL_ALL`
+     * @return AioTask&& 结果: 0 成功; -ENOENT 找不到; -EALREADY 已在执行
+     */
+    [[nodiscard]] AioTask&& prepCancel(
+        ::__u64 userData,
+        int flags
+    ) && {
+        ::io_uring_prep_cancel64(_sqe, userData, flags);
+        return std::move(*this);
+    }
+
+    /**
+     * @brief 异步取消一个 fd 上已提交的任务
+     * @param fd 文件描述符 (注册文件表模式下需要 `useFixedFile()`)
+     * @param flags 如 `IORING_ASYNC_CANCEL_ALL`
+     * @return AioTask&& 结果: 同 prepCancel, 取消全部时为取消的个数
+     */
+    [[nodiscard]] AioTask&& prepCancelFd(
+        int fd,
+        unsigned int flags
+    ) && {
+        ::io_uring_prep_cancel_fd(_sqe, fd, flags);
+        return std::move(*this);
+    }
+
+    /**
+     * @brief 异步关闭套接字的读写 (不会关闭 fd), 正在等待的读写会立即返回
+     * @param fd 套接字
+     * @param how `SHUT_RD` / `SHUT_WR` / `SHUT_RDWR`
+     * @return AioTask&& 
+     */
+    [[nodiscard]] AioTask&& prepShutdown(
+        int fd,
+        int how
+    ) && {
+        ::io_uring_prep_shutdown(_sqe, fd, how);
+        return std::move(*this);
+    }
+
     /**
      * @brief 创建未链接的超时操作
      * @param ts 超时时间
@@ -284,6 +690,129 @@ public:
     ~AioTask() noexcept = default;
 };
 
+/**
+ * @brief 多发 (multishot) 异步任务: 一个 sqe 会持续产生多个 cqe
+ * @note 与 AioTask 不同, 它需要作为具名对象存活到 isArmed() 为 false 为止,
+ *       即内核不会再产生 cqe 时 (最后一个 cqe 不带有 IORING_CQE_F_MORE) 才可以析构.
+ *       期间可以反复 co_await, 每次得到一个 cqe 的 res; 先到的结果会被缓存.
+ */
+struct MultishotAioTask {
+    /**
+     * @brief user_data 的标记位, 用于 IoUring::run 区分 AioTask 与 MultishotAioTask
+     * @note 对象至少按指针对齐, 故最低位一定为 0, 可以借用
+     */
+    inline static constexpr ::__u64 kUserDataTag = 1;
+
+    MultishotAioTask(::io_uring_sqe* sqe) noexcept
+        : _sqe{sqe}
+        , _results{}
+        , _previous{}
+        , _isArmed{true}
+    {
+        ::io_uring_sqe_set_data64(_sqe, userData());
+    }
+
+    MultishotAioTask& operator=(MultishotAioTask&&) noexcept = delete;
+
+    struct MultishotAioAwaiter {
+        bool await_ready() const noexcept { return !_task->_results.empty(); }
+        void await_suspend(std::coroutine_handle<> coroutine) const noexcept {
+            _task->_previous = coroutine;
+        }
+        int await_resume() const noexcept {
+            auto [res, isMore] = _task->_results.front();
+            _task->_results.pop_front();
+            _task->_isArmed = isMore;
+            return res;
+        }
+        MultishotAioTask* _task;
+    };
+
+    MultishotAioAwaiter operator co_await() noexcept {
+        return {this};
+    }
+
+    /**
+     * @brief 内核是否还会继续产生 cqe (即是否还需要继续 co_await)
+     * @return true 仍然有效, 需要继续等待
+     * @return false 已经结束 (最后一个结果已被取出)
+     */
+    bool isArmed() const noexcept {
+        return _isArmed;
+    }
+
+    /**
+     * @brief 获取该任务在 io_uring 中的 user_data (可用于取消)
+     * @return ::__u64
+     */
+    ::__u64 userData() const noexcept {
+        return reinterpret_cast<::__u64>(this) | kUserDataTag;
+    }
+
+    /**
+     * @brief 多发异步建立连接, 每有一个新连接就产生一个 cqe
+     * @warning 需要 Linux 5.19+, 否则第一次 co_await 得到 -EINVAL
+     * @param fd 服务端套接字
+     * @param addr [out] 客户端信息
+     * @param addrlen [out] 客户端信息长度指针
+     * @param flags
+     * @return MultishotAioTask&
+     */
+    MultishotAioTask& prepMultishotAccept(
+        int fd,
+        struct ::sockaddr *addr,
+        ::socklen_t *addrlen,
+        int flags
+    ) & {
+        ::io_uring_prep_multishot_accept(_sqe, fd, addr, addrlen, flags);
+        return *this;
+    }
+
+    /**
+     * @brief 多发异步建立连接, 新的套接字直接放入注册文件表, 结果为表的下标
+     * @warning 需要先 `IoUring::registerFixedFiles`
+     * @param fd 服务端套接字
+     * @param addr [out] 客户端信息
+     * @param addrlen [out] 客户端信息长度指针
+     * @param flags
+     * @return MultishotAioTask&
+     */
+    MultishotAioTask& prepMultishotAcceptDirect(
+        int fd,
+        struct ::sockaddr *addr,
+        ::socklen_t *addrlen,
+        int flags
+    ) & {
+        ::io_uring_prep_multishot_accept_direct(_sqe, fd, addr, addrlen, flags);
+        return *this;
+    }
+
+    ~MultishotAioTask() noexcept = default;
+
+private:
+    friend internal::IoUring;
+
+    struct CqeResult {
+        int res;
+        bool isMore;
+    };
+
+    /**
+     * @brief 由 IoUring::run 调用, 记录一个 cqe 的结果
+     * @return std::coroutine_handle<> 需要被恢复的协程, 如果没有协程在等待则为空
+     * @throw std::bad_alloc 结果队列扩容失败 (与 run 中的 tasks.push_back 一样向外传播)
+     */
+    std::coroutine_handle<> _pushResult(int res, bool isMore) {
+        _results.push_back({res, isMore});
+        return std::exchange(_previous, nullptr);
+    }
+
+    ::io_uring_sqe* _sqe;
+    std::deque<CqeResult> _results;
+    std::coroutine_handle<> _previous;
+    bool _isArmed;
+};
+
 } // namespace HX::coroutine
 
 #elif defined(_WIN32)
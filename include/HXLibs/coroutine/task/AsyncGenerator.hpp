@@ -0,0 +1,127 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 13:15:44
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <utility>
+#include <optional>
+#include <exception>
+#include <coroutine>
+
+#include <HXLibs/coroutine/awaiter/PreviousAwaiter.hpp>
+#include <HXLibs/coroutine/promise/FrameAllocator.hpp>
+
+namespace HX::coroutine {
+
+/**
+ * @brief 异步生成器: 协程体内既可以 co_await, 也可以 co_yield
+ * @note 惰性的: 只有 `co_await gen.next()` 时才会运行到下一个 co_yield (或者结束);
+ *       用法: `while (auto v = co_await gen.next()) { ... }`
+ * @warning 不能同时有两个 next() 在等待
+ * @tparam T 产出的类型
+ */
+template <typename T>
+class [[nodiscard]] AsyncGenerator {
+public:
+    struct promise_type : PooledFrame {
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        AsyncGenerator get_return_object() noexcept {
+            return AsyncGenerator{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        PreviousAwaiter final_suspend() noexcept {
+            return {_previous};
+        }
+
+        PreviousAwaiter yield_value(T value) {
+            _value.emplace(std::move(value));
+            return {_previous};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept {
+            _exception = std::current_exception();
+        }
+
+        promise_type& operator=(promise_type&&) noexcept = delete;
+
+        std::coroutine_handle<> _previous{};
+        std::optional<T> _value{};
+        std::exception_ptr _exception{};
+    };
+
+    explicit AsyncGenerator(std::coroutine_handle<promise_type> h = nullptr) noexcept
+        : _handle{h}
+    {}
+
+    AsyncGenerator(AsyncGenerator&& that) noexcept
+        : _handle{std::exchange(that._handle, nullptr)}
+    {}
+
+    AsyncGenerator& operator=(AsyncGenerator&& that) noexcept {
+        std::swap(_handle, that._handle);
+        return *this;
+    }
+
+    ~AsyncGenerator() noexcept {
+        if (_handle) {
+            _handle.destroy();
+        }
+    }
+
+    /**
+     * @brief 运行到下一个 co_yield
+     * @return auto 等待结果为 std::optional<T>, 生成器结束时为空; 协程体内的异常会在此重新抛出
+     */
+    auto next() noexcept {
+        struct [[nodiscard]] NextAwaiter {
+            bool await_ready() const noexcept {
+                return !_handle || _handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> previous) const noexcept {
+                _handle.promise()._previous = previous;
+                _handle.promise()._value.reset();
+                return _handle;
+            }
+
+            std::optional<T> await_resume() const {
+                if (!_handle) [[unlikely]] {
+                    return {};
+                }
+                auto& promise = _handle.promise();
+                if (promise._exception) [[unlikely]] {
+                    std::rethrow_exception(std::exchange(promise._exception, nullptr));
+                }
+                if (_handle.done()) {
+                    return {};
+                }
+                return std::move(promise._value);
+            }
+
+            std::coroutine_handle<promise_type> _handle;
+        };
+        return NextAwaiter{_handle};
+    }
+private:
+    std::coroutine_handle<promise_type> _handle;
+};
+
+} // namespace HX::coroutine
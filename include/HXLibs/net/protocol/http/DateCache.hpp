@@ -0,0 +1,120 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 18:42:16
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ctime>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <stop_token>
+
+#include <HXLibs/coroutine/task/RootTask.hpp>
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+#include <HXLibs/utils/StringUtils.hpp>
+
+namespace HX::net {
+
+/**
+ * @brief 默认响应头 (`Connection`, `Server`, `Date`) 的缓存, 预先拼接好, 生成响应头时只需要一次拷贝
+ * @note 每个线程一个 (见 local()), 即每个事件循环一个, 因此不需要加锁.
+ *       `Date` 由 autoRefresh() 在定时器中每秒刷新; 没有启动它时 (如不在 HttpServer 中使用), 每次获取时检查是否过期
+ */
+class DateCache {
+public:
+    DateCache()
+        : _headers{}
+        , _sec{-1}
+        , _refresherNum{}
+    {
+        _update(std::time(nullptr));
+    }
+
+    DateCache& operator=(DateCache&&) noexcept = delete;
+
+    /**
+     * @brief 获取当前线程 (事件循环) 的缓存
+     * @return DateCache&
+     */
+    static DateCache& local() {
+        thread_local DateCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief 获取默认响应头, 每个都以 `\r\n` 结尾
+     * @return std::string_view 在下一次刷新之前有效
+     */
+    std::string_view getHeaders() {
+        if (!_refresherNum) [[unlikely]] {
+            _update(std::time(nullptr));
+        }
+        return _headers;
+    }
+
+    /**
+     * @brief 获取 `Date` 响应头 (以 `\r\n` 结尾)
+     * @return std::string_view 在下一次刷新之前有效
+     */
+    std::string_view getDateHeader() {
+        return getHeaders().substr(kDateHeaderPos);
+    }
+
+    /**
+     * @brief 在事件循环的定时器中, 于每秒开始时刷新 `Date`, 直到 token 请求停止
+     * @param loop 当前线程的事件循环
+     * @param token
+     * @return coroutine::RootTask<> 需要 detach()
+     */
+    coroutine::RootTask<> autoRefresh(coroutine::EventLoop& loop, std::stop_token token) {
+        ++_refresherNum;
+        while (!token.stop_requested()) {
+            _update(std::time(nullptr));
+            auto next = std::chrono::ceil<std::chrono::seconds>(std::chrono::system_clock::now());
+            if (co_await loop.cancelable(loop.makeTimer().sleepUntil(next), token) < 0) {
+                break;
+            }
+        }
+        --_refresherNum;
+    }
+
+private:
+    inline static constexpr std::string_view kConstantHeaders{
+        "Connection: keep-alive\r\n"
+        "Server: HXLibs::net\r\n"
+    };
+    inline static constexpr std::size_t kDateHeaderPos = kConstantHeaders.size();
+
+    void _update(std::time_t sec) {
+        if (sec == _sec) [[likely]] {
+            return;
+        }
+        _sec = sec;
+        _headers.clear();
+        _headers += kConstantHeaders;
+        _headers += "Date: ";
+        _headers += utils::DateTimeFormat::makeHttpDate();
+        _headers += "\r\n";
+    }
+
+    std::string _headers;       // 默认响应头
+    std::time_t _sec;           // _headers 中 `Date` 对应的时间 (秒)
+    std::size_t _refresherNum;  // 正在运行的 autoRefresh() 个数
+};
+
+} // namespace HX::net
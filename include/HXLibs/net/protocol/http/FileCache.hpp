@@ -0,0 +1,350 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 15:08:44
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <list>
+#include <ctime>
+#include <cstdio>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <filesystem>
+#include <system_error>
+
+#include <HXLibs/platform/LocalFdApi.hpp>
+#include <HXLibs/net/protocol/http/Http.hpp>
+#include <HXLibs/coroutine/task/Task.hpp>
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+#include <HXLibs/utils/FileUtils.hpp>
+
+namespace HX::net {
+
+/**
+ * @brief 已打开的文件及其元数据 (只读, 由 FileCache 共享)
+ * @note 最后一个持有者释放时关闭文件; 因此即便已经被缓存淘汰, 正在发送的响应仍然可以继续使用
+ */
+struct CachedFile {
+    explicit CachedFile(platform::LocalFdType fd_) noexcept
+        : fd{fd_}
+        , size{}
+        , mtime{}
+        , mtimeNsec{}
+        , ino{}
+        , isRegular{false}
+        , etag{}
+        , lastModified{}
+    {}
+
+    CachedFile& operator=(CachedFile&&) noexcept = delete;
+
+    ~CachedFile() noexcept {
+#if defined(__linux__)
+        ::close(fd);
+#elif defined(_WIN32)
+        ::CloseHandle(fd);
+#endif
+    }
+
+    /**
+     * @brief 根据 size 与 mtime 生成 ETag 与 Last-Modified
+     */
+    void buildValidators() {
+        char buf[64];
+        int n = std::snprintf(buf, sizeof(buf), "\"%llx-%llx\"",
+            static_cast<unsigned long long>(mtime), static_cast<unsigned long long>(size));
+        etag.assign(buf, static_cast<std::size_t>(n));
+        std::time_t t = static_cast<std::time_t>(mtime);
+        std::tm tm{};
+#if defined(_WIN32)
+        ::gmtime_s(&tm, &t);
+#else
+        ::gmtime_r(&t, &tm);
+#endif
+        // C locale 下为 RFC 7231 的 IMF-fixdate, 如 `Sun, 06 Nov 1994 08:49:37 GMT`
+        lastModified.assign(buf, std::strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &tm));
+    }
+
+    platform::LocalFdType fd;
+    uint64_t size;
+    int64_t mtime;          // 修改时间 (秒)
+    uint32_t mtimeNsec;     // 修改时间 (纳秒部分)
+    uint64_t ino;
+    bool isRegular;         // 是否为普通文件 (只缓存普通文件)
+    std::string etag;
+    std::string lastModified;
+};
+
+/**
+ * @brief 静态文件的打开文件缓存 (fd + 元数据), 使热门文件不必每次都 open + stat + close
+ * @note 每个线程一个 (见 local()), 即每个事件循环一个, 因此不需要加锁.
+ *       LRU 淘汰; 每次命中都会用 fd 检查大小与修改时间 (原地截断或改写时重新打开);
+ *       超过 ttl 的条目在下一次命中时再用异步 statx 按路径重新验证, 文件变化 (大小、修改时间、inode) 时重新打开.
+ *       大小为 0 的文件 (如 /proc 下的虚拟文件) 与非普通文件不会被缓存.
+ *       Windows 下不缓存, 每次都重新打开 (元数据为同步获取)
+ * @warning 路径在 ttl 之内被替换为另一个文件 (如 rename), 仍然会返回旧的文件;
+ *          检查之后、发送期间才被截断的文件, 发送时会抛出异常 (响应头已经发出, 连接会被关闭)
+ */
+class FileCache {
+    using Clock = std::chrono::steady_clock;
+
+    struct Node {
+        std::string path;
+        std::shared_ptr<CachedFile const> file;
+        Clock::time_point checkedAt;
+    };
+public:
+    FileCache() noexcept
+        : _lru{}
+        , _map{}
+        , _maxSize{kDefaultMaxSize}
+        , _ttl{kDefaultTtl}
+    {}
+
+    FileCache& operator=(FileCache&&) noexcept = delete;
+
+    /**
+     * @brief 获取当前线程 (事件循环) 的缓存
+     * @return FileCache&
+     */
+    static FileCache& local() noexcept {
+        thread_local FileCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief 设置最多缓存的文件数 (每个缓存的文件占用一个 fd); 0 为不缓存
+     * @param size
+     * @return FileCache&
+     */
+    FileCache& setMaxSize(std::size_t size) {
+        _maxSize = size;
+        _evict();
+        return *this;
+    }
+
+    /**
+     * @brief 设置条目的有效期, 过期后需要重新验证
+     * @param ttl
+     * @return FileCache&
+     */
+    FileCache& setTtl(std::chrono::milliseconds ttl) noexcept {
+        _ttl = ttl;
+        return *this;
+    }
+
+    /**
+     * @brief 清空缓存 (正在被使用的文件, 在最后一个持有者释放时关闭)
+     */
+    void clear() noexcept {
+        _map.clear();
+        _lru.clear();
+    }
+
+    std::size_t size() const noexcept {
+        return _lru.size();
+    }
+
+    /**
+     * @brief 以只读方式打开文件, 优先使用缓存
+     * @param loop 当前线程的事件循环
+     * @param path 文件路径
+     * @return coroutine::Task<std::shared_ptr<CachedFile const>>
+     * @throw 文件不存在等打开失败时, 抛出 std::system_error
+     */
+    coroutine::Task<std::shared_ptr<CachedFile const>> open(
+        coroutine::EventLoop& loop,
+        std::string_view path
+    ) {
+        auto now = Clock::now();
+        std::string key; // 之后会挂起, 也需要以 '\0' 结尾; 命中时不需要, 因此按需拷贝
+        if (auto it = _map.find(path); it != _map.end()) {
+            auto node = it->second;
+            _lru.splice(_lru.begin(), _lru, node);
+            auto file = node->file;
+            if (now - node->checkedAt < _ttl) [[likely]] {
+                if (_isFdUnchanged(*file)) [[likely]] {
+                    co_return file;
+                }
+                _erase(path, file.get());
+            } else {
+                // 过期: 挂起期间节点可能被淘汰或者替换, 因此之后要重新查找
+                key.assign(path);
+                if (co_await _isUnchanged(loop, key, *file)) {
+                    if (auto jt = _map.find(key); jt != _map.end() && jt->second->file == file) {
+                        jt->second->checkedAt = now;
+                    }
+                    co_return file;
+                }
+                _erase(key, file.get());
+            }
+        }
+        key.assign(path);
+        auto file = co_await _open(loop, key);
+        if (file->isRegular && file->size && _maxSize) {
+            _erase(key, nullptr);
+            _lru.push_front({std::move(key), file, now});
+            _map.emplace(_lru.front().path, _lru.begin());
+            _evict();
+        }
+        co_return file;
+    }
+
+private:
+    inline static constexpr std::size_t kDefaultMaxSize = 256; // 不要太多, 默认的 RLIMIT_NOFILE 只有 1024
+    inline static constexpr std::chrono::milliseconds kDefaultTtl{1000};
+
+#if defined(__linux__)
+    inline static constexpr unsigned int kStatxMask = STATX_TYPE | STATX_SIZE | STATX_MTIME | STATX_INO;
+
+    static void _fill(CachedFile& file, struct ::statx const& stx) {
+        file.size = stx.stx_size;
+        file.mtime = stx.stx_mtime.tv_sec;
+        file.mtimeNsec = stx.stx_mtime.tv_nsec;
+        file.ino = stx.stx_ino;
+        file.isRegular = S_ISREG(stx.stx_mode);
+        file.buildValidators();
+    }
+#endif
+
+    /**
+     * @brief 打开文件并获取元数据
+     */
+    static coroutine::Task<std::shared_ptr<CachedFile const>> _open(
+        coroutine::EventLoop& loop,
+        std::string const& path
+    ) {
+#if defined(__linux__)
+        auto file = std::make_shared<CachedFile>(HXLIBS_CHECK_EVENT_LOOP(
+            co_await loop.makeAioTask().prepOpenat(
+                AT_FDCWD, path.c_str(), static_cast<int>(utils::OpenMode::Read), 0)
+        ));
+        // 已经打开的文件, inode 已在内存中, 同步 statx 不会阻塞在磁盘上;
+        // 而 io_uring 的 statx 总是交给 io-wq 线程执行, 反而更慢
+        struct ::statx stx{};
+        if (::statx(file->fd, "", AT_EMPTY_PATH, kStatxMask, &stx) < 0) [[unlikely]] {
+            throw std::system_error(errno, std::system_category());
+        }
+        _fill(*file, stx);
+        co_return file;
+#elif defined(_WIN32)
+        (void)loop;
+        auto params =
+            platform::Win32FileParamsBuilder(utils::OpenMode::Read).enableIocp(true)
+                                                                  .build();
+        HANDLE fileHandle = ::CreateFileA(
+            path.c_str(),
+            params.access,
+            platform::Win32FileParams::shareMode,
+            nullptr,
+            params.creation,
+            params.flags,
+            nullptr
+        );
+        if (fileHandle == INVALID_HANDLE_VALUE) [[unlikely]] {
+            throw std::system_error(
+                static_cast<int>(::GetLastError()),
+                std::system_category(),
+                "CreateFileA failed"
+            );
+        }
+        auto file = std::make_shared<CachedFile>(fileHandle);
+        file->size = std::filesystem::file_size(path);
+        file->mtime = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::file_clock::to_sys(std::filesystem::last_write_time(path)).time_since_epoch()
+        ).count();
+        file->buildValidators(); // isRegular 为 false, 不缓存
+        co_return file;
+#else
+        #error "Unsupported platform"
+#endif
+    }
+
+    /**
+     * @brief 重新验证: 路径对应的文件是否还是同一个, 并且没有被修改
+     */
+    static coroutine::Task<bool> _isUnchanged(
+        [[maybe_unused]] coroutine::EventLoop& loop,
+        [[maybe_unused]] std::string const& path,
+        [[maybe_unused]] CachedFile const& file
+    ) {
+#if defined(__linux__)
+        struct ::statx stx{};
+        int res = co_await loop.makeAioTask().prepStatx(AT_FDCWD, path.c_str(), 0, kStatxMask, &stx);
+        co_return res >= 0
+            && stx.stx_ino == file.ino
+            && stx.stx_size == file.size
+            && stx.stx_mtime.tv_sec == file.mtime
+            && stx.stx_mtime.tv_nsec == file.mtimeNsec;
+#else
+        co_return false;
+#endif
+    }
+
+    /**
+     * @brief 用已经打开的 fd 检查文件是否被原地修改 (截断、改写)
+     * @note 不经过路径查找, inode 已在内存中, 同步 statx 很便宜
+     */
+    static bool _isFdUnchanged([[maybe_unused]] CachedFile const& file) noexcept {
+#if defined(__linux__)
+        struct ::statx stx{};
+        return ::statx(file.fd, "", AT_EMPTY_PATH, STATX_SIZE | STATX_MTIME, &stx) == 0
+            && stx.stx_size == file.size
+            && stx.stx_mtime.tv_sec == file.mtime
+            && stx.stx_mtime.tv_nsec == file.mtimeNsec;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief 删除条目
+     * @param file 非空时, 只有条目还是这个文件才删除
+     */
+    void _erase(std::string_view path, CachedFile const* file) noexcept {
+        if (auto it = _map.find(path); it != _map.end() && (!file || it->second->file.get() == file)) {
+            auto node = it->second;
+            _map.erase(it);
+            _lru.erase(node);
+        }
+    }
+
+    /**
+     * @brief 淘汰最久未使用的条目, 直到不超过 _maxSize
+     */
+    void _evict() noexcept {
+        while (_lru.size() > _maxSize) {
+            _map.erase(_lru.back().path);
+            _lru.pop_back();
+        }
+    }
+
+    std::list<Node> _lru; // 最近使用的在前
+    std::unordered_map<
+        std::string_view, // 指向节点中的 path
+        std::list<Node>::iterator,
+        internal::TransparentStringHash,
+        internal::TransparentStringEqual
+    > _map;
+    std::size_t _maxSize;
+    std::chrono::milliseconds _ttl;
+};
+
+} // namespace HX::net
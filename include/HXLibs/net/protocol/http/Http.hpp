@@ -18,7 +18,12 @@
  * limitations under the License.
  */
 
+#include <array>
 #include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
 #include <string_view>
 #include <unordered_map>
 
@@ -102,12 +107,155 @@ using HeaderHashMap = std::unordered_map<
     internal::TransparentStringEqual
 >;
 
+/**
+ * @brief 请求头索引: 键值都是指向接收缓冲区的视图, 按出现的顺序平铺存放, 查找时键不区分大小写
+ * @note 不超过 kInlineNum 个时存放在对象内部, 不分配内存; 超过时转存到堆上, 在请求之间复用 (clear 不释放),
+ *       连接空闲时 release() 释放. 头部很少, 线性查找比哈希更快
+ * @warning 视图只在对应的请求有效期间 (req.clear() 之前) 有效
+ */
+class RequestHeaderView {
+public:
+    using value_type = std::pair<std::string_view, std::string_view>;
+    using const_iterator = value_type const*;
+    using iterator = const_iterator;
+
+    // 常见的请求 (浏览器、curl、API 客户端) 不超过 8 个请求头; 每个连接都持有一份, 空闲的连接也是
+    inline static constexpr std::size_t kInlineNum = 8;
+
+    RequestHeaderView() noexcept
+        : _inline{}
+        , _heap{}
+        , _data{_inline.data()}
+        , _size{}
+        , _cap{kInlineNum}
+    {}
+
+    RequestHeaderView& operator=(RequestHeaderView&&) noexcept = delete;
+
+    /**
+     * @brief 查找请求头 (键不区分大小写), 重复的键返回第一个
+     * @param key
+     * @return const_iterator 找不到时为 end()
+     */
+    const_iterator find(std::string_view key) const noexcept {
+        for (auto it = begin(); it != end(); ++it) {
+            if (equalsIgnoreCase(it->first, key)) {
+                return it;
+            }
+        }
+        return end();
+    }
+
+    bool contains(std::string_view key) const noexcept {
+        return find(key) != end();
+    }
+
+    /**
+     * @brief 重复的键只计一次, 与 HeaderHashMap::count 一致
+     * @return std::size_t 0 或 1
+     */
+    std::size_t count(std::string_view key) const noexcept {
+        return contains(key);
+    }
+
+    /**
+     * @brief 查找请求头 (键不区分大小写)
+     * @throw std::out_of_range 找不到时
+     */
+    std::string_view at(std::string_view key) const {
+        if (auto it = find(key); it != end()) [[likely]] {
+            return it->second;
+        }
+        throw std::out_of_range{"RequestHeaderView::at: " + std::string{key}};
+    }
+
+    const_iterator begin() const noexcept {
+        return _data;
+    }
+
+    const_iterator end() const noexcept {
+        return _data + _size;
+    }
+
+    std::size_t size() const noexcept {
+        return _size;
+    }
+
+    bool empty() const noexcept {
+        return !_size;
+    }
+
+    /**
+     * @brief 清空 (保留已经申请的内存)
+     */
+    void clear() noexcept {
+        _size = 0;
+    }
+
+    /**
+     * @brief 清空, 并且释放堆上的内存 (回到对象内部的存储)
+     */
+    void release() noexcept {
+        _size = 0;
+        if (!_heap.empty()) [[unlikely]] {
+            _heap = {};
+            _data = _inline.data();
+            _cap = kInlineNum;
+        }
+    }
+
+    void emplace(std::string_view key, std::string_view val) {
+        if (_size == _cap) [[unlikely]] {
+            _grow();
+        }
+        _data[_size++] = {key, val};
+    }
+
+    /**
+     * @brief 最后一个请求头 (用于拼接折叠的行)
+     * @warning 需要非空
+     */
+    value_type& back() noexcept {
+        return _data[_size - 1];
+    }
+
+    static constexpr char toLower(char c) noexcept {
+        return static_cast<unsigned char>(c - 'A') < 26 ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    static constexpr bool equalsIgnoreCase(std::string_view lhs, std::string_view rhs) noexcept {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < lhs.size(); ++i) {
+            if (toLower(lhs[i]) != toLower(rhs[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+private:
+    void _grow() {
+        std::vector<value_type> heap(_cap * 2);
+        std::copy_n(_data, _size, heap.begin());
+        _heap = std::move(heap);
+        _data = _heap.data();
+        _cap = _heap.size();
+    }
+
+    std::array<value_type, kInlineNum> _inline;
+    std::vector<value_type> _heap;
+    value_type* _data;
+    std::size_t _size;
+    std::size_t _cap;
+};
+
 /**
  * @brief 断点续传参数包
  */
 struct RangeRequestView {
     std::string_view reqType; // 请求类型
-    HeaderHashMap const& reqHead;  // 请求头
+    RequestHeaderView const& reqHead;  // 请求头
 };
 
 } // namespace HX::net
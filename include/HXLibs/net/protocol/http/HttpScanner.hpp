@@ -0,0 +1,472 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 16:21:09
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <bit>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+#include <system_error>
+
+// x86 上使用 SSE4.2 / AVX2 (运行时按 CPU 选择), 其他平台与编译器使用标量实现
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define HX_HTTP_SCAN_SIMD 1
+    #include <immintrin.h>
+#else
+    #define HX_HTTP_SCAN_SIMD 0
+#endif
+
+namespace HX::net::internal {
+
+/**
+ * @brief 扫描时使用的指令集
+ */
+enum class SimdLevel {
+    Scalar,
+    Sse42,
+    Avx2,
+};
+
+inline SimdLevel detectSimdLevel() noexcept {
+#if HX_HTTP_SCAN_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return SimdLevel::Sse42;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+/**
+ * @brief 当前使用的指令集 (首次使用时检测 CPU)
+ * @warning 可以改为更低的级别以便对比测试, 但是只应在启动时修改
+ */
+inline SimdLevel& simdLevel() noexcept {
+    static SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+/**
+ * @brief RFC 9110 的 tchar 转为小写; 不是 tchar 的为 0
+ */
+inline constexpr std::array<char, 256> kTokenLowerTable = [] {
+    std::array<char, 256> table{};
+    for (int c = '0'; c <= '9'; ++c) {
+        table[static_cast<std::size_t>(c)] = static_cast<char>(c);
+    }
+    for (int c = 'a'; c <= 'z'; ++c) {
+        table[static_cast<std::size_t>(c)] = static_cast<char>(c);
+        table[static_cast<std::size_t>(c - 'a' + 'A')] = static_cast<char>(c);
+    }
+    for (char c : std::string_view{"!#$%&'*+-.^_`|~"}) {
+        table[static_cast<unsigned char>(c)] = c;
+    }
+    return table;
+}();
+
+inline constexpr bool isTokenChar(char c) noexcept {
+    return kTokenLowerTable[static_cast<unsigned char>(c)];
+}
+
+/**
+ * @brief 原地把 token (如请求头的键) 转为小写, 同时校验它是否全部为 tchar
+ * @param p
+ * @param n
+ * @return 是否为合法的 token (非空且全部为 tchar)
+ */
+inline bool toLowerToken(char* p, std::size_t n) noexcept {
+    char bad = !n;
+    for (std::size_t i = 0; i < n; ++i) {
+        char c = kTokenLowerTable[static_cast<unsigned char>(p[i])];
+        bad |= !c;
+        p[i] = c;
+    }
+    return !bad;
+}
+
+/**
+ * @brief 一行 (不包含结尾的 `\r\n`)
+ */
+struct HeaderLine {
+    std::size_t begin;  // 行首
+    std::size_t colon;  // 行中第一个 ':' 的位置, 没有时为 npos
+    std::size_t end;    // 行尾, 即 '\r' 的位置
+};
+
+#if HX_HTTP_SCAN_SIMD
+// ===== 一次遍历, 把行尾 ('\r' 或 '\n') 与 ':' 的位置分别记录为位图 =====
+// 每 64 个字节对应每种字符一个 uint64_t, 第 i 位为 1 表示第 i 个字节是该字符
+
+/**
+ * @brief 行尾 ('\r' 或 '\n') 与 ':' 各自的位图
+ */
+struct StructuralMasks {
+    uint64_t* eol;
+    uint64_t* colon;
+};
+
+__attribute__((target("sse4.2")))
+inline void structuralMaskSse42(char const* p, std::size_t words, StructuralMasks out) noexcept {
+    __m128i const cr = _mm_set1_epi8('\r');
+    __m128i const lf = _mm_set1_epi8('\n');
+    __m128i const colon = _mm_set1_epi8(':');
+    for (std::size_t w = 0; w < words; ++w, p += 64) {
+        uint64_t eolMask = 0, colonMask = 0;
+        for (int k = 0; k < 4; ++k) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p + 16 * k));
+            __m128i eol = _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf));
+            eolMask |= static_cast<uint64_t>(
+                static_cast<uint32_t>(_mm_movemask_epi8(eol))) << (16 * k);
+            colonMask |= static_cast<uint64_t>(
+                static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, colon)))) << (16 * k);
+        }
+        out.eol[w] = eolMask;
+        out.colon[w] = colonMask;
+    }
+}
+
+__attribute__((target("avx2")))
+inline void structuralMaskAvx2(char const* p, std::size_t words, StructuralMasks out) noexcept {
+    __m256i const cr = _mm256_set1_epi8('\r');
+    __m256i const lf = _mm256_set1_epi8('\n');
+    __m256i const colon = _mm256_set1_epi8(':');
+    for (std::size_t w = 0; w < words; ++w, p += 64) {
+        uint64_t eolMask = 0, colonMask = 0;
+        for (int k = 0; k < 2; ++k) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p + 32 * k));
+            __m256i eol = _mm256_or_si256(_mm256_cmpeq_epi8(v, cr), _mm256_cmpeq_epi8(v, lf));
+            eolMask |= static_cast<uint64_t>(
+                static_cast<uint32_t>(_mm256_movemask_epi8(eol))) << (32 * k);
+            colonMask |= static_cast<uint64_t>(
+                static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, colon)))) << (32 * k);
+        }
+        out.eol[w] = eolMask;
+        out.colon[w] = colonMask;
+    }
+}
+
+/**
+ * @brief 计算 [p, p + n) 的位图 (不会越界读取)
+ * @note 不足 64 字节的尾部: 如果前面还有数据, 则重叠地计算最后 64 个字节再移位; 否则补 0 后计算
+ * @return std::size_t 每种位图写入的个数
+ */
+inline std::size_t structuralMask(char const* p, std::size_t n, StructuralMasks out) noexcept {
+    auto const impl = simdLevel() == SimdLevel::Avx2
+        ? structuralMaskAvx2
+        : structuralMaskSse42;
+    std::size_t const words = n / 64;
+    std::size_t const rem = n % 64;
+    impl(p, words, out);
+    if (!rem) {
+        return words;
+    }
+    StructuralMasks tailOut{out.eol + words, out.colon + words};
+    if (words) {
+        // 最后一个是 [n - 64, n), 右移去掉与前面重叠的部分
+        impl(p + n - 64, 1, tailOut);
+        *tailOut.eol >>= 64 - rem;
+        *tailOut.colon >>= 64 - rem;
+    } else {
+        alignas(64) char tail[64]{};
+        std::memcpy(tail, p, rem);
+        impl(tail, 1, tailOut);
+    }
+    return words + 1;
+}
+#endif // HX_HTTP_SCAN_SIMD
+
+/**
+ * @brief 按行 (以 `\r\n` 结尾) 切分请求头/响应头, 同时找出每行第一个 ':'
+ * @note 支持 SIMD 时, 每次对 (从行首开始的) 1 KiB 的数据一次遍历求出行尾 ('\r' 或 '\n') 与 ':' 的位图,
+ *       每行只需在位图中找两次下一个置位 (行尾与 ':'), 行尾是 '\n' 即为单独的 '\n', 没有逐字符的分支;
+ *       否则 (SimdLevel::Scalar, 或者数据不足 kSimdMinBytes) 逐行使用 memchr 查找行尾的 `\r\n`、行内的 '\r' 与 ':'.
+ *       两种实现都把单独的 '\r' 或 '\n' 视为错误 (RFC 9112 2.2)
+ *       用法: `for (HeaderLine line; scanner.next(line);) { ... }`, 之后检查 isError() 与 pos()
+ * @warning 遍历期间可以修改数据, 但是不能修改当前行之后的 '\r' '\n' ':'
+ */
+class LineScanner {
+public:
+    /**
+     * @param buf 数据
+     * @param pos 开始位置, 需要是行首
+     */
+    LineScanner(std::string_view buf, std::size_t pos) noexcept
+        : _buf{buf}
+        , _lineBegin{pos}
+#if HX_HTTP_SCAN_SIMD
+        , _blockPos{pos}
+        , _blockEnd{pos}
+        , _words{}
+        , _isSimd{simdLevel() != SimdLevel::Scalar && buf.size() - pos >= kSimdMinBytes}
+#endif
+        , _isError{false}
+    {}
+
+    LineScanner& operator=(LineScanner&&) noexcept = delete;
+
+    /**
+     * @brief 切分出下一个完整的行
+     * @param line [out]
+     * @return false 没有完整的行了 (数据不完整), 或者出错 (isError())
+     */
+    bool next(HeaderLine& line) noexcept {
+#if HX_HTTP_SCAN_SIMD
+        if (_isSimd) [[likely]] {
+            return _nextSimd(line);
+        }
+#endif
+        return _nextScalar(line);
+    }
+
+    /**
+     * @brief 下一个没有处理的行的行首 (数据不完整时, 即最后那个不完整的行)
+     */
+    std::size_t pos() const noexcept {
+        return _lineBegin;
+    }
+
+    bool isError() const noexcept {
+        return _isError;
+    }
+private:
+    bool _nextScalar(HeaderLine& line) noexcept {
+        // 第一个 '\n' 一定是行尾, 因此它前面不是 '\r' 时就是单独的 '\n';
+        // 行内 (行尾的 `\r\n` 之前) 还有 '\r' 时就是单独的 '\r'
+        std::size_t const lf = _buf.find('\n', _lineBegin);
+        if (lf == std::string_view::npos) {
+            return false;
+        }
+        if (lf == _lineBegin || _buf[lf - 1] != '\r') [[unlikely]] {
+            _isError = true;
+            return false;
+        }
+        std::size_t const cr = lf - 1;
+        std::string_view const content = _buf.substr(_lineBegin, cr - _lineBegin);
+        if (content.find('\r') != std::string_view::npos) [[unlikely]] {
+            _isError = true;
+            return false;
+        }
+        std::size_t const colon = content.find(':');
+        line = {_lineBegin, colon == std::string_view::npos ? colon : _lineBegin + colon, cr};
+        _lineBegin = lf + 1;
+        return true;
+    }
+
+#if HX_HTTP_SCAN_SIMD
+    inline static constexpr std::size_t kBlockWords = 16; // 每次计算 1 KiB 的位图
+    // 数据太短时, 计算位图的开销比逐行 memchr 更大 (只有一两个请求头的请求)
+    inline static constexpr std::size_t kSimdMinBytes = 256;
+
+    bool _nextSimd(HeaderLine& line) noexcept {
+        std::size_t colon = std::string_view::npos;
+        // 超过一块的长行会跨越多块, 之前的块中已经找过 ':' 与单独的 '\n'
+        for (std::size_t from = _lineBegin;; from = _blockEnd) {
+            if (from >= _blockEnd) {
+                if (from >= _buf.size()) {
+                    return false;
+                }
+                _loadBlock(from);
+            }
+            std::size_t const cr = _findBit(_eolMasks, from);
+            if (colon == std::string_view::npos) {
+                if (std::size_t const c = _findBit(_colonMasks, from); c < cr) {
+                    colon = c;
+                }
+            }
+            if (cr == std::string_view::npos) {
+                continue;
+            }
+            if (_buf[cr] != '\r') [[unlikely]] {
+                _isError = true; // 单独的 '\n'
+                return false;
+            }
+            if (cr + 1 == _buf.size()) {
+                return false; // '\n' 还没有读到
+            }
+            if (_buf[cr + 1] != '\n') [[unlikely]] {
+                _isError = true; // 单独的 '\r'
+                return false;
+            }
+            line = {_lineBegin, colon, cr};
+            _lineBegin = cr + 2;
+            return true;
+        }
+    }
+
+    /**
+     * @brief 计算从 pos 开始的一块的位图
+     */
+    void _loadBlock(std::size_t pos) noexcept {
+        std::size_t const n = std::min(_buf.size() - pos, kBlockWords * 64);
+        _blockPos = pos;
+        _blockEnd = pos + n;
+        _words = structuralMask(_buf.data() + pos, n, {_eolMasks.data(), _colonMasks.data()});
+    }
+
+    /**
+     * @brief 在当前块的位图中查找 pos (含) 之后的第一个置位
+     * @return std::size_t 在 _buf 中的下标, 没有时为 npos
+     */
+    std::size_t _findBit(std::array<uint64_t, kBlockWords> const& masks, std::size_t pos) const noexcept {
+        std::size_t const rel = pos - _blockPos;
+        std::size_t word = rel / 64;
+        if (word >= _words) {
+            return std::string_view::npos;
+        }
+        uint64_t mask = masks[word] & (~uint64_t{0} << (rel % 64));
+        while (!mask) {
+            if (++word == _words) {
+                return std::string_view::npos;
+            }
+            mask = masks[word];
+        }
+        return _blockPos + word * 64 + static_cast<std::size_t>(std::countr_zero(mask));
+    }
+
+    std::string_view _buf;
+    std::size_t _lineBegin;
+    // 按块写入后才读取, 因此不在构造时清零
+    std::array<uint64_t, kBlockWords> _eolMasks;
+    std::array<uint64_t, kBlockWords> _colonMasks;
+    std::size_t _blockPos;  // 当前位图对应的数据开始位置
+    std::size_t _blockEnd;
+    std::size_t _words;     // 当前块每种位图的个数
+    bool _isSimd;
+#else
+    std::string_view _buf;
+    std::size_t _lineBegin;
+#endif // HX_HTTP_SCAN_SIMD
+    bool _isError;
+};
+
+// ===== 请求目标 (request-target) 的校验 =====
+
+/**
+ * @brief 找出第一个控制字符或空格 ([0x00, 0x20] 与 0x7F); 允许 0x80 以上的字节 (如 UTF-8 路径)
+ * @return std::size_t 下标, 没有时为 n
+ */
+inline std::size_t findNonVisibleScalar(char const* p, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        auto const c = static_cast<unsigned char>(p[i]);
+        if (c <= 0x20 || c == 0x7F) {
+            return i;
+        }
+    }
+    return n;
+}
+
+#if HX_HTTP_SCAN_SIMD
+__attribute__((target("sse4.2")))
+inline std::size_t findNonVisibleSse42(char const* p, std::size_t n) noexcept {
+    // PCMPESTRI 的范围比较: [0x00, 0x20] 与 [0x7F, 0x7F]
+    alignas(16) static constexpr char kRanges[16] = {'\x00', '\x20', '\x7f', '\x7f'};
+    __m128i const ranges = _mm_load_si128(reinterpret_cast<__m128i const*>(kRanges));
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p + i));
+        int idx = _mm_cmpestri(ranges, 4, v, 16,
+            _SIDD_LEAST_SIGNIFICANT | _SIDD_CMP_RANGES | _SIDD_UBYTE_OPS);
+        if (idx != 16) {
+            return i + static_cast<std::size_t>(idx);
+        }
+    }
+    return i + findNonVisibleScalar(p + i, n - i);
+}
+
+__attribute__((target("avx2")))
+inline std::size_t findNonVisibleAvx2(char const* p, std::size_t n) noexcept {
+    // 有符号比较: [0x00, 0x20] 即 -1 < c < 0x21
+    __m256i const lo = _mm256_set1_epi8(-1);
+    __m256i const hi = _mm256_set1_epi8(0x21);
+    __m256i const del = _mm256_set1_epi8(0x7F);
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p + i));
+        __m256i bad = _mm256_or_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi8(v, lo), _mm256_cmpgt_epi8(hi, v)),
+            _mm256_cmpeq_epi8(v, del)
+        );
+        if (auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(bad))) {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + findNonVisibleScalar(p + i, n - i);
+}
+#endif // HX_HTTP_SCAN_SIMD
+
+inline std::size_t findNonVisible(char const* p, std::size_t n) noexcept {
+#if HX_HTTP_SCAN_SIMD
+    switch (simdLevel()) {
+    case SimdLevel::Avx2:
+        return findNonVisibleAvx2(p, n);
+    case SimdLevel::Sse42:
+        return findNonVisibleSse42(p, n);
+    default:
+        break;
+    }
+#endif
+    return findNonVisibleScalar(p, n);
+}
+
+/**
+ * @brief 严格解析 `Content-Length` 的值: 只能是十进制数字, 需要全部消耗, 不能溢出
+ * @param val 请求头的值 (已经去掉两端的空白)
+ * @return std::optional<std::size_t> 不合法 (如 `+1`, `1,1`, ` 1 2`, 空串) 时为空
+ */
+inline std::optional<std::size_t> parseContentLength(std::string_view val) noexcept {
+    std::size_t n{};
+    auto [ptr, ec] = std::from_chars(val.data(), val.data() + val.size(), n);
+    if (ptr == val.data() || ec != std::errc{} || ptr != val.data() + val.size()) [[unlikely]] {
+        return std::nullopt;
+    }
+    return n;
+}
+
+/**
+ * @brief 严格解析分块大小行: `1*HEXDIG [ BWS ";" chunk-ext ]` (RFC 9112 7.1), 分块扩展忽略
+ * @param line 不包含 `\r\n`
+ * @return std::optional<std::size_t> 不合法 (如 `0x10`, `-1`, 溢出, 空行) 时为空
+ */
+inline std::optional<std::size_t> parseChunkSize(std::string_view line) noexcept {
+    std::size_t n{};
+    char const* const end = line.data() + line.size();
+    auto [ptr, ec] = std::from_chars(line.data(), end, n, 16);
+    if (ptr == line.data() || ec != std::errc{}) [[unlikely]] {
+        return std::nullopt;
+    }
+    if (ptr == end) [[likely]] {
+        return n;
+    }
+    while (ptr != end && (*ptr == ' ' || *ptr == '\t')) {
+        ++ptr;
+    }
+    if (ptr == end || *ptr != ';') [[unlikely]] {
+        return std::nullopt;
+    }
+    return n;
+}
+
+} // namespace HX::net::internal
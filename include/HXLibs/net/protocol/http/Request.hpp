@@ -18,12 +18,17 @@
  * limitations under the License.
  * */
 
+#include <array>
+#include <algorithm>
 #include <vector>
 #include <optional>
 #include <stdexcept>
+#include <exception>
+#include <type_traits>
 
-#include <HXLibs/container/ArrayBuf.hpp>
 #include <HXLibs/net/protocol/http/Http.hpp>
+#include <HXLibs/net/protocol/http/Status.hpp>
+#include <HXLibs/net/protocol/http/HttpScanner.hpp>
 #include <HXLibs/net/socket/IO.hpp>
 #include <HXLibs/utils/FileUtils.hpp>
 #include <HXLibs/utils/StringUtils.hpp>
@@ -33,6 +38,23 @@
 
 namespace HX::net {
 
+/**
+ * @brief 路由匹配时捕获的路径参数, 均为指向请求行的视图
+ * @note 定长数组, 匹配时不需要申请内存; 因此一个路由模版最多只能有 kMaxParamNum 个`{val}`
+ */
+struct PathParams {
+    inline static constexpr std::size_t kMaxParamNum = 16;
+
+    // 路径变量, 如`/home/{id}`的`id`
+    std::array<std::string_view, kMaxParamNum> params{};
+
+    // 路径变量的个数
+    std::size_t paramNum{};
+
+    // 通配符`/**`的结果
+    std::string_view wildcard{};
+};
+
 /**
  * @brief 请求类(Request)
  */
@@ -41,10 +63,15 @@ public:
     explicit Request(IO& io) 
         : _recvBuf()
         , _requestLine()
+        , _requestLineView()
         , _requestHeaders()
-        , _requestHeadersIt(_requestHeaders.end())
+        , _headersView()
         , _body()
         , _remainingBodyLen(std::nullopt)
+        , _headerScanPos{}
+        , _chunkState{ChunkState::Size}
+        , _parseError{}
+        , _pathParams{}
         , _io{io}
         , _boundary{}
     {}
@@ -157,6 +184,9 @@ public:
         _requestLine[RequestLineDataType::RequestType] = getMethodStringView(Method);
         _requestLine[RequestLineDataType::RequestPath] = path;
         _requestLine[RequestLineDataType::ProtocolVersion] = "HTTP/1.1";
+        for (std::size_t i = 0; i < _requestLine.size(); ++i) {
+            _requestLineView[i] = _requestLine[i];
+        }
         return *this;
     }
 
@@ -237,17 +267,31 @@ public:
 
     // ===== ↓服务端使用↓ =====
     /**
-     * @brief 解析请求
-     * @return coroutine::Task<bool> 断开连接则为false, 解析成功为true
+     * @brief 解析请求 (请求行与请求头都是指向接收缓冲区的视图, 缓冲区在 clear() 之前不会被归还)
+     * @note 接收缓冲区中已经有数据 (流水线中已经到达的请求) 时, 先解析它们, 不完整才读取
+     * @return coroutine::Task<bool> 断开连接 (或者请求头过大、不合法) 则为false, 解析成功为true;
+     *         请求不合法时, 应该回复的错误码记录在 _parseError 中
      */
     template <typename Timeout>
         requires(utils::HasTimeNTTP<Timeout>)
     coroutine::Task<bool> parserReq() {
-        for (std::size_t n = IO::kBufMaxSize; n; n = std::min(_parserReq(), IO::kBufMaxSize)) {
-            auto res = co_await _io.recvLinkTimeout<Timeout>(
-                // 保留原有的数据
-                {_recvBuf.data() + _recvBuf.size(),  _recvBuf.data() + n}
-            );
+        if (_completeRequestHeader) {
+            co_return true;
+        }
+        if (_parseError) [[unlikely]] {
+            co_return false;
+        }
+        for (std::size_t n = _recvBuf.size() ? _parserReq() : IO::kBufMaxSize; n; n = _parserReq()) {
+            if (n == kParseError) [[unlikely]] {
+                co_return false;
+            }
+            auto res = _recvBuf.isHold()
+                ? co_await _io.recvLinkTimeout<Timeout>(
+                    // 保留原有的数据
+                    std::span<char>{_recvBuf.data() + _recvBuf.size(),  _recvBuf.data() + _recvBuf.max_size()}
+                )
+                // 空闲等待请求时不持有内存, 数据到达时才获取缓冲区
+                : co_await _io.recvLinkTimeout<Timeout>(_recvBuf);
             if (res.index() == 1) [[unlikely]] {
                 co_return false;  // 超时
             }
@@ -263,43 +307,68 @@ public:
     }
 
     /**
-     * @brief 获取请求头键值对的引用
-     * @return const std::unordered_map<std::string, std::string>& 
+     * @brief 获取请求头键值对的引用 (键为小写)
+     * @note 服务端在首次调用时从 getHeadersView() 拷贝出来; 只需要查找时使用 getHeadersView(), 不申请内存
+     * @return const HeaderHashMap&
      */
-    const auto& getHeaders() const noexcept {
+    const HeaderHashMap& getHeaders() const {
+        if (_requestHeaders.empty() && !_headersView.empty()) {
+            for (auto const& [key, val] : _headersView) {
+                _requestHeaders.try_emplace(std::string{key}, val);
+            }
+        }
         return _requestHeaders;
     }
 
+    /**
+     * @brief 获取请求头的视图 (键已转为小写, 查找不区分大小写)
+     * @return const RequestHeaderView& 指向接收缓冲区, 只在 clear() 之前 (即端点返回之前) 有效
+     */
+    const RequestHeaderView& getHeadersView() const noexcept {
+        return _headersView;
+    }
+
     /**
      * @brief 解析查询参数 (解析如: `?name=loli&awa=ok&hitori`)
+     * @tparam Str 键值的类型; 不需要在端点之外保存时, 可以使用不拷贝的 getParseQueryParametersView()
      * @return 返回解析到的字符串键值对哈希表
      * @warning 如果解析到不是键值对的, 即通过`&`分割后没有`=`的, 默认其全部为Key, 但Val = ""
      */
-    std::unordered_map<std::string, std::string> getParseQueryParameters() const {
+    template <typename Str = std::string>
+        requires (std::is_same_v<Str, std::string_view> || std::is_same_v<Str, std::string>)
+    std::unordered_map<Str, Str> getParseQueryParameters() const {
         auto path = getReqPath();
         std::size_t pos = path.find('?'); // 没必要反向查找
         if (pos == std::string::npos)
             return {};
         // 如果有#这种, 要删除: 无需处理, 这个只是存在于客户端, 不会传输到服务端(?)至少path没有
         auto parameter = path.substr(pos + 1);
-        auto kvArr = HX::utils::StringUtil::split<std::string>(parameter, "&");
-        std::unordered_map<std::string, std::string> res;
-        for (const auto& it : kvArr) {
-            auto&& kvPair = HX::utils::StringUtil::splitAtFirst(it, "=");
-            if (kvPair.first == "")
-                res.insert_or_assign(it, "");
+        auto kvArr = HX::utils::StringUtil::split<std::string_view>(parameter, "&");
+        std::unordered_map<Str, Str> res;
+        for (auto it : kvArr) {
+            std::size_t eq = it.find('=');
+            if (eq == std::string_view::npos || eq == 0)
+                res.insert_or_assign(Str{it}, Str{});
             else
-                res.insert(std::move(kvPair));
+                res.emplace(Str{it.substr(0, eq)}, Str{it.substr(eq + 1)});
         }
         return res;
     }
 
+    /**
+     * @brief 解析查询参数, 键值为指向请求行的视图
+     * @warning 只在 clear() 之前 (即端点返回之前) 有效
+     */
+    std::unordered_map<std::string_view, std::string_view> getParseQueryParametersView() const {
+        return getParseQueryParameters<std::string_view>();
+    }
+
     /**
      * @brief 获取请求类型
      * @return 请求类型 (如: "GET", "POST"...)
      */
     std::string_view getReqType() const noexcept {
-        return _requestLine[RequestLineDataType::RequestType];
+        return _requestLineView[RequestLineDataType::RequestType];
     }
 
     /**
@@ -338,42 +407,55 @@ public:
     /**
      * @brief 解析 Body 并且保存到 path
      * @param path 保存路径
+     * @param mode 写文件的方式; 大文件上传可以使用 IoMode::Direct, 以免挤占页缓存
      * @return coroutine::Task<> 
      */
     template <typename Timeout = decltype(utils::operator""_s<"5">())>
         requires(utils::HasTimeNTTP<Timeout>)
-    coroutine::Task<> saveToFile(std::string_view path) {
-        utils::AsyncFile file{_io};
-        co_await file.open(path, utils::OpenMode::Write);
+    coroutine::Task<> saveToFile(
+        std::string_view path,
+        utils::AsyncFile::IoMode mode = utils::AsyncFile::IoMode::Buffered
+    ) {
         if (_completeBody) [[unlikely]] {
             // 已经解析过 Http Body 了
             throw std::runtime_error{"Have already analyzed the http body"};
         }
         _completeBody = true;
-        for (std::size_t n = co_await _coParserReqBody(file); n; n = co_await _coParserReqBody(file)) {
-            auto res = co_await _io.recvLinkTimeout<Timeout>(
-                // 保留原有的数据
-                {_recvBuf.data() + _recvBuf.size(),  _recvBuf.data() + _recvBuf.max_size()}
-            );
-            if (res.index() == 1) [[unlikely]] {
-                // 超时
-                throw std::runtime_error{"parseBody: Recv timeout"};
-            }
-            auto recvN = HXLIBS_CHECK_EVENT_LOOP(
-                (res.template get<0, exception::ExceptionMode::Nothrow>())
-            );
-            if (recvN == 0) [[unlikely]] {
-                // 连接断开
-                throw std::runtime_error{"parseBody: Connection is Broken"};
+        utils::AsyncFile file{_io, mode};
+        co_await file.open(path, utils::OpenMode::Write);
+        std::exception_ptr err;
+        try {
+            for (std::size_t n = co_await _coParserReqBody(file); n; n = co_await _coParserReqBody(file)) {
+                auto res = co_await _io.recvLinkTimeout<Timeout>(
+                    // 保留原有的数据
+                    {_recvBuf.data() + _recvBuf.size(),  _recvBuf.data() + _recvBuf.max_size()}
+                );
+                if (res.index() == 1) [[unlikely]] {
+                    // 超时
+                    throw std::runtime_error{"parseBody: Recv timeout"};
+                }
+                auto recvN = HXLIBS_CHECK_EVENT_LOOP(
+                    (res.template get<0, exception::ExceptionMode::Nothrow>())
+                );
+                if (recvN == 0) [[unlikely]] {
+                    // 连接断开
+                    throw std::runtime_error{"parseBody: Connection is Broken"};
+                }
+                _recvBuf.addSize(static_cast<std::size_t>(recvN));
             }
-            _recvBuf.addSize(static_cast<std::size_t>(recvN));
+        } catch (...) {
+            err = std::current_exception();
+        }
+        co_await file.close();
+        if (err) [[unlikely]] {
+            std::rethrow_exception(err);
         }
     }
 
     // @todo 
     coroutine::Task<> _getMultipartFiles() {
         static_assert(true, "@todo Func...");
-        if (auto it = _requestHeaders.find(CONTENT_TYPE_SV); it != _requestHeaders.end()) {
+        if (auto it = _headersView.find(CONTENT_TYPE_SV); it != _headersView.end()) {
             // multipart/form-data 协议
             if (_boundary.empty()) {            
                 std::string_view str = it->second;
@@ -401,23 +483,34 @@ public:
 
     /**
      * @brief 获取请求PATH
-     * @return 请求PATH (如: "/", "/home?loli=watasi"...)
+     * @return 请求PATH (如: "/", "/home?loli=watasi"...), 指向请求行的视图, 在 clear() 之前有效
      */
     std::string_view getReqPath() const noexcept {
-        return _requestLine[RequestLineDataType::RequestPath];
+        return _requestLineView[RequestLineDataType::RequestPath];
     }
 
     /**
      * @brief 获取请求的纯PATH部分
+     * @tparam Str 返回的类型; 不需要在端点之外保存时, 可以使用不拷贝的 getPureReqPathView()
      * @return 请求PATH (如: "/", "/home?loli=watasi"的"/home"部分)
      */
-    std::string getPureReqPath() const noexcept {
+    template <typename Str = std::string>
+        requires (std::is_same_v<Str, std::string_view> || std::is_same_v<Str, std::string>)
+    Str getPureReqPath() const {
         auto path = getReqPath();
         std::size_t pos = path.find('?');
         if (pos != std::string_view::npos) {
             path = path.substr(0, pos);
         }
-        return {path.data(), path.size()};
+        return Str{path};
+    }
+
+    /**
+     * @brief 获取请求的纯PATH部分, 指向请求行的视图
+     * @warning 只在 clear() 之前 (即端点返回之前) 有效
+     */
+    std::string_view getPureReqPathView() const noexcept {
+        return getPureReqPath<std::string_view>();
     }
 
     /**
@@ -425,7 +518,7 @@ public:
      * @return 请求协议版本 (如: "HTTP/1.1", "HTTP/2.0"...)
      */
     std::string_view getProtocolVersion() const noexcept {
-        return _requestLine[RequestLineDataType::ProtocolVersion];
+        return _requestLineView[RequestLineDataType::ProtocolVersion];
     }
 
     /**
@@ -437,10 +530,13 @@ public:
      * @return std::string_view 
      */
     std::string_view getPathParam(std::size_t index) const {
-        if (_wildcarDataArr.empty()) [[unlikely]] {
+        if (!_pathParams.paramNum) [[unlikely]] {
             throw std::runtime_error("No path parameters available to parse.");
         }
-        return _wildcarDataArr[index];
+        if (index >= _pathParams.paramNum) [[unlikely]] {
+            throw std::out_of_range("Path parameter index out of range.");
+        }
+        return _pathParams.params[index];
     }
 
     /**
@@ -449,14 +545,14 @@ public:
      * @return std::string_view 
      */
     std::string_view getUniversalWildcardPath() const {
-        if (_urlWildcardData.empty()) [[unlikely]] {
+        if (_pathParams.wildcard.empty()) [[unlikely]] {
             throw std::runtime_error("No path parameters available to parse.");
         }
-        return _urlWildcardData;
+        return _pathParams.wildcard;
     }
 
     RangeRequestView getRangeRequestView() const {
-        return {getReqType(), _requestHeaders};
+        return {getReqType(), _headersView};
     }
     // ===== ↑服务端使用↑ =====
 
@@ -470,6 +566,7 @@ public:
 
     /**
      * @brief 清空已有的请求内容, 并且初始化标准
+     * @note 请求体之后多读取的内容 (流水线中的后续请求) 会保留在接收缓冲区中, 由下一次 parserReq() 解析
      * @warning 显然应该在 clearBody() 之前调用
      */
     coroutine::Task<> clear() noexcept {
@@ -481,11 +578,20 @@ public:
         _boundary = {};
         _requestLine.clear();
         _requestHeaders.clear();
-        _requestHeadersIt = _requestHeaders.end();
-        _recvBuf.clear();
+        if (_recvBuf.size()) {
+            // 流水线: 之后的请求已经 (部分) 到达, 保留它们
+            _requestLineView = {};
+            _headersView.clear();
+            _headerScanPos = 0;
+            _recvBuf.unpin();
+        } else {
+            _releaseRecvBuf();
+        }
         _body.clear();
         _completeRequestHeader = false;
         _remainingBodyLen.reset();
+        _chunkState = ChunkState::Size;
+        _parseError.reset();
     }
 
 private:
@@ -499,31 +605,69 @@ private:
     };
 
     /**
-     * @brief 仅用于读取时候写入的缓冲区
+     * @brief 请求头解析失败 (请求头过大或者不合法), 应断开连接
+     */
+    inline static constexpr std::size_t kParseError = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief 为请求体保留的接收缓冲区大小; 请求头 (连同请求行) 最多占用 `max_size() - kBodyReservedSize`
+     */
+    inline static constexpr std::size_t kBodyReservedSize = 1024;
+
+    /**
+     * @brief 分块大小行 (连同分块扩展) 与 trailer 的一行的最大长度; 不超过为请求体保留的缓冲区, 保证一行总能读完
+     */
+    inline static constexpr std::size_t kMaxChunkLineSize = kBodyReservedSize;
+
+    /**
+     * @brief 分块编码请求体的解析状态 (跨越多次读取)
+     */
+    enum class ChunkState : uint8_t {
+        Size,       // 分块大小行
+        Data,       // 分块数据, 剩余的长度为 _remainingBodyLen
+        DataEnd,    // 分块数据之后的 `\r\n`
+        Trailer,    // 长度为 0 的分块之后的 trailer, 直到空行
+    };
+
+    /**
+     * @brief _decodeChunked 的结果
      */
-    container::ArrayBuf<char, IO::kBufMaxSize> _recvBuf;
+    enum class ChunkStep : uint8_t {
+        Continue,   // 继续解码
+        NeedMore,   // 需要读取更多的数据
+        Done,       // 请求体已经结束
+    };
 
-    std::vector<std::string> _requestLine;  // 请求行
-    HeaderHashMap _requestHeaders;          // 请求头
+    /**
+     * @brief 仅用于读取时候写入的缓冲区, 仅在解析请求期间持有内存;
+     *        解析完请求头后, 请求头部分被固定 (pin), 直到 clear()
+     */
+    RecvBuf _recvBuf;
 
-    // 上一次解析的请求头
-    decltype(_requestHeaders)::iterator _requestHeadersIt;
+    std::vector<std::string> _requestLine;  // [客户端] 请求行
+    std::array<std::string_view, 3> _requestLineView; // 请求行 (服务端指向接收缓冲区, 客户端指向 _requestLine)
+    mutable HeaderHashMap _requestHeaders;  // 请求头 (客户端); 服务端为 getHeaders() 按需拷贝的 _headersView
+    RequestHeaderView _headersView;         // [服务端] 请求头, 指向接收缓冲区
 
     // 请求体
     std::string _body;
 
-    // @brief 仍需读取的请求体长度
+    // @brief 仍需读取的请求体长度; `Content-Length` 在请求头结束时解析并记录于此
     std::optional<std::size_t> _remainingBodyLen;
 
+    // @brief 下一次从哪一行开始解析请求头
+    std::size_t _headerScanPos;
+
+    // @brief 分块编码请求体的解析状态
+    ChunkState _chunkState;
+
+    // @brief [服务端] 请求不合法时, 应该回复的错误码 (回复后断开连接)
+    std::optional<Status> _parseError;
+
     /**
-     * @brief 路径变量, 如`/home/{id}`的`id`, 
-     * 存放的是解析后的结果字符串视图(指向的是Request的请求行)
+     * @brief 路径变量与通配符的结果, 由路由匹配时写入 (指向的是Request的请求行)
      */
-    // 单个路径变量的结果数组
-    std::span<std::string_view> _wildcarDataArr;
-
-    // 通配符的结果
-    std::string_view _urlWildcardData;
+    PathParams _pathParams;
 
     // IO 对象 (内含 协程事件循环)
     IO& _io;
@@ -543,11 +687,44 @@ private:
 
     friend class Router;
     friend class WebSocketFactory;
+    friend struct ConnectionHandler;
 
     template <typename Timeout, typename Proxy>
         requires(utils::HasTimeNTTP<Timeout>)
     friend class HttpClient;
 
+    /**
+     * @brief 归还接收缓冲区, 并且清空指向它的请求行与请求头
+     */
+    void _releaseRecvBuf() noexcept {
+        _requestLineView = {};
+        _headersView.release();
+        _headerScanPos = 0;
+        _recvBuf.release();
+    }
+
+    /**
+     * @brief 只用接收缓冲区中已有的数据 (流水线中已经到达的请求) 解析请求头, 不会读取
+     * @return bool 是否已经有完整的请求头; 为 false 时需要 parserReq() 读取 (或者请求不合法)
+     */
+    bool _tryParserReq() {
+        if (!_completeRequestHeader && _recvBuf.size()) {
+            _parserReq();
+        }
+        return _completeRequestHeader;
+    }
+
+    /**
+     * @brief 当前请求 (连同请求体) 之后, 接收缓冲区中是否已经有后续请求 (流水线) 的数据
+     * @note 需要在解析请求体之前调用; 分块编码的请求体长度未知, 视为没有
+     */
+    bool _hasPipelinedReq() const {
+        if (_headersView.contains(TRANSFER_ENCODING_SV)) [[unlikely]] {
+            return false;
+        }
+        return _recvBuf.size() > _remainingBodyLen.value_or(0);
+    }
+
     /**
      * @brief 组装请求行和请求头 (不包含 `content-length`, 和 最终的`\r\n\r\n`分割)
      * @param buf 
@@ -594,81 +771,245 @@ private:
     }
 
     /**
-     * @brief 解析请求
+     * @brief 解析请求行与请求头 (零拷贝: 只记录指向接收缓冲区的视图)
      * @return 是否需要继续解析;
      *         `== 0`: 不需要;
-     *         `>  0`: 需要继续解析`size_t`个字节
-     * @warning 假定内容是符合Http协议的
+     *         `== kParseError`: 请求头过大或者不合法 (错误码记录在 _parseError 中);
+     *         `>  0`: 需要继续读取
+     * @note 由 internal::LineScanner 找出所有的行与 ':', 读到多少解析多少 (缓冲区不会移动, 之前的视图仍然有效),
+     *       下次从未完整的行继续. 读到空行后把请求头固定在缓冲区中, 剩余的部分为请求体
      */
     std::size_t _parserReq() {
-        using namespace std::string_literals;
+        char* data = _recvBuf.data();
+        std::string_view buf{data, _recvBuf.size()};
+        std::size_t const limit = _recvBuf.max_size() - kBodyReservedSize;
+        auto const isSpace = [](char c) noexcept {
+            return c == ' ' || c == '\t';
+        };
+        auto const trim = [&](std::string_view sv) noexcept {
+            while (sv.size() && isSpace(sv.front())) {
+                sv.remove_prefix(1);
+            }
+            while (sv.size() && isSpace(sv.back())) {
+                sv.remove_suffix(1);
+            }
+            return sv;
+        };
+        bool isEnd = false;
+        internal::LineScanner scanner{buf, _headerScanPos};
+        for (internal::HeaderLine line; scanner.next(line);) {
+            std::string_view lineSv = buf.substr(line.begin, line.end - line.begin);
+            if (getReqType().empty()) [[unlikely]] {
+                // 请求行; 之前的空行忽略 (RFC 9112 2.2)
+                if (lineSv.size() && !_parserReqLine(lineSv)) [[unlikely]] {
+                    return _setParseError(Status::CODE_400);
+                }
+                continue;
+            }
+            /**
+             * @brief 请求头
+             * 每行为 `K: V`, K 需要是 token, 不区分大小写 (原地转为小写), V 去掉两端的空白;
+             * -  空行即请求头结束
+             * -  以空白开头的行是上一行的折叠 (obs-fold), 原地把 `\r\n` 换成空格, 接在上一个值的后面
+             * -  没有`:`的行忽略
+             */
+            if (lineSv.empty()) {
+                isEnd = true;
+                break;
+            }
+            if (isSpace(lineSv.front())) [[unlikely]] {
+                if (!_headersView.empty()) {
+                    data[line.begin - 2] = data[line.begin - 1] = ' ';
+                    auto& val = _headersView.back().second;
+                    val = trim({val.data(), static_cast<std::size_t>(data + line.end - val.data())});
+                }
+            } else if (line.colon != std::string_view::npos) [[likely]] {
+                if (!internal::toLowerToken(data + line.begin, line.colon - line.begin)) [[unlikely]] {
+                    return _setParseError(Status::CODE_400);
+                }
+                _headersView.emplace(
+                    buf.substr(line.begin, line.colon - line.begin),
+                    trim(buf.substr(line.colon + 1, line.end - line.colon - 1))
+                );
+            }
+        }
+        if (scanner.isError()) [[unlikely]] {
+            return _setParseError(Status::CODE_400);
+        }
+        std::size_t const pos = scanner.pos();
+        _headerScanPos = pos;
+        if (!isEnd) {
+            if (buf.size() >= limit) [[unlikely]] {
+                // 请求行都没有读完的, 是 URI 过长
+                return _setParseError(getReqType().empty() ? Status::CODE_414 : Status::CODE_431);
+            }
+            return IO::kBufMaxSize;
+        }
+        if (pos > limit) [[unlikely]] {
+            return _setParseError(Status::CODE_431);
+        }
+        if (!_parserFraming()) [[unlikely]] {
+            return _setParseError(Status::CODE_400);
+        }
+        _completeRequestHeader = true;
+        // 固定请求头, 之后多读取的内容 (请求体) 从缓冲区头部开始
+        _recvBuf.pin(pos);
+        return 0;
+    }
+
+    /**
+     * @brief 记录请求不合法时应该回复的错误码
+     * @param status 错误码
+     * @return std::size_t kParseError
+     */
+    std::size_t _setParseError(Status status) noexcept {
+        _parseError = status;
+        return kParseError;
+    }
+
+    /**
+     * @brief 请求头结束时, 确定请求体的长度 (RFC 9112 6.3); `Content-Length` 记录到 _remainingBodyLen
+     * @return 是否合法; 以下会让前后的代理对请求体的长度理解不一致 (请求走私), 均不合法:
+     *         -  `Content-Length` 重复, 或者不是一个十进制数
+     *         -  同时存在 `Transfer-Encoding` 与 `Content-Length`
+     *         -  `Transfer-Encoding` 最后的编码不是 `chunked`
+     */
+    bool _parserFraming() noexcept {
         using namespace std::string_view_literals;
-        std::string_view buf{_recvBuf.data(), _recvBuf.size()};
-        switch ((_completeRequestHeader << 1) | (!_requestLine.empty())) {
-            case 0x00: { // 什么也没有解析, 开始解析请求行
-                std::size_t pos = buf.find(CRLF);
-                if (pos == std::string_view::npos) [[unlikely]] { // 不可能事件
-                    return IO::kBufMaxSize;
+        std::string_view const* contentLength = nullptr;
+        std::string_view const* transferEncoding = nullptr;
+        for (auto const& [key, val] : _headersView) { // 键已经转为小写
+            if (key == CONTENT_LENGTH_SV) {
+                if (contentLength) [[unlikely]] {
+                    return false;
                 }
-                std::string_view reqLine = buf.substr(0, pos);
+                contentLength = &val;
+            } else if (key == TRANSFER_ENCODING_SV) {
+                // 多个时, 以最后一个的最后一个编码为准
+                transferEncoding = &val;
+            }
+        }
+        if (transferEncoding) [[unlikely]] {
+            if (contentLength) {
+                return false;
+            }
+            std::string_view coding = *transferEncoding;
+            coding = coding.substr(coding.rfind(',') + 1); // npos + 1 == 0
+            coding.remove_prefix(std::min(coding.find_first_not_of(" \t"sv), coding.size()));
+            return RequestHeaderView::equalsIgnoreCase(coding, "chunked"sv);
+        }
+        if (contentLength) {
+            _remainingBodyLen = internal::parseContentLength(*contentLength);
+            return _remainingBodyLen.has_value();
+        }
+        return true;
+    }
 
-                // 解析请求行
-                _requestLine = utils::StringUtil::split<std::string>(
-                    reqLine, " "sv
-                );
+    /**
+     * @brief 请求体不合法: 记录 400 并抛出异常 (由 ConnectionHandler 回复并断开连接)
+     * @param msg 异常信息
+     */
+    [[noreturn]] void _throwBadBody(char const* msg) {
+        _parseError = Status::CODE_400;
+        throw std::runtime_error{msg};
+    }
 
-                if (_requestLine.size() < 3) [[unlikely]] {
-                    return IO::kBufMaxSize;
-                } 
-                // else if (_requestLine.size() > 3) [[unlikely]] {
-                // @todo 理论上不会出现
-                // }
+    /**
+     * @brief 解析并校验请求行: `方法 路径 协议版本`
+     * @param line 不包含 `\r\n`
+     * @return 是否合法
+     */
+    bool _parserReqLine(std::string_view line) noexcept {
+        using namespace std::string_view_literals;
+        std::size_t const sp1 = static_cast<std::size_t>(
+            std::find_if_not(line.begin(), line.end(), internal::isTokenChar) - line.begin());
+        if (!sp1 || sp1 == line.size() || line[sp1] != ' ') [[unlikely]] {
+            return false;
+        }
+        std::size_t const sp2 = sp1 + 1 + internal::findNonVisible(line.data() + sp1 + 1, line.size() - sp1 - 1);
+        if (sp2 == sp1 + 1 || sp2 == line.size() || line[sp2] != ' ') [[unlikely]] {
+            return false;
+        }
+        std::string_view version = line.substr(sp2 + 1);
+        auto const isDigit = [](char c) noexcept {
+            return c >= '0' && c <= '9';
+        };
+        if (version.size() != "HTTP/1.1"sv.size() || !version.starts_with("HTTP/"sv)
+            || !isDigit(version[5]) || version[6] != '.' || !isDigit(version[7])
+        ) [[unlikely]] {
+            return false;
+        }
+        _requestLineView[RequestLineDataType::RequestType] = line.substr(0, sp1);
+        _requestLineView[RequestLineDataType::RequestPath] = line.substr(sp1 + 1, sp2 - sp1 - 1);
+        _requestLineView[RequestLineDataType::ProtocolVersion] = version;
+        return true;
+    }
 
-                buf = buf.substr(pos + 2); // 再前进, 以去掉 "\r\n"
-                [[fallthrough]];
+    /**
+     * @brief 解码分块编码请求体的一步; 状态保存在 _chunkState 中, 因此数据可以在任意位置被读取截断
+     *        (包括分块大小行、分块数据之后的 `\r\n`, 以及最后的 trailer)
+     * @param buf [in, out] 接收缓冲区中还未处理的数据, 处理过的部分会被移除
+     * @param data [out] 本步得到的请求体数据, 指向接收缓冲区 (可能为空)
+     * @return ChunkStep
+     * @throw std::runtime_error 分块编码不合法 (同时记录 400 到 _parseError)
+     */
+    ChunkStep _decodeChunked(std::string_view& buf, std::string_view& data) {
+        switch (_chunkState) {
+        case ChunkState::Size: {
+            std::size_t pos = buf.find(CRLF);
+            if (pos == std::string_view::npos) { // 没有读完
+                if (buf.size() > kMaxChunkLineSize) [[unlikely]] {
+                    _throwBadBody("parseBody: Chunk size line too long");
+                }
+                return ChunkStep::NeedMore;
+            }
+            _remainingBodyLen = internal::parseChunkSize(buf.substr(0, pos));
+            if (!_remainingBodyLen) [[unlikely]] {
+                _throwBadBody("parseBody: Invalid chunk size");
+            }
+            buf.remove_prefix(pos + CRLF.size());
+            _chunkState = *_remainingBodyLen ? ChunkState::Data : ChunkState::Trailer;
+            return ChunkStep::Continue;
+        }
+        case ChunkState::Data: {
+            std::size_t n = std::min(*_remainingBodyLen, buf.size());
+            data = buf.substr(0, n);
+            buf.remove_prefix(n);
+            *_remainingBodyLen -= n;
+            if (*_remainingBodyLen) { // 没有读完
+                return ChunkStep::NeedMore;
+            }
+            _chunkState = ChunkState::DataEnd;
+            return ChunkStep::Continue;
+        }
+        case ChunkState::DataEnd:
+            if (buf.size() < CRLF.size()) { // `\r\n` 被截断了
+                return ChunkStep::NeedMore;
+            }
+            if (!buf.starts_with(CRLF)) [[unlikely]] {
+                _throwBadBody("parseBody: Missing CRLF after chunk data");
             }
-            case 0x01: { // 解析完请求行, 开始解析请求头
-                /**
-                 * @brief 请求头
-                 * 通过`\r\n`分割后, 取最前面的, 先使用最左的`:`以判断是否是需要作为独立的键值对;
-                 * -  如果找不到`:`, 并且 非空, 那么它需要接在上一个解析的键值对的值尾
-                 * -  否则即请求头解析完毕!
-                 */
-                while (!_completeRequestHeader) { // 请求头未解析完
-                    std::size_t pos = buf.find(CRLF);
-                    if (pos == std::string_view::npos) { // 没有读取完
-                        _recvBuf.moveToHead(buf);
-                        return IO::kBufMaxSize;
-                    }
-                    std::string_view subKVStr = buf.substr(0, pos);
-                    auto p = utils::StringUtil::splitAtFirst(subKVStr, HEADER_SEPARATOR_SV);
-                    if (p.first.empty()) [[unlikely]] {     // 找不到 ": "
-                        if (subKVStr.size()) [[unlikely]] { // 很少会有分片传输请求头的
-                            _requestHeadersIt->second.append(subKVStr);
-                        } else { // 请求头解析完毕!
-                            _completeRequestHeader = true;
-                        }
-                    } else {
-                        // K: V, 其中 V 是区分大小写的, 但是 K 是不区分的
-                        utils::StringUtil::toLower(p.first);
-                        _requestHeadersIt = _requestHeaders.insert(p).first;
-                    }
-                    buf = buf.substr(pos + 2); // 再前进, 以去掉 "\r\n"
+            buf.remove_prefix(CRLF.size());
+            _chunkState = ChunkState::Size;
+            return ChunkStep::Continue;
+        case ChunkState::Trailer: {
+            // 长度为 0 的分块之后是 trailer 字段 (忽略), 直到空行
+            std::size_t pos = buf.find(CRLF);
+            if (pos == std::string_view::npos) { // 没有读完, 之后的读取仍然是 trailer
+                if (buf.size() > kMaxChunkLineSize) [[unlikely]] {
+                    _throwBadBody("parseBody: Trailer line too long");
                 }
-                [[fallthrough]];
+                return ChunkStep::NeedMore;
             }
-            case 0x03: {
-                // 更改到懒解析Body, 如果已经读取了, 那放入缓存趴...
-                _recvBuf.moveToHead(buf);
-                break;
+            buf.remove_prefix(pos + CRLF.size());
+            if (pos) {
+                return ChunkStep::Continue;
             }
-            [[unlikely]] default:
-#ifndef NDEBUG
-                throw std::runtime_error{"parserRequest UB Error"}
-#endif // NDEBUG
-            ;
+            _chunkState = ChunkState::Size;
+            return ChunkStep::Done;
         }
-        return 0;
+        }
+        return ChunkStep::Done;
     }
 
     /**
@@ -679,60 +1020,27 @@ private:
         using namespace std::string_literals;
         using namespace std::string_view_literals;
         std::string_view buf{_recvBuf.data(), _recvBuf.size()};
-        if (_requestHeaders.contains(CONTENT_LENGTH_SV)) { // 存在content-length模式接收的响应体
-            // 计算剩余待解析字节数
-            if (!_remainingBodyLen.has_value()) {
-                _remainingBodyLen = std::stoull(_requestHeaders.find(CONTENT_LENGTH_SV)->second);
-            }
-            if (*_remainingBodyLen != 0) {
-                *_remainingBodyLen -= buf.size();
-                _body.append(buf);
-                _recvBuf.clear();
-                return *_remainingBodyLen;
-            }
-        } else if (_requestHeaders.contains(TRANSFER_ENCODING_SV)) { // 存在请求体以`分块传输编码`
+        if (_headersView.contains(TRANSFER_ENCODING_SV)) { // 存在请求体以`分块传输编码` (已经校验最后的编码是 chunked)
             /**
              * @todo 目前只支持 chunked 编码, 不支持压缩的 (2024-9-6 09:36:25) 
              * */
-            if (_remainingBodyLen) { // 处理没有读取完的
-                if (buf.size() <= *_remainingBodyLen) { // 还没有读取完毕
-                    _body.append(buf);
-                    *_remainingBodyLen -= buf.size();
-                    _recvBuf.clear();
-                    return IO::kBufMaxSize;
-                } else { // 读取完了
-                    _body.append(buf.substr(0, *_remainingBodyLen));
-                    buf = buf.substr(std::min(*_remainingBodyLen + 2, buf.size()));
-                    _remainingBodyLen.reset();
-                }
-            }
             for (;;) {
-                std::size_t posLen = buf.find(CRLF);
-                if (posLen == std::string_view::npos) { // 没有读完
+                std::string_view data;
+                auto step = _decodeChunked(buf, data);
+                _body.append(data);
+                if (step != ChunkStep::Continue) {
+                    // 之后的 (流水线中的后续请求, 或者未读完的一行) 留在缓冲区中
                     _recvBuf.moveToHead(buf);
-                    return IO::kBufMaxSize;
-                }
-                if (!posLen && buf[0] == '\r') [[unlikely]] { // posLen == 0
-                    // \r\n 贴脸, 触发原因, std::min(*_remainingBodyLen + 2, buf.size()) 只能 buf.size()
-                    buf = buf.substr(posLen + 2);
-                    continue;
+                    return step == ChunkStep::Done ? 0 : IO::kBufMaxSize;
                 }
-                _remainingBodyLen = utils::NumericBaseConverter::strToNum<std::size_t, 16>(
-                    buf.substr(0, posLen)
-                ); // 转换为十进制整数
-                if (!*_remainingBodyLen) { // 解析完毕
-                    return 0;
-                }
-                buf = buf.substr(posLen + 2);
-                if (buf.size() <= *_remainingBodyLen) { // 没有读完
-                    _body.append(buf);
-                    *_remainingBodyLen -= buf.size();
-                    _recvBuf.clear();
-                    return IO::kBufMaxSize;
-                }
-                _body.append(buf.substr(0, *_remainingBodyLen));
-                buf = buf.substr(*_remainingBodyLen + 2);
             }
+        } else if (_remainingBodyLen.value_or(0)) { // content-length 模式接收的请求体, 长度在请求头结束时已经解析
+            // 只取请求体的部分, 之后的 (流水线中的后续请求) 留在缓冲区中
+            std::size_t n = std::min(*_remainingBodyLen, buf.size());
+            *_remainingBodyLen -= n;
+            _body.append(buf.substr(0, n));
+            _recvBuf.moveToHead(buf.substr(n));
+            return *_remainingBodyLen;
         }
         return 0;
     }
@@ -745,61 +1053,28 @@ private:
         using namespace std::string_literals;
         using namespace std::string_view_literals;
         std::string_view buf{_recvBuf.data(), _recvBuf.size()};
-        if (_requestHeaders.contains(CONTENT_LENGTH_SV)) { // 存在content-length模式接收的响应体
-            // 计算剩余待解析字节数
-            if (!_remainingBodyLen.has_value()) {
-                _remainingBodyLen = std::stoull(_requestHeaders.find(CONTENT_LENGTH_SV)->second);
-            }
-            
-            if (*_remainingBodyLen != 0) {
-                *_remainingBodyLen -= buf.size();
-                co_await file.write(buf); // _body.append(buf);
-                _recvBuf.clear();
-                co_return *_remainingBodyLen;
-            }
-        } else if (_requestHeaders.contains(TRANSFER_ENCODING_SV)) { // 存在请求体以`分块传输编码`
+        if (_headersView.contains(TRANSFER_ENCODING_SV)) { // 存在请求体以`分块传输编码` (已经校验最后的编码是 chunked)
             /**
              * @todo 目前只支持 chunked 编码, 不支持压缩的 (2024-9-6 09:36:25) 
              * */
-            if (_remainingBodyLen) { // 处理没有读取完的
-                if (buf.size() <= *_remainingBodyLen) { // 还没有读取完毕
-                    co_await file.write(buf); // _body.append(buf);
-                    *_remainingBodyLen -= buf.size();
-                    _recvBuf.clear();
-                    co_return IO::kBufMaxSize;
-                } else { // 读取完了
-                    co_await file.write(buf.substr(0, *_remainingBodyLen)); // _body.append(buf.substr(0, *_remainingBodyLen));
-                    buf = buf.substr(std::min(*_remainingBodyLen + 2, buf.size()));
-                    _remainingBodyLen.reset();
-                }
-            }
             for (;;) {
-                std::size_t posLen = buf.find(CRLF);
-                if (posLen == std::string_view::npos) { // 没有读完
-                    _recvBuf.moveToHead(buf);
-                    co_return IO::kBufMaxSize;
-                }
-                if (!posLen && buf[0] == '\r') [[unlikely]] { // posLen == 0
-                    // \r\n 贴脸, 触发原因, std::min(*_remainingBodyLen + 2, buf.size()) 只能 buf.size()
-                    buf = buf.substr(posLen + 2);
-                    continue;
+                std::string_view data;
+                auto step = _decodeChunked(buf, data);
+                if (data.size()) {
+                    co_await file.write(data); // 在 moveToHead 之前写入, 之后 data 会被覆盖
                 }
-                _remainingBodyLen = utils::NumericBaseConverter::strToNum<std::size_t, 16>(
-                    buf.substr(0, posLen)
-                ); // 转换为十进制整数
-                if (!*_remainingBodyLen) { // 解析完毕
-                    co_return 0;
-                }
-                buf = buf.substr(posLen + 2);
-                if (buf.size() <= *_remainingBodyLen) { // 没有读完
-                    co_await file.write(buf); // _body.append(buf);
-                    *_remainingBodyLen -= buf.size();
-                    _recvBuf.clear();
-                    co_return IO::kBufMaxSize;
+                if (step != ChunkStep::Continue) {
+                    _recvBuf.moveToHead(buf);
+                    co_return step == ChunkStep::Done ? 0 : IO::kBufMaxSize;
                 }
-                co_await file.write(buf.substr(0, *_remainingBodyLen)); // _body.append(buf.substr(0, *_remainingBodyLen));
-                buf = buf.substr(*_remainingBodyLen + 2);
             }
+        } else if (_remainingBodyLen.value_or(0)) { // content-length 模式接收的请求体, 长度在请求头结束时已经解析
+            // 只取请求体的部分, 之后的 (流水线中的后续请求) 留在缓冲区中
+            std::size_t n = std::min(*_remainingBodyLen, buf.size());
+            *_remainingBodyLen -= n;
+            co_await file.write(buf.substr(0, n)); // _body.append(buf);
+            _recvBuf.moveToHead(buf.substr(n));
+            co_return *_remainingBodyLen;
         }
         co_return 0;
     }
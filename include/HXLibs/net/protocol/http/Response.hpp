@@ -20,16 +20,23 @@
 
 #include <string>
 #include <string_view>
+#include <span>
 #include <vector>
 #include <unordered_map>
 #include <optional>
+#include <charconv>
+#include <utility>
+#include <exception>
 
 #include <HXLibs/net/protocol/http/Http.hpp>
+#include <HXLibs/net/protocol/http/HttpScanner.hpp>
 #include <HXLibs/net/protocol/http/Status.hpp>
+#include <HXLibs/net/protocol/http/DateCache.hpp>
 #include <HXLibs/net/protocol/http/MimeType.hpp>
+#include <HXLibs/net/protocol/http/FileCache.hpp>
 #include <HXLibs/net/socket/IO.hpp>
 #include <HXLibs/coroutine/task/Task.hpp>
-#include <HXLibs/container/ArrayBuf.hpp>
+#include <HXLibs/coroutine/task/AsyncGenerator.hpp>
 #include <HXLibs/utils/StringUtils.hpp>
 #include <HXLibs/utils/FileUtils.hpp>
 #include <HXLibs/utils/TimeNTTP.hpp>
@@ -53,10 +60,13 @@ public:
     explicit Response(IO& io)
         : _recvBuf()
         , _statusLine()
+        , _resLine()
+        , _customResLine()
         , _responseHeaders()
         , _body()
         , _responseHeadersIt(_responseHeaders.end())
         , _sendBuf()
+        , _pendingBuf()
         , _io{io}
     {
         // @todo 如果在乎客户端的性能, 就封装为模板, 然后提供 bool, 然后 constexpr if 解决
@@ -86,10 +96,12 @@ public:
         requires(utils::HasTimeNTTP<Timeout>)
     coroutine::Task<bool> parserRes() {
         for (std::size_t n = IO::kBufMaxSize; n; n = std::min(_parserRes(), IO::kBufMaxSize)) {
-            auto res = co_await _io.recvLinkTimeout<Timeout>(
-                // 保留原有的数据
-                {_recvBuf.data() + _recvBuf.size(),  _recvBuf.data() + n}
-            );
+            auto res = _recvBuf.isHold()
+                ? co_await _io.recvLinkTimeout<Timeout>(
+                    // 保留原有的数据
+                    std::span<char>{_recvBuf.data() + _recvBuf.size(),  _recvBuf.data() + n}
+                )
+                : co_await _io.recvLinkTimeout<Timeout>(_recvBuf);
             if (res.index() == 1) [[unlikely]] {
                 co_return false;  // 超时
             }
@@ -181,56 +193,89 @@ public:
 
     /**
      * @brief 发送已经设置的响应
+     * @note 流水线中之后还有已经到达的请求时, 响应会先积攒起来, 与之后的响应一次写入
      * @return coroutine::Task<> 
      */
     coroutine::Task<> sendRes() {
+        co_await FlushAwaiter{*this};
         createResponseBuffer();
-        co_await _io.fullySend(_sendBuf);
+        if (_isDeferSend && _pendingBuf.size() + _sendBuf.size() + _body.size() <= IO::kBufMaxSize) {
+            _pendingBuf.insert(_pendingBuf.end(), _sendBuf.begin(), _sendBuf.end());
+            _pendingBuf.insert(_pendingBuf.end(), _body.begin(), _body.end());
+            co_return;
+        }
+        // 响应头与响应体一次聚集写入, 响应体不需要拷贝; 大的响应体使用零拷贝发送
+        if (_pendingBuf.empty()) [[likely]] {
+            co_await _io.fullySendv<2>({_sendBuf, _body});
+            co_return;
+        }
+        co_await _io.fullySendv<3>({_pendingBuf, _sendBuf, _body});
+        _pendingBuf.clear();
     }
 
     /**
      * @brief 使用分块编码传输文件
+     * @note 文件大小已知时, 会改为使用`Content-Length`传输 (同 useRangeTransferFile 的普通传输, 可以零拷贝).
+     *       文件通过 FileCache 打开, 热门文件不需要每次都 open + stat + close
      * @param filePath 文件路径
      */
     coroutine::Task<> useChunkedEncodingTransferFile(std::string_view filePath) {
         using namespace std::string_literals;
+        using namespace std::string_view_literals;
         auto fileType = getMimeType(
             utils::FileUtils::getExtension(filePath)
         );
+        auto file = co_await FileCache::local().open(_io, filePath);
+        if (file->size) [[likely]] {
+            // 大小已知, 没有必要分块: 使用 Content-Length, 并且可以零拷贝发送
+            // (大小为 0 的可能是 /proc 之类的虚拟文件, 其大小未知, 仍然分块读取)
+            co_await _transferWholeFile(*file, fileType);
+            co_return;
+        }
         setResLine(Status::CODE_200);
         addHeader("Content-Type", fileType);
         addHeader("Transfer-Encoding", "chunked");
         // 生成响应行和响应头
         _buildResponseLineAndHeaders();
         // 先发送一版, 告知我们是分块编码
-        co_await _io.fullySend(_sendBuf);
-        
-        utils::AsyncFile file{_io};
-        co_await file.open(filePath);
-        try {
-            std::vector<char> buf(utils::FileUtils::kBufMaxSize);
+        co_await _sendHead();
+
+        // 响应头已经发出, 出错时不能吞掉异常 (否则客户端会在保活连接上等待不完整的响应体),
+        // 而是交给 ConnectionHandler 关闭连接
+        std::vector<char> buf(utils::FileUtils::kBufMaxSize);
+        for (uint64_t offset = 0;;) {
             // 读取文件
-            std::size_t size = static_cast<std::size_t>(co_await file.read(buf));
-            _buildToChunkedEncoding<true>(size);   // 朴素的版本: len\r\n
-            co_await _io.fullySend(_sendBuf);      // 发送
-            co_await _io.fullySend({buf.data(), size});           // 发送文件
-            for (;;) {
-                if (!size) [[unlikely]] {
-                    // 需要使用 长度为 0 的分块, 来标记当前内容实体传输结束
-                    _buildToChunkedEncoding<false, true>(0); // 发送完成的版本: \r\n0\r\n\r\n
-                    co_await _io.fullySend(_sendBuf);
-                    break;
-                }
-                size = static_cast<std::size_t>(co_await file.read(buf));
-                _buildToChunkedEncoding(size);         // 补充上次的头版本: \r\nlen\r\n
-                co_await _io.fullySend(_sendBuf);      // 发送
-                co_await _io.fullySend({buf.data(), size});           // 发送文件
+            std::size_t size = co_await _readFile(file->fd, buf, offset);
+            if (!size) [[unlikely]] {
+                // 需要使用 长度为 0 的分块, 来标记当前内容实体传输结束
+                co_await _io.fullySend("0\r\n\r\n"sv);
+                break;
             }
-        } catch (...) {
-            // _io.send 会抛异常
-            ;
+            offset += size;
+            co_await _sendChunk({buf.data(), size});
+        }
+    }
+
+    /**
+     * @brief 使用分块编码发送流式的响应体, 边生成边发送 (需要先设置响应行与响应头)
+     * @note 每个片段产出后立即作为一个分块发送 (分块头、数据、结尾的 \r\n 一次写入, 不拷贝),
+     *       因此慢的生产者 (如逐行等待数据库游标, 或者推送进度) 产出的数据不会被积攒; 空的片段会被跳过
+     * @param stream 产出响应体的片段, 片段只需要在生成器下一次恢复之前有效
+     */
+    coroutine::Task<> sendStream(coroutine::AsyncGenerator<std::span<char const>> stream) {
+        using namespace std::string_view_literals;
+        addHeader("Transfer-Encoding", "chunked");
+        _buildResponseLineAndHeaders();
+        co_await _sendHead();
+
+        while (auto data = co_await stream.next()) {
+            if (data->empty()) [[unlikely]] {
+                continue; // 长度为 0 的分块是结束标记
+            }
+            co_await _sendChunk(*data);
         }
-        co_await file.close();
+        // 长度为 0 的分块, 标记内容实体传输结束
+        co_await _io.fullySend("0\r\n\r\n"sv);
     }
 
 #if defined(__GNUC__) && !defined(__clang__)
@@ -241,7 +286,8 @@ public:
 
     /**
      * @brief 使用断点续传传输文件
-     * @note 内部会智能判断客户端是否需要使用断点续传, 最坏也只是降级为普通传输 (都是分块读和发的)
+     * @note 内部会智能判断客户端是否需要使用断点续传, 最坏也只是降级为普通传输 (都是分块读和发的).
+     *       文件通过 FileCache 打开, 热门文件不需要每次都 open + stat + close
      * @param rrv 断点续传参数包, 通过 `req.getRangeRequestView()` 获取
      * @param filePath 文件路径
      */
@@ -253,7 +299,8 @@ public:
         auto fileType = getMimeType(
             utils::FileUtils::getExtension(filePath)
         );
-        auto fileSize = utils::FileUtils::getFileSize(filePath);
+        auto file = co_await FileCache::local().open(_io, filePath);
+        auto fileSize = file->size;
         auto fileSizeStr = std::to_string(fileSize);
         auto const& headMap = rrv.reqHead;
         if (type == "HEAD"sv) {
@@ -268,9 +315,12 @@ public:
             addHeader("Content-Length", fileSizeStr);
             addHeader("Content-Type", fileType);
             addHeader("Accept-Ranges", "bytes");
+            _addFileValidators(*file);
             _buildResponseLineAndHeaders();
-            co_await _io.fullySend(_sendBuf);
-        } else if (auto it = headMap.find("range"); it != headMap.end()) {
+            co_await _sendHead();
+        } else if (auto it = headMap.find("range");
+                   it != headMap.end() && it->second.starts_with("bytes="sv) // 不认识的单位: 忽略 Range
+        ) {
             // 开始[断点续传]传输, 先发一下头
             /*
                 "HTTP/1.1 206 Partial Content\r\n"
@@ -290,53 +340,21 @@ public:
             addHeader("Accept-Ranges", "bytes");
 
             if (rangeNumArr.size() == 1) [[likely]] { // 一般都是请求单个范围
-                auto [begin, end] = utils::StringUtil::splitAtFirst(rangeNumArr.back(), "-"sv);
-                if (begin.empty()) {
-                    begin += '0';
-                }
-                if (end.empty()) {
-                    end = std::to_string(fileSize - 1);
-                }
-                uint64_t beginPos = std::stoull(begin);
-                uint64_t endPos = std::stoull(end);
-                if (beginPos > endPos || endPos > fileSize) [[unlikely]] {
-                    // 范围不合法: 返回416, 表示请求错误
-                    setResLine(Status::CODE_416);
-                    _buildResponseLineAndHeaders();
-                    co_await _io.fullySend(_sendBuf);
+                auto range = _parseRange(rangeNumArr.back(), fileSize);
+                if (!range) [[unlikely]] {
+                    co_await _sendRangeNotSatisfiable(fileSizeStr);
                     co_return ;
                 }
+                auto [beginPos, endPos] = *range;
                 uint64_t remaining = endPos - beginPos + 1;
-                addHeader("Content-Range", "bytes " + begin + "-" + end + "/" + fileSizeStr);
+                addHeader("Content-Range", "bytes " + std::to_string(beginPos) + "-"
+                    + std::to_string(endPos) + "/" + fileSizeStr);
                 addHeader("Content-Type", fileType);
                 addHeader("Content-Length", std::to_string(remaining));
+                _addFileValidators(*file);
                 _buildResponseLineAndHeaders();
-                co_await _io.fullySend(_sendBuf); // 先发一个头
-                
-                utils::AsyncFile file{_io};
-                co_await file.open(filePath);
-                try {
-                    file.setOffset(beginPos);
-                    std::vector<char> buf(std::min(fileSize, utils::FileUtils::kBufMaxSize));
-                    // 支持偏移量
-                    while (remaining > 0) {
-                        // 读取文件
-                        std::size_t size = static_cast<std::size_t>(
-                            co_await file.read(
-                                buf,
-                                static_cast<uint32_t>(std::min(remaining, buf.size()))
-                            )
-                        );
-                        if (!size) [[unlikely]] {
-                            break;
-                        }
-                        co_await _io.fullySend({buf.data(), size});
-                        remaining -= size;
-                    }
-                } catch (...) {
-                    ;
-                }
-                co_await file.close();
+                co_await _sendHead(); // 先发一个头
+                co_await _sendFileBody(file->fd, beginPos, remaining);
             } else {
                 /*
                     HTTP/1.1 206 Partial Content\r\n
@@ -356,98 +374,57 @@ public:
                     [BINARY DATA PART 2]\r\n
                     --BOUNDARY_STRING--\r\n
                 */
-                addHeader("Content-Type", "multipart/byteranges; boundary=BOUNDARY_STRING");
-                _buildResponseLineAndHeaders();
-                co_await _io.fullySend(_sendBuf); // 先发一个头
+                // 先生成每一段的头, 以便算出 Content-Length (否则保活的客户端无法知道响应体在哪里结束)
+                struct Part {
+                    uint64_t begin;
+                    uint64_t size;
+                    std::vector<char> head;
+                };
+                std::vector<Part> parts;
+                uint64_t bodyLen = "--BOUNDARY_STRING--\r\n"sv.size();
                 for (auto& ragen : rangeNumArr) {
-                    auto [begin, end] = utils::StringUtil::splitAtFirst(ragen, "-");
-                    if (begin.empty()) {
-                        begin += '0';
-                    }
-                    if (end.empty()) {
-                        end = std::to_string(fileSize - 1);
-                    }
-                    uint64_t beginPos = std::stoull(begin);
-                    uint64_t endPos = std::stoull(end);
+                    auto range = _parseRange(ragen, fileSize);
                     // 范围不合法: 不会报错, 而是忽略!
-                    if (beginPos > endPos || endPos > fileSize) [[unlikely]] {
+                    if (!range) [[unlikely]] {
                         continue;
                     }
-                    _sendBuf.clear();
-
+                    auto [beginPos, endPos] = *range;
                     uint64_t remaining = endPos - beginPos + 1;
-                    utils::StringUtil::append(_sendBuf, "--BOUNDARY_STRING\r\n"sv);
-                    utils::StringUtil::append(_sendBuf, "Content-Range: bytes "sv);
-                    utils::StringUtil::append(_sendBuf, begin);
-                    utils::StringUtil::append(_sendBuf, "-"sv);
-                    utils::StringUtil::append(_sendBuf, end);
-                    utils::StringUtil::append(_sendBuf, "/"sv);
-                    utils::StringUtil::append(_sendBuf, fileSizeStr);
-                    utils::StringUtil::append(_sendBuf, CRLF);
-                    utils::StringUtil::append(_sendBuf, "Content-Length: "sv);
-                    utils::StringUtil::append(_sendBuf, std::to_string(remaining));
-                    utils::StringUtil::append(_sendBuf, CRLF);
-                    utils::StringUtil::append(_sendBuf, "Content-Type: application/octet-stream\r\n"sv);
-                    utils::StringUtil::append(_sendBuf, CRLF);
-                    co_await _io.fullySend(_sendBuf); // 先发头
-
-                    utils::AsyncFile file{_io};
-                    co_await file.open(filePath);
-                    try {
-                        file.setOffset(beginPos);
-                        std::vector<char> buf(utils::FileUtils::kBufMaxSize);
-                        // 支持偏移量
-                        while (remaining > 0) {
-                            // 读取文件
-                            std::size_t size = static_cast<std::size_t>(
-                                co_await file.read(
-                                    buf,
-                                    static_cast<uint32_t>(std::min(remaining, buf.size()))
-                                )
-                            );
-                            if (!size) [[unlikely]] {
-                                break;
-                            }
-                            co_await _io.fullySend({buf.data(), size});
-                            co_await _io.fullySend(CRLF);
-                            remaining -= size;
-                        }
-                    } catch (...) {
-                        // _io.send 会抛异常
-                        ;
-                    }
-                    co_await file.close();
+                    std::vector<char> head;
+                    utils::StringUtil::append(head, "--BOUNDARY_STRING\r\n"sv);
+                    utils::StringUtil::append(head, "Content-Range: bytes "sv);
+                    utils::StringUtil::append(head, std::to_string(beginPos));
+                    utils::StringUtil::append(head, "-"sv);
+                    utils::StringUtil::append(head, std::to_string(endPos));
+                    utils::StringUtil::append(head, "/"sv);
+                    utils::StringUtil::append(head, fileSizeStr);
+                    utils::StringUtil::append(head, CRLF);
+                    utils::StringUtil::append(head, "Content-Length: "sv);
+                    utils::StringUtil::append(head, std::to_string(remaining));
+                    utils::StringUtil::append(head, CRLF);
+                    utils::StringUtil::append(head, "Content-Type: application/octet-stream\r\n"sv);
+                    utils::StringUtil::append(head, CRLF);
+                    bodyLen += head.size() + remaining + CRLF.size();
+                    parts.push_back({beginPos, remaining, std::move(head)});
+                }
+                if (parts.empty()) [[unlikely]] {
+                    co_await _sendRangeNotSatisfiable(fileSizeStr);
+                    co_return;
+                }
+                addHeader("Content-Type", "multipart/byteranges; boundary=BOUNDARY_STRING");
+                addHeader("Content-Length", std::to_string(bodyLen));
+                _buildResponseLineAndHeaders();
+                co_await _sendHead(); // 先发一个头
+                for (auto const& part : parts) {
+                    co_await _io.fullySend(part.head); // 先发头
+                    co_await _sendFileBody(file->fd, part.begin, part.size);
+                    co_await _io.fullySend(CRLF); // 该段的结尾
                 }
                 co_await _io.fullySend("--BOUNDARY_STRING--\r\n"sv);
             }
         } else {
             // 普通的传输文件
-            setResLine(Status::CODE_200);
-            addHeader("Content-Type"s, fileType);
-            addHeader("Content-Length"s, fileSizeStr);
-            _buildResponseLineAndHeaders();
-            co_await _io.fullySend(_sendBuf); // 先发一个头
-
-            utils::AsyncFile file{_io};
-            co_await file.open(filePath);
-            try {
-                std::vector<char> buf(std::min(fileSize, utils::FileUtils::kBufMaxSize));
-                uint64_t remaining = fileSize;
-                while (remaining > 0) {
-                    std::size_t size = static_cast<std::size_t>(
-                        co_await file.read(buf)
-                    );
-                    if (!size) [[unlikely]] {
-                        break;
-                    }
-                    co_await _io.fullySend({buf.data(), size});
-                    remaining -= size;
-                }
-            } catch (...) {
-                // _io.send 会抛异常
-                ;
-            }
-            co_await file.close();
+            co_await _transferWholeFile(*file, fileType);
         }
     }
 
@@ -460,20 +437,23 @@ public:
     // ===== ↓服务端使用↓ =====
     /**
      * @brief 设置状态行 (协议使用HTTP/1.1)
+     * @note 使用默认描述时, 直接指向预先生成的响应行, 不需要拼接
      * @param statusCode 状态码
      * @param describe 状态码描述: 如果为`""`则会使用该状态码对应默认的描述
      * @warning 不需要手动写`/r`或`/n`以及尾部的`/r/n`
      */
     Response& setResLine(Status statusCode, std::string_view describe = "") {
         using namespace std::string_view_literals;
-        _statusLine.clear();
-        _statusLine.resize(3);
-        _statusLine[ResponseLineDataType::ProtocolVersion] = "HTTP/1.1";
-        _statusLine[ResponseLineDataType::StatusCode] = std::to_string(static_cast<int>(statusCode));
-        if (!describe.size()) {
-            _statusLine[ResponseLineDataType::StatusMessage] = getStatusCodeDataStrView(statusCode);
-        } else {
-            _statusLine[ResponseLineDataType::StatusMessage] = describe;
+        _resLine = describe.empty() ? getStatusLineStrView(statusCode) : std::string_view{};
+        if (_resLine.empty()) [[unlikely]] {
+            // 自定义的描述, 或者未知的状态码
+            _customResLine.clear();
+            _customResLine += internal::kStatusLineVersion;
+            _customResLine += std::to_string(static_cast<int>(statusCode));
+            _customResLine += ' ';
+            _customResLine += describe.empty() ? getStatusCodeDataStrView(statusCode) : describe;
+            _customResLine += CRLF;
+            _resLine = _customResLine;
         }
         return *this;
     }
@@ -532,6 +512,8 @@ public:
         _responseHeadersIt = _responseHeaders.end();
         _sendBuf.clear();
         _completeResponseHeader = false;
+        _isDeferSend = false;
+        _resLine = {};
     }
 
     /**
@@ -552,12 +534,14 @@ private:
     };
     
     /**
-     * @brief 仅用于读取时候写入的缓冲区
+     * @brief 仅用于读取时候写入的缓冲区 (仅客户端使用, 服务端不会持有内存)
      */
-    container::ArrayBuf<char, IO::kBufMaxSize> _recvBuf;
+    RecvBuf _recvBuf;
 
     // 注意: 他们的末尾并没有事先包含 \r\n, 具体在to_string才提供
-    std::vector<std::string> _statusLine; // 状态行
+    std::vector<std::string> _statusLine; // [客户端] 状态行
+    std::string_view _resLine;            // [服务端] 响应行 (含 `\r\n`), 指向预先生成的或者 _customResLine
+    std::string _customResLine;           // [服务端] 自定义描述的响应行
     HeaderHashMap _responseHeaders;       // 响应头
     std::string _body;                    // 响应体
 
@@ -565,11 +549,97 @@ private:
     decltype(_responseHeaders)::iterator _responseHeadersIt; 
 
     std::vector<char> _sendBuf;                     // 用于发送数据的缓冲区
+    std::vector<char> _pendingBuf;                  // [服务端] 推迟发送的 (流水线的) 响应, 按顺序排列
     std::optional<std::size_t> _remainingBodyLen;   // 仍需读取的请求体长度
     IO& _io;
     bool _completeResponseHeader = false;           //是否解析完成响应头
+    bool _isDeferSend = false;                      // [服务端] sendRes() 是否推迟发送 (之后还有已经到达的请求)
+    bool _isFlushing = false;                       // [服务端] _flushPendingOnSuspend() 是否正在发送
+    std::coroutine_handle<> _flushWaiter{};         // [服务端] 等待它发送完毕的端点
 
     friend class WebSocketFactory;
+    friend struct ConnectionHandler;
+
+    /**
+     * @brief [仅服务端] 发送积攒的响应
+     */
+    coroutine::Task<> _flushPending() {
+        if (_pendingBuf.empty()) {
+            co_return;
+        }
+        co_await _io.fullySend(_pendingBuf);
+        _pendingBuf.clear();
+    }
+
+    /**
+     * @brief [仅服务端] 请求不合法时回复错误码, 并告知客户端将断开连接; 之前积攒的响应一并写入
+     * @note 端点已经开始发送这个请求的响应 (_sendBuf 非空) 时无法再回复, 只发出积攒的响应
+     * @param status 错误码
+     */
+    coroutine::Task<> _sendError(Status status) {
+        if (_sendBuf.size()) [[unlikely]] {
+            co_await _flushPending();
+            co_return;
+        }
+        clear();
+        setResLine(status);
+        addHeader("Connection", "close");
+        co_await sendRes();
+    }
+
+    /**
+     * @brief [仅服务端] 端点挂起 (等待 IO) 时, 先把之前积攒的响应发出去, 而不是让它们等到端点结束
+     * @note 与端点一起由 whenAll 启动, 因此端点第一次挂起 (或者结束) 之后才会执行到这里;
+     *       端点已经开始发送自己的响应 (积攒的响应会一并写入) 时什么也不做.
+     *       发送期间端点要发送响应的话, 会在 FlushAwaiter 处等待, 以保证响应的顺序
+     */
+    coroutine::Task<> _flushPendingOnSuspend() {
+        if (_pendingBuf.empty() || !_sendBuf.empty()) {
+            co_return;
+        }
+        _isFlushing = true;
+        std::exception_ptr err;
+        try {
+            co_await _io.fullySend(_pendingBuf);
+        } catch (...) {
+            err = std::current_exception();
+        }
+        _pendingBuf.clear();
+        _isFlushing = false;
+        if (auto waiter = std::exchange(_flushWaiter, {})) {
+            waiter.resume();
+        }
+        if (err) [[unlikely]] {
+            std::rethrow_exception(err);
+        }
+    }
+
+    /**
+     * @brief [仅服务端] 等待 _flushPendingOnSuspend 发送完毕
+     */
+    struct FlushAwaiter {
+        bool await_ready() const noexcept {
+            return !_res._isFlushing;
+        }
+        void await_suspend(std::coroutine_handle<> coroutine) const noexcept {
+            _res._flushWaiter = coroutine;
+        }
+        constexpr void await_resume() const noexcept {}
+        Response& _res;
+    };
+
+    /**
+     * @brief [仅服务端] 发送已经生成的响应头 (_sendBuf), 之前积攒的响应一并写入
+     */
+    coroutine::Task<> _sendHead() {
+        co_await FlushAwaiter{*this};
+        if (_pendingBuf.empty()) [[likely]] {
+            co_await _io.fullySend(_sendBuf);
+            co_return;
+        }
+        co_await _io.fullySendv<2>({_pendingBuf, _sendBuf});
+        _pendingBuf.clear();
+    }
 
     /**
      * @brief [仅服务端] 生成响应行和响应头
@@ -584,15 +654,29 @@ private:
 #endif
         using namespace std::string_literals;
         using namespace std::string_view_literals;
-        _responseHeaders.try_emplace("Connection", "keep-alive"); // 长连接
-        _responseHeaders.try_emplace("Server", "HXLibs::net");
-        
-        utils::StringUtil::append(_sendBuf, _statusLine[ResponseLineDataType::ProtocolVersion]);
-        utils::StringUtil::append(_sendBuf, " "sv);
-        utils::StringUtil::append(_sendBuf, _statusLine[ResponseLineDataType::StatusCode]);
-        utils::StringUtil::append(_sendBuf, " "sv);
-        utils::StringUtil::append(_sendBuf, _statusLine[ResponseLineDataType::StatusMessage]);
-        utils::StringUtil::append(_sendBuf, CRLF);
+        utils::StringUtil::append(_sendBuf, _resLine);
+        // 默认的响应头 (长连接, 服务器, 日期) 已经预先拼接好; 被用户设置的则不使用默认的
+        auto& dateCache = DateCache::local();
+        // 用户可能以任意大小写设置, 因此不区分大小写地查找 (响应头很少, 直接遍历)
+        bool hasConnection = false, hasServer = false, hasDate = false;
+        for (auto const& [key, _] : _responseHeaders) {
+            hasConnection |= RequestHeaderView::equalsIgnoreCase(key, CONNECTION_SV);
+            hasServer |= RequestHeaderView::equalsIgnoreCase(key, "server"sv);
+            hasDate |= RequestHeaderView::equalsIgnoreCase(key, "date"sv);
+        }
+        if (!hasConnection && !hasServer && !hasDate) [[likely]] {
+            utils::StringUtil::append(_sendBuf, dateCache.getHeaders());
+        } else {
+            if (!hasConnection) {
+                utils::StringUtil::append(_sendBuf, "Connection: keep-alive\r\n"sv);
+            }
+            if (!hasServer) {
+                utils::StringUtil::append(_sendBuf, "Server: HXLibs::net\r\n"sv);
+            }
+            if (!hasDate) {
+                utils::StringUtil::append(_sendBuf, dateCache.getDateHeader());
+            }
+        }
         for (const auto& [key, val] : _responseHeaders) {
             utils::StringUtil::append(_sendBuf, key);
             utils::StringUtil::append(_sendBuf, HEADER_SEPARATOR_SV);
@@ -605,29 +689,147 @@ private:
     }
 
     /**
-     * @brief [仅服务端] 把 size 大小转换为 16 进制并以符合 ChunkedEncoding 的格式写入 _sendBuf
+     * @brief [仅服务端] 添加文件的验证器 (ETag 与 Last-Modified, 已经在 FileCache 中预先生成)
+     * @param file 
+     */
+    void _addFileValidators(CachedFile const& file) {
+        addHeader("ETag", file.etag);
+        addHeader("Last-Modified", file.lastModified);
+    }
+
+    /**
+     * @brief [仅服务端] 范围不合法: 返回416, 表示请求错误
+     * @note 需要带上长度, 否则保活的客户端会一直等待响应体
+     * @param fileSizeStr 文件大小
+     */
+    coroutine::Task<> _sendRangeNotSatisfiable(std::string const& fileSizeStr) {
+        setResLine(Status::CODE_416);
+        addHeader("Content-Range", "bytes */" + fileSizeStr);
+        addHeader("Content-Length", "0");
+        _buildResponseLineAndHeaders();
+        co_await _sendHead();
+    }
+
+    /**
+     * @brief [仅服务端] 解析 Range 中的一个范围: `first-last`, `first-` 或 `-suffixLength` (RFC 7233)
+     * @param spec 范围 (可以有前后空格)
+     * @param fileSize 文件大小
+     * @return std::optional<std::pair<uint64_t, uint64_t>> 闭区间 [first, last], last 超出文件时截断到文件末尾;
+     *         格式错误或不可满足 (first 不小于文件大小) 时为空
+     */
+    static std::optional<std::pair<uint64_t, uint64_t>> _parseRange(
+        std::string_view spec,
+        uint64_t fileSize
+    ) noexcept {
+        auto parse = [](std::string_view sv, uint64_t& val) noexcept {
+            auto [ptr, ec] = std::from_chars(sv.data(), sv.data() + sv.size(), val);
+            return !sv.empty() && ec == std::errc{} && ptr == sv.data() + sv.size();
+        };
+        auto l = spec.find_first_not_of(' ');
+        if (l == std::string_view::npos) [[unlikely]] {
+            return {};
+        }
+        spec = spec.substr(l, spec.find_last_not_of(' ') - l + 1);
+        auto pos = spec.find('-');
+        if (pos == std::string_view::npos || !fileSize) [[unlikely]] {
+            return {};
+        }
+        uint64_t first, last;
+        if (pos == 0) { // 后缀: 最后 n 个字节
+            if (!parse(spec.substr(1), last) || !last) [[unlikely]] {
+                return {};
+            }
+            return std::pair{fileSize - std::min(last, fileSize), fileSize - 1};
+        }
+        if (!parse(spec.substr(0, pos), first) || first >= fileSize) [[unlikely]] {
+            return {};
+        }
+        if (pos + 1 == spec.size()) {
+            last = fileSize - 1;
+        } else if (!parse(spec.substr(pos + 1), last) || last < first) [[unlikely]] {
+            return {};
+        }
+        return std::pair{first, std::min(last, fileSize - 1)};
+    }
+
+    /**
+     * @brief [仅服务端] 以`Content-Length`传输整个文件
+     * @param file 已经打开的文件
+     * @param fileType 文件的 MIME 类型
+     */
+    coroutine::Task<> _transferWholeFile(
+        CachedFile const& file,
+        std::string_view fileType
+    ) {
+        setResLine(Status::CODE_200);
+        addHeader("Content-Type", fileType);
+        addHeader("Content-Length", std::to_string(file.size));
+        _addFileValidators(file);
+        _buildResponseLineAndHeaders();
+        co_await _sendHead(); // 先发一个头
+        co_await _sendFileBody(file.fd, 0, file.size);
+    }
+
+    /**
+     * @brief [仅服务端] 读取文件的 offset 处到 buf
+     * @return std::size_t 读取的字节数, 0 为文件结尾
+     */
+    coroutine::Task<std::size_t> _readFile(platform::LocalFdType fd, std::span<char> buf, uint64_t offset) {
+        co_return static_cast<std::size_t>(HXLIBS_CHECK_EVENT_LOOP(
+            co_await static_cast<coroutine::EventLoop&>(_io).makeAioTask().prepRead(fd, buf, offset)
+        ));
+    }
+
+    /**
+     * @brief [仅服务端] 发送文件的 [offset, offset + size) 作为响应体 (响应头需要已经发送)
+     * @note 优先使用 splice 零拷贝发送; 不支持时 (如部分文件系统) 回退为分块读取再发送.
+     *       使用带偏移量的读, 不改变文件的状态, 因此同一个 (缓存的) 文件可以同时被多个响应使用
+     * @throw 发送失败, 或文件比预期的短 (如被截断): 响应头已经发出, 调用方需要关闭连接
+     */
+    coroutine::Task<> _sendFileBody(platform::LocalFdType fd, uint64_t offset, uint64_t size) {
+        if (co_await _io.sendFile(fd, offset, size)) [[likely]] {
+            co_return;
+        }
+        std::vector<char> buf(std::min<uint64_t>(size, utils::FileUtils::kBufMaxSize));
+        while (size > 0) {
+            std::size_t n = co_await _readFile(
+                fd, {buf.data(), static_cast<std::size_t>(std::min<uint64_t>(size, buf.size()))}, offset);
+            if (!n) [[unlikely]] {
+                throw std::runtime_error{"The file is shorter than expected"};
+            }
+            co_await _io.fullySend({buf.data(), n});
+            offset += n;
+            size -= n;
+        }
+    }
+
+    /**
+     * @brief [仅服务端] 以一个分块发送数据 (分块头、数据、结尾的 \r\n 一次写入)
+     * @param data 不能为空, 否则会被当作结束标记
+     */
+    coroutine::Task<> _sendChunk(std::span<char const> data) {
+        _buildToChunkedEncoding(data.size()); // len\r\n
+        co_await _io.fullySendv<3>({_sendBuf, data, CRLF});
+    }
+
+    /**
+     * @brief [仅服务端] 把 size 大小转换为 16 进制并以符合 ChunkedEncoding 的分块头格式 (`len\r\n`) 写入 _sendBuf
      * @param size 内容大小
      * @warning 内部会清空 `_sendBuf`, 再以`ChunkedEncoding`格式写入 buf 到 `_sendBuf`!
      */
-    template <bool IsFirst = false, bool IsEnd = false>
     void _buildToChunkedEncoding(std::size_t size) {
         _sendBuf.clear();
-        if constexpr (!IsFirst) {
-            utils::StringUtil::append(_sendBuf, CRLF);
-        }
 #ifdef HEXADECIMAL_CONVERSION
         utils::StringUtil::append(_sendBuf, utils::NumericBaseConverter::hexadecimalConversion(size));
 #else
         utils::StringUtil::append(_sendBuf, std::format("{:X}", size)); // 需要十六进制嘞
 #endif // !HEXADECIMAL_CONVERSION
         utils::StringUtil::append(_sendBuf, CRLF);
-        if constexpr (IsEnd) {
-            utils::StringUtil::append(_sendBuf, CRLF);
-        }
     }
 
     /**
-     * @brief [仅服务端] 生成完整的响应字符串, 用于写入
+     * @brief [仅服务端] 生成响应行与响应头 (含`Content-Length`), 用于写入
+     * @note 响应体不会拷贝进 _sendBuf, 而是由 sendRes 与 _sendBuf 一起聚集写入
      * @warning 本方法子适用于`Content-Length`的短消息, 无法使用分块编码
      */
     void createResponseBuffer() {
@@ -640,7 +842,6 @@ private:
         utils::StringUtil::append(_sendBuf, CRLF);
 
         utils::StringUtil::append(_sendBuf, CRLF);
-        utils::StringUtil::append(_sendBuf, std::move(_body));
     }
 
     /**
@@ -682,30 +883,38 @@ private:
             case 0x01: { // 响应头
                 /**
                  * @brief 请求头
-                 * 通过`\r\n`分割后, 取最前面的, 先使用最左的`:`以判断是否是需要作为独立的键值对;
+                 * 由 internal::LineScanner 找出所有的行与每行最左的`:`, 以判断是否是需要作为独立的键值对;
                  * -  如果找不到`:`, 并且 非空, 那么它需要接在上一个解析的键值对的值尾
                  * -  否则即请求头解析完毕!
                  */
-                while (!_completeResponseHeader) { // 响应头未解析完
-                    std::size_t pos = buf.find(CRLF);
-                    if (pos == std::string_view::npos) { // 没有读取完
-                        _recvBuf.moveToHead(buf);
-                        return IO::kBufMaxSize;
-                    }
-                    std::string_view subKVStr = buf.substr(0, pos);
-                    auto p = utils::StringUtil::splitAtFirst(subKVStr, HEADER_SEPARATOR_SV);
-                    if (p.first.empty()) {                  // 找不到 ": "
-                        if (subKVStr.size()) [[unlikely]] { // 很少会有分片传输响应头的
-                            _responseHeadersIt->second.append(subKVStr);
-                        } else { // 请求头解析完毕!
+                internal::LineScanner scanner{buf, 0};
+                for (internal::HeaderLine line; scanner.next(line);) {
+                    std::string_view subKVStr = buf.substr(line.begin, line.end - line.begin);
+                    if (line.colon == std::string_view::npos) { // 找不到 ":"
+                        if (subKVStr.empty()) { // 请求头解析完毕!
                             _completeResponseHeader = true;
+                            break;
                         }
-                    } else {
-                        // K: V, 其中 V 是区分大小写的, 但是 K 是不区分的
-                        utils::StringUtil::toLower(p.first);
-                        _responseHeadersIt = _responseHeaders.insert(p).first;
+                        if (_responseHeadersIt != _responseHeaders.end()) [[likely]] { // 很少会有分片传输响应头的
+                            _responseHeadersIt->second.append(subKVStr);
+                        }
+                        continue;
                     }
-                    buf = buf.substr(pos + 2); // 再前进, 以去掉 "\r\n"
+                    // K: V, 其中 V 是区分大小写的, 但是 K 是不区分的
+                    std::string key{buf.substr(line.begin, line.colon - line.begin)};
+                    utils::StringUtil::toLower(key);
+                    std::string_view val = buf.substr(line.colon + 1, line.end - line.colon - 1);
+                    val.remove_prefix(std::min(val.find_first_not_of(" \t"), val.size()));
+                    _responseHeadersIt = _responseHeaders.emplace(std::move(key), val).first;
+                }
+                if (scanner.isError()) [[unlikely]] {
+                    throw std::runtime_error{"Invalid response header"};
+                }
+                std::size_t const pos = scanner.pos();
+                buf = buf.substr(pos);
+                if (!_completeResponseHeader) { // 没有读取完
+                    _recvBuf.moveToHead(buf);
+                    return IO::kBufMaxSize;
                 }
                 [[fallthrough]];
             }
@@ -713,7 +922,12 @@ private:
                 if (_responseHeaders.contains(CONTENT_LENGTH_SV)) { // 存在content-length模式接收的响应体
                     // 是 空行之后 (\r\n\r\n) 的内容大小(char)
                     if (!_remainingBodyLen.has_value()) {
-                        _remainingBodyLen = std::stoull(_responseHeaders.find(CONTENT_LENGTH_SV)->second);
+                        _remainingBodyLen = internal::parseContentLength(
+                            _responseHeaders.find(CONTENT_LENGTH_SV)->second
+                        );
+                        if (!_remainingBodyLen) [[unlikely]] {
+                            throw std::runtime_error{"Invalid Content-Length"};
+                        }
                     }
                     if (*_remainingBodyLen != 0) {
                         *_remainingBodyLen -= buf.size();
@@ -745,9 +959,10 @@ private:
                             buf = buf.substr(posLen + 2);
                             continue;
                         }
-                        _remainingBodyLen = utils::NumericBaseConverter::strToNum<std::size_t, 16>(
-                            buf.substr(0, posLen)
-                        ); // 转换为十进制整数
+                        _remainingBodyLen = internal::parseChunkSize(buf.substr(0, posLen));
+                        if (!_remainingBodyLen) [[unlikely]] {
+                            throw std::runtime_error{"Invalid chunk size"};
+                        }
                         if (!*_remainingBodyLen) { // 解析完毕
                             return 0;
                         }
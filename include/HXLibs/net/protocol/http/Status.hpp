@@ -18,6 +18,8 @@
  * limitations under the License.
  */
 
+#include <array>
+#include <cstdint>
 #include <string_view>
 
 namespace HX::net {
@@ -164,5 +166,75 @@ inline constexpr std::string_view getStatusCodeDataStrView(Status statusCode) {
     return ""sv;
 }
 
+namespace internal {
+
+inline constexpr std::string_view kStatusLineVersion{"HTTP/1.1 "};
+inline constexpr int kStatusCodeMin = 100;
+inline constexpr int kStatusCodeMax = 599;
+
+/**
+ * @brief 所有已知状态码的响应行的总长度
+ */
+inline constexpr std::size_t kStatusLineTableSize = [] {
+    std::size_t n = 0;
+    for (int code = kStatusCodeMin; code <= kStatusCodeMax; ++code) {
+        if (auto msg = getStatusCodeDataStrView(static_cast<Status>(code)); msg.size()) {
+            n += kStatusLineVersion.size() + 4 + msg.size() + 2; // `200 ` + 描述 + `\r\n`
+        }
+    }
+    return n;
+}();
+
+/**
+ * @brief 编译期生成的所有响应行, 如 `HTTP/1.1 200 OK\r\n`, 紧密排列
+ */
+struct StatusLineTable {
+    std::array<char, kStatusLineTableSize> data;
+    std::array<uint16_t, kStatusCodeMax - kStatusCodeMin + 2> offset; // 状态码 code 的响应行为 [offset[i], offset[i + 1])
+};
+
+inline constexpr StatusLineTable kStatusLineTable = [] {
+    StatusLineTable table{};
+    std::size_t pos = 0;
+    auto append = [&](std::string_view sv) {
+        for (char c : sv) {
+            table.data[pos++] = c;
+        }
+    };
+    for (int code = kStatusCodeMin; code <= kStatusCodeMax; ++code) {
+        table.offset[static_cast<std::size_t>(code - kStatusCodeMin)] = static_cast<uint16_t>(pos);
+        auto msg = getStatusCodeDataStrView(static_cast<Status>(code));
+        if (msg.empty()) {
+            continue;
+        }
+        append(kStatusLineVersion);
+        table.data[pos++] = static_cast<char>('0' + code / 100);
+        table.data[pos++] = static_cast<char>('0' + code / 10 % 10);
+        table.data[pos++] = static_cast<char>('0' + code % 10);
+        table.data[pos++] = ' ';
+        append(msg);
+        append("\r\n");
+    }
+    table.offset.back() = static_cast<uint16_t>(pos);
+    return table;
+}();
+
+} // namespace internal
+
+/**
+ * @brief 获取预先生成的响应行 (协议为 HTTP/1.1)
+ * @param statusCode 响应状态码
+ * @return constexpr std::string_view 如 `HTTP/1.1 200 OK\r\n`; 未知的状态码为空
+ */
+inline constexpr std::string_view getStatusLineStrView(Status statusCode) {
+    int code = static_cast<int>(statusCode);
+    if (code < internal::kStatusCodeMin || code > internal::kStatusCodeMax) [[unlikely]] {
+        return {};
+    }
+    auto const& table = internal::kStatusLineTable;
+    auto i = static_cast<std::size_t>(code - internal::kStatusCodeMin);
+    return {table.data.data() + table.offset[i], static_cast<std::size_t>(table.offset[i + 1] - table.offset[i])};
+}
+
 } // namespace HX::net
 
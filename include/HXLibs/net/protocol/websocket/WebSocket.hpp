@@ -31,6 +31,9 @@
 #include <HXLibs/reflection/json/JsonWrite.hpp>
 
 #include <random>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
 
 namespace HX::net {
 
@@ -397,13 +400,9 @@ private:
     >
         requires(utils::HasTimeNTTP<Timeout>)
     coroutine::Task<Res> recvLinkTimeout(std::span<char> buf) {
-        auto size = _recvBuf.size();
-        if (size) [[unlikely]] {
-            for (char& c : buf) {
-                c = _recvBuf.back();
-                _recvBuf.pop_back();
-            }
-            if (size >= buf.size()) {
+        if (_recvBuf.size()) [[unlikely]] {
+            auto size = popRecvBuf(buf);
+            if (size == buf.size()) {
                 Res res;
                 res.template emplace<0>(static_cast<
                     coroutine::AwaiterReturnValue<coroutine::AioTask>
@@ -414,8 +413,44 @@ private:
             // 但是不保证日后!
             co_return co_await _io.recvLinkTimeout<Timeout>(buf.subspan(size));
         } else {
-            co_return co_await _io.recvLinkTimeout<Timeout>(buf);
+            // 等待下一帧时不持有接收内存, 数据到达时才获取缓冲区 (provided buffer ring)
+            // 多读取的部分放入 _recvBuf, 然后立即归还缓冲区
+            RecvBuf recvBuf;
+            auto res = co_await _io.recvLinkTimeout<Timeout>(recvBuf);
+            if (res.index() == 0) [[likely]] {
+                auto recvN = res.template get<0, exception::ExceptionMode::Nothrow>();
+                if (recvN > 0) [[likely]] {
+                    auto len = static_cast<std::size_t>(recvN);
+                    auto size = std::min(len, buf.size());
+                    std::memcpy(buf.data(), recvBuf.data(), size);
+                    _recvBuf.assign(
+                        std::reverse_iterator{recvBuf.data() + len},
+                        std::reverse_iterator{recvBuf.data() + size}
+                    );
+                    res.template emplace<0>(static_cast<
+                        coroutine::AwaiterReturnValue<coroutine::AioTask>
+                    >(size));
+                }
+            }
+            co_return res;
+        }
+    }
+
+    /**
+     * @brief 从 _recvBuf 中取出数据到 buf 的头部, _recvBuf 取空时释放其内存
+     * @param buf 
+     * @return std::size_t 取出的字节数
+     */
+    std::size_t popRecvBuf(std::span<char> buf) {
+        auto size = std::min(_recvBuf.size(), buf.size());
+        for (char& c : buf.subspan(0, size)) {
+            c = _recvBuf.back();
+            _recvBuf.pop_back();
         }
+        if (_recvBuf.empty()) {
+            _recvBuf.shrink_to_fit();
+        }
+        return size;
     }
 
     /**
@@ -440,13 +475,9 @@ private:
      * @return coroutine::Task<> 
      */
     coroutine::Task<> fullyRecv(std::span<char> buf) {
-        auto size = _recvBuf.size();
-        if (size) [[unlikely]] {
-            for (char& c : buf) {
-                c = _recvBuf.back();
-                _recvBuf.pop_back();
-            }
-            if (size >= buf.size()) {
+        if (_recvBuf.size()) [[unlikely]] {
+            auto size = popRecvBuf(buf);
+            if (size == buf.size()) {
                 co_return;
             }
             co_await _io.fullyRecv(buf.subspan(size));
@@ -720,7 +751,9 @@ public:
      */
     static coroutine::Task<WebSocketServer> accept(Request& req, Response& res) {
         using namespace std::string_literals;
-        auto const& headMap = req.getHeaders();
+        // 升级后不再是 HTTP, 响应不能推迟发送
+        res._isDeferSend = false;
+        auto const& headMap = req.getHeadersView();
         if (headMap.find("origin") == headMap.end()) {
             // Origin字段是必须的
             // 如果缺少origin字段, WebSocket服务器需要回复HTTP 403 状态码
@@ -754,18 +787,19 @@ public:
                     .addHeader("Connection", "keep-alive, Upgrade")
                     .addHeader("Upgrade", "websocket")
                     .addHeader("Sec-Websocket-Accept", 
-                               internal::webSocketSecretHash(wsKey->second))
+                               internal::webSocketSecretHash(std::string{wsKey->second}))
                     .sendRes();
 
         co_return {req._io, [&]{
-            // 缓存迁移
+            // 缓存迁移 (请求头之后多读取的内容), 然后归还请求的接收缓冲区
             std::vector<char> buf;
-            std::size_t n = res._recvBuf.size();
+            std::size_t n = req._recvBuf.size();
             buf.resize(n);
-            auto* data = res._recvBuf.data();
+            auto* data = req._recvBuf.data();
             for (std::size_t i = 0, j = n - 1; i < n; ++i, --j) {
                 buf[i] = data[j];
             }
+            req._releaseRecvBuf();
             return buf;
         }()};
     }
@@ -36,25 +36,24 @@ public:
     Router& operator=(Router&&) = delete;
 
     /**
-     * @brief 获取路由
-     * @param method 
-     * @param path 
+     * @brief 获取路由, 并将路径参数写入请求
+     * @param req 已解析请求头的请求
      * @return EndpointFunc 
      */
-    const EndpointFunc& getEndpoint(
-        std::string_view method,
-        std::string_view path
-    ) const {
-        auto findLink = utils::StringUtil::split<std::string_view>(
-            path, 
-            "/", 
-            {method}
+    const EndpointFunc& getEndpoint(Request& req) const {
+        return _routerTree.find(
+            req.getReqType(),
+            req.getPureReqPathView(),
+            req._pathParams
         );
-        if (path.back() == '/') { // 为了适配 /** 的情况
-            findLink.emplace_back("");
-            return _routerTree.find<true>(findLink);
-        }
-        return _routerTree.find(findLink);
+    }
+
+    /**
+     * @brief 编译已添加的端点, 之后才能通过 getEndpoint() 找到它们
+     * @warning 需要在开始处理请求 (如服务器启动) 之前调用
+     */
+    void compile() {
+        _routerTree.compile();
     }
 
     /**
@@ -128,112 +127,28 @@ private:
         typename... Interceptors>
     void _addEndpoint(std::string_view path, Func endpoint, Interceptors&&... interceptors) {
         using namespace std::string_view_literals;
-        auto isResolvePathVariable = path.find_first_of("{"sv) != std::string_view::npos;
-        auto isParseWildcardPath = path.find("/**"sv) != std::string_view::npos;
-        std::function<coroutine::Task<>(
-            Request &, Response &)> realEndpoint;
-        switch (static_cast<int>(isResolvePathVariable) | (isParseWildcardPath << 1)) {
-            case 0x0: // 不解析任何参数
-                realEndpoint = [this, endpoint = std::move(endpoint),
-                                ... interceptors = interceptors](
-                                   Request &req,
-                                   Response &res) mutable
-                    -> coroutine::Task<> {
-                    static_cast<void>(this);
-                    bool ok = true;
-                    static_cast<void>((doBefore(interceptors, ok, req, res) && ...));
-                    if (ok) {
-                        co_await endpoint(req, res);
-                    }
-                    ok = true;
-                    static_cast<void>((doAfter(interceptors, ok, req, res) && ...));
-                };
-                break;
-            case 0x1: { // 仅解析{}参数
-                auto indexArr = RequestTemplateParsing::getPathWildcardAnalysisArr(path);
-                realEndpoint = [this, endpoint = std::move(endpoint),
-                                indexArr = std::move(indexArr),
-                                ... interceptors = interceptors](
-                                   Request &req,
-                                   Response &res) mutable
-                    -> coroutine::Task<> {
-                    static_cast<void>(this);
-                    bool ok = true;
-                    auto pureRequesPath = req.getPureReqPath();
-                    auto pathSplitArr = utils::StringUtil::split<std::string_view>(pureRequesPath, "/");
-                    std::vector<std::string_view> wildcarArr;
-                    for (auto idx : indexArr) {
-                        wildcarArr.emplace_back(pathSplitArr[idx]);
-                    }
-                    req._wildcarDataArr = wildcarArr;
-                    static_cast<void>((doBefore(interceptors, ok, req, res) && ...));
-                    if (ok) {
-                        co_await endpoint(req, res);
-                    }
-                    ok = true;
-                    static_cast<void>((doAfter(interceptors, ok, req, res) && ...));
-                };
-                break;
-            }
-            case 0x2: {// 仅解析通配符
-                auto UWPIndex = path.find("/**"sv);
-                realEndpoint = [this, endpoint = std::move(endpoint), UWPIndex,
-                                ... interceptors = interceptors](
-                                   Request &req,
-                                   Response &res) mutable
-                    -> coroutine::Task<> {
-                    static_cast<void>(this);
-                    bool ok = true;
-                    auto pureRequesPath = req.getPureReqPath();
-                    std::string_view pureRequesPathView = pureRequesPath;
-                    req._urlWildcardData = pureRequesPathView.substr(UWPIndex);
-                    static_cast<void>((doBefore(interceptors, ok, req, res) && ...));
-                    if (ok) {
-                        co_await endpoint(req, res);
-                    }
-                    ok = true;
-                    static_cast<void>((doAfter(interceptors, ok, req, res) && ...));
-                };
-                break;
+        // 路径参数与通配符已经在匹配路由时写入 req._pathParams;
+        // 同时含有`{val}`与`/**`时, 通配符的结果不含开头的`/`
+        bool isTrimWildcard = path.find('{') != std::string_view::npos
+                           && path.find("/**"sv) != std::string_view::npos;
+        EndpointFunc realEndpoint = [this, endpoint = std::move(endpoint), isTrimWildcard,
+                                     ... interceptors = interceptors](
+                                        Request &req,
+                                        Response &res) mutable
+            -> coroutine::Task<> {
+            static_cast<void>(this);
+            if (isTrimWildcard && !req._pathParams.wildcard.empty()) {
+                req._pathParams.wildcard.remove_prefix(1);
             }
-            case 0x3: { // 全都要解析
-                auto indexArr = RequestTemplateParsing::getPathWildcardAnalysisArr(path);
-                auto UWPIndex = RequestTemplateParsing::getUniversalWildcardPathBeginIndex(path);
-                realEndpoint = [this, endpoint = std::move(endpoint),
-                                indexArr = std::move(indexArr), UWPIndex,
-                                ... interceptors = interceptors](
-                                   Request &req,
-                                   Response &res) mutable
-                    -> coroutine::Task<> {
-                    static_cast<void>(this);
-                    bool ok = true;
-                    auto pureRequesPath = req.getPureReqPath();
-                    std::string_view pureRequesPathView = pureRequesPath;
-                    auto pathSplitArr = utils::StringUtil::splitWithPos<std::string_view>(pureRequesPathView, "/");
-                    std::vector<std::string_view> wildcarArr;
-                    for (auto idx : indexArr) {
-                        wildcarArr.emplace_back(pathSplitArr[idx].second);
-                    }
-                    req._urlWildcardData = pathSplitArr.size() > UWPIndex 
-                            ? pureRequesPathView.substr(pathSplitArr[UWPIndex].first)
-                            : ""sv;
-                    req._wildcarDataArr = wildcarArr;
-                    static_cast<void>((doBefore(interceptors, ok, req, res) && ...));
-                    if (ok) {
-                        co_await endpoint(req, res);
-                    }
-                    ok = true;
-                    static_cast<void>((doAfter(interceptors, ok, req, res) && ...));
-                };
-                break;
+            bool ok = true;
+            static_cast<void>((doBefore(interceptors, ok, req, res) && ...));
+            if (ok) {
+                co_await endpoint(req, res);
             }
-        }
-        auto buildLink = utils::StringUtil::split<std::string_view>(
-            path, 
-            "/",
-            {getMethodStringView(Method)}
-        );
-        _routerTree.insert(buildLink, std::move(realEndpoint));
+            ok = true;
+            static_cast<void>((doAfter(interceptors, ok, req, res) && ...));
+        };
+        _routerTree.insert(getMethodStringView(Method), path, std::move(realEndpoint));
     }
 
     template <typename T>
@@ -18,25 +18,70 @@
  * limitations under the License.
  */
 
+#include <map>
 #include <string>
 #include <vector>
-#include <stack>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
 #include <functional>
 
 #include <HXLibs/net/protocol/http/Request.hpp>
 #include <HXLibs/net/protocol/http/Response.hpp>
+#include <HXLibs/net/router/RequestParsing.hpp>
 #include <HXLibs/coroutine/task/Task.hpp>
-#include <HXLibs/container/RadixTree.hpp>
+#include <HXLibs/utils/StringUtils.hpp>
 
 namespace HX::net {
 
 using EndpointFunc = std::function<coroutine::Task<>(Request&, Response&)>;
 
+/**
+ * @brief 路由树: 先注册 (insert), 再编译 (compile) 为连续的结点数组后查找 (find)
+ * @note 以`/`分段, 每段依次尝试: 静态段 > `{val}` > `/ **`, 失败时回溯.
+ *       编译后每个结点的静态子结点是一段按 (长度, 字典序) 排好序的边, 二分查找;
+ *       查找时原地扫描路径, 直接捕获参数, 不申请任何内存.
+ */
 class RouterTree {
-    using Node = container::RadixTreeNode<std::string_view, EndpointFunc>;
+    inline static constexpr uint32_t kNone = static_cast<uint32_t>(-1);
+
+    /**
+     * @brief 编译后的结点
+     */
+    struct Node {
+        uint32_t edgeBegin; // 静态子结点的边 [edgeBegin, edgeEnd)
+        uint32_t edgeEnd;
+        uint32_t param;     // `{val}` 子结点
+        uint32_t catchAll;  // `/**` 对应的端点
+        uint32_t endpoint;  // 恰好匹配到此结点时的端点
+    };
+
+    /**
+     * @brief 编译后的静态边, 键存放在 _keys 中
+     */
+    struct Edge {
+        uint32_t keyBegin;
+        uint32_t keyLen;
+        uint32_t child;
+    };
+
+    /**
+     * @brief 已注册的路由, 编译时使用
+     */
+    struct Route {
+        std::string method;
+        std::string path;
+        uint32_t endpoint;
+    };
+
 public:
     explicit RouterTree() 
-        : _root(std::make_shared<Node>())
+        : _routes()
+        , _endpoints()
+        , _nodes()
+        , _edges()
+        , _keys()
         , _notFoundHandler([](Request &req,
                               Response &res) 
         -> coroutine::Task<> {
@@ -61,7 +106,9 @@ public:
     "</body></html>")
                 .sendRes();
         })
-    {}
+    {
+        compile();
+    }
 
     /**
      * @brief 设置`找不到路由`时候, 调用的端点
@@ -74,94 +121,199 @@ public:
     RouterTree& operator=(const RouterTree&) = delete;
     RouterTree(const RouterTree& ) = delete;
 
+    /**
+     * @brief 注册路由, 需要在 compile() 之后才能被查找到
+     * @param method 请求方法, 如`GET`
+     * @param path 模版路径, 如`/home/{id}/ **`
+     * @param endpoint 端点函数
+     * @throw std::runtime_error `**`不在末尾, 或者`{val}`超过 PathParams::kMaxParamNum 个
+     * @note 重复注册时, 后注册的覆盖之前的
+     */
     void insert(
-        std::vector<std::string_view>& buildLink,
+        std::string_view method,
+        std::string_view path,
         EndpointFunc&& endpoint
     ) {
-        auto node = _root;
-        for (auto& key : buildLink) {
-            if (key.front() == '{') { // 特别处理: 如果是 {xxx}, 那么映射到 "*"
-                key = "*";
-            }
-            auto findIt = node->child.find(key);
-            if (findIt == node->child.end()) {
-                node = node->child[key] = std::make_shared<Node>();
-            } else {
-                node = findIt->second;
-            }
+        using namespace std::string_view_literals;
+        if (path.find("/**"sv) != std::string_view::npos) {
+            RequestTemplateParsing::getUniversalWildcardPathBeginIndex(path);
+        }
+        std::size_t paramNum = 0;
+        for (auto key : utils::StringUtil::split<std::string_view>(path, "/")) {
+            paramNum += key.front() == '{';
+        }
+        if (paramNum > PathParams::kMaxParamNum) [[unlikely]] {
+            throw std::runtime_error(std::string{path} + " has too many path parameters");
         }
-        node->val = endpoint;
+        _routes.push_back({std::string{method}, std::string{path},
+                           static_cast<uint32_t>(_endpoints.size())});
+        _endpoints.push_back(std::move(endpoint));
     }
 
-    template <bool IsWildcard = false>
-    const EndpointFunc& find(const std::vector<std::string_view>& findLink) const {
-        const std::size_t n = findLink.size();
-        std::size_t i = 0;
-        std::stack<std::tuple<std::shared_ptr<Node>, std::size_t>> st;
-        st.push({_root, static_cast<std::size_t>(0)});
-        auto node = _root;
-        while (st.size() && i < n) {
-            auto& top = st.top();
-            node = std::move(std::get<0>(top));
-            i = std::get<1>(top);
-            st.pop();
-            auto findIt = node->child.end(); 
-            if (i == n)
-                goto End;
-
-            for (; i < n; ++i) {
-                findIt = node->child.find(findLink[i]);
-                if (findIt == node->child.end()) {
-                    // 以 {} 尝试
-                    findIt = node->child.find("*");
-                    if (findIt != node->child.end()) {
-                        if constexpr (IsWildcard) { // 注意`/`
-                            if (findLink[i].empty()) [[unlikely]] {
-                                // 特殊的尾部标记, 表示 `/home/**`中
-                                // 访问了`/home/`的情况
-                                goto End;
-                            }
-                        }
-                        st.push({node, n});
-                        node = findIt->second;
-                        if constexpr (IsWildcard) {
-                            // 为了剔除`/`在末尾的影响
-                            // 这时候如果存在 /files 与 /files/**
-                            // 那么就会冲突
-                            if (i == n - 2 && node->val.has_value()) {
-                                return *node->val;
-                            }
-                        }
-                        continue;
-                    }
-                End:
-                    // 只能看看是否有**了
-                    findIt = node->child.find("**");
-                    if (findIt == node->child.end()) {
-                        if (st.empty()) {
-                            return _notFoundHandler;
-                        }
-                        break; // 回溯之前的
+    /**
+     * @brief 将已注册的路由编译为连续的结点数组
+     * @warning 与 find() 不是线程安全的; 需要在开始查找 (如服务器启动) 之前调用
+     */
+    void compile() {
+        // 先建立普通的字典树, 再按结点顺序展开
+        struct BuildNode {
+            std::map<std::string_view, uint32_t, KeyLess> child;
+            uint32_t param = kNone;
+            uint32_t catchAll = kNone;
+            uint32_t endpoint = kNone;
+        };
+        std::vector<BuildNode> tree(1);
+        auto getChild = [&](uint32_t node, std::string_view key) {
+            auto [it, isNew] = tree[node].child.try_emplace(key, static_cast<uint32_t>(tree.size()));
+            if (isNew) {
+                tree.emplace_back();
+            }
+            return it->second;
+        };
+        for (auto const& route : _routes) {
+            uint32_t node = getChild(0, route.method);
+            bool isCatchAll = false;
+            for (auto key : utils::StringUtil::split<std::string_view>(route.path, "/")) {
+                if (key == "**") {
+                    isCatchAll = true;
+                } else if (key.front() == '{') {
+                    if (tree[node].param == kNone) {
+                        tree[node].param = static_cast<uint32_t>(tree.size());
+                        tree.emplace_back();
                     }
-                    return *findIt->second->val;
+                    node = tree[node].param;
                 } else {
-                    node = findIt->second;
-                    if constexpr (IsWildcard) {
-                        // 为了剔除`/`在末尾的影响
-                        // 这时候如果存在 /files 与 /files/**
-                        // 那么就会冲突
-                        if (i == n - 2 && node->val.has_value()) {
-                            return *node->val;
-                        }
-                    }
+                    node = getChild(node, key);
                 }
             }
+            (isCatchAll ? tree[node].catchAll : tree[node].endpoint) = route.endpoint;
+        }
+
+        _nodes.clear();
+        _edges.clear();
+        _keys.clear();
+        _nodes.reserve(tree.size());
+        for (auto const& node : tree) {
+            auto edgeBegin = static_cast<uint32_t>(_edges.size());
+            for (auto const& [key, child] : node.child) {
+                _edges.push_back({static_cast<uint32_t>(_keys.size()),
+                                  static_cast<uint32_t>(key.size()), child});
+                _keys += key;
+            }
+            _nodes.push_back({edgeBegin, static_cast<uint32_t>(_edges.size()),
+                              node.param, node.catchAll, node.endpoint});
         }
-        return node->val.has_value() ? *node->val : _notFoundHandler;
+    }
+
+    /**
+     * @brief 查找路由, 并捕获路径参数
+     * @param method 请求方法
+     * @param path 纯路径 (不含`?`之后的部分)
+     * @param params [out] 路径参数, 指向 path
+     * @return const EndpointFunc& 找不到时为`404`端点
+     */
+    const EndpointFunc& find(
+        std::string_view method,
+        std::string_view path,
+        PathParams& params
+    ) const {
+        params.paramNum = 0;
+        params.wildcard = {};
+        if (auto root = _findChild(_nodes.front(), method); root != kNone) [[likely]] {
+            if (auto res = _match(root, path, 0, params); res != kNone) [[likely]] {
+                return _endpoints[res];
+            }
+        }
+        return _notFoundHandler;
     }
 
 private:
-    std::shared_ptr<Node> _root;
+    /**
+     * @brief 编译时静态边的顺序: 先比较长度, 再比较内容
+     */
+    struct KeyLess {
+        bool operator()(std::string_view a, std::string_view b) const noexcept {
+            return a.size() != b.size() ? a.size() < b.size() : a < b;
+        }
+    };
+
+    /**
+     * @brief 在结点的静态边中二分查找
+     * @return uint32_t 子结点, 找不到为 kNone
+     */
+    uint32_t _findChild(Node const& node, std::string_view key) const noexcept {
+        auto first = _edges.data() + node.edgeBegin;
+        auto last = _edges.data() + node.edgeEnd;
+        char const* keys = _keys.data();
+        auto it = std::lower_bound(first, last, key, [&](Edge const& edge, std::string_view k) {
+            return edge.keyLen != k.size()
+                ? edge.keyLen < k.size()
+                : std::memcmp(keys + edge.keyBegin, k.data(), k.size()) < 0;
+        });
+        if (it != last && it->keyLen == key.size()
+            && std::memcmp(keys + it->keyBegin, key.data(), key.size()) == 0
+        ) {
+            return it->child;
+        }
+        return kNone;
+    }
+
+    /**
+     * @brief 从结点 nodeIdx 开始匹配 path[pos, ...)
+     * @note 递归深度不超过路由模版的段数, 而不是请求路径的段数
+     * @return uint32_t 端点下标, 匹配失败为 kNone
+     */
+    uint32_t _match(
+        uint32_t nodeIdx,
+        std::string_view path,
+        std::size_t pos,
+        PathParams& params
+    ) const noexcept {
+        Node const& node = _nodes[nodeIdx];
+        auto begin = path.find_first_not_of('/', pos);
+        if (begin == std::string_view::npos) {
+            if (node.endpoint != kNone) {
+                // 末尾的`/`不影响匹配, 即`/files/`也匹配`/files`
+                return node.endpoint;
+            }
+            if (pos < path.size() && node.catchAll != kNone) {
+                // `/files/`匹配`/files/**`, 而`/files`不匹配
+                params.wildcard = path.substr(pos);
+                return node.catchAll;
+            }
+            return kNone;
+        }
+        auto end = std::min(path.find('/', begin), path.size());
+        auto key = path.substr(begin, end - begin);
+        if (auto child = _findChild(node, key); child != kNone) {
+            if (auto res = _match(child, path, end, params); res != kNone) {
+                return res;
+            }
+        }
+        if (node.param != kNone) {
+            auto paramNum = params.paramNum;
+            params.params[paramNum] = key;
+            params.paramNum = paramNum + 1;
+            if (auto res = _match(node.param, path, end, params); res != kNone) {
+                return res;
+            }
+            params.paramNum = paramNum;
+        }
+        if (node.catchAll != kNone) {
+            // 通配符的结果从`/`开始, 如`/files/**`匹配`/files/a/b`得到`/a/b`
+            params.wildcard = path.substr(pos);
+            return node.catchAll;
+        }
+        return kNone;
+    }
+
+    std::vector<Route> _routes;
+    std::vector<EndpointFunc> _endpoints;
+
+    // 编译结果, 结点 0 为根结点, 其静态边为请求方法
+    std::vector<Node> _nodes;
+    std::vector<Edge> _edges;
+    std::string _keys;
 
     /**
      * @brief 路由找不到时, 调用的端点; 俗称`404`
@@ -170,4 +322,3 @@ private:
 };
 
 } // namespace HX::net
-
@@ -24,10 +24,15 @@
 #include <HXLibs/net/socket/AddressResolver.hpp>
 #include <HXLibs/net/router/Router.hpp>
 #include <HXLibs/net/server/ConnectionHandler.hpp>
+#include <HXLibs/net/protocol/http/DateCache.hpp>
 #include <HXLibs/exception/ErrorHandlingTools.hpp>
 
 #include <HXLibs/log/Log.hpp>
 
+#if defined(__linux__)
+    #include <netinet/tcp.h>
+#endif
+
 namespace HX::net {
 
 struct Acceptor {
@@ -39,15 +44,55 @@ struct Acceptor {
         : _router{router}
         , _eventLoop{eventLoop}
         , _entry{entry}
+        , _isFixedFile{false}
+        , _idleConns{}
     {}
 
     Acceptor& operator=(Acceptor&&) noexcept = delete;
 
     template <typename Timeout>
         requires(utils::HasTimeNTTP<Timeout>)
-    coroutine::Task<> start(std::atomic_bool const& isRun) {
+    coroutine::Task<> start(std::stop_token stopToken) {
         auto serverFd = co_await makeServerFd();
+        // 响应头的 `Date` 每秒刷新一次, 而不是每个响应都格式化时间
+        DateCache::local().autoRefresh(_eventLoop, stopToken).detach();
+        // 服务器关闭时, 只断开空闲 (等待请求) 的连接; 每个事件循环只注册一次, 而不是每个连接一次
+        auto stopIdle = _eventLoop.onStop(stopToken, [this] {
+            _idleConns.shutdownAll();
+        });
+#if defined(__linux__)
+        // 注册文件表模式: 新连接直接放入注册文件表, 内核不支持时使用普通 fd
+        if constexpr (platform::kUseFixedFile) {
+            _isFixedFile = _eventLoop.getEventDrive().registerFixedFiles(kFixedFileNum);
+        }
+        // 优先使用多发 accept; 内核不支持 (< 5.19) 时, 回退为逐个 prepAccept
+        if (co_await multishotAccept<Timeout>(serverFd, stopToken)) [[likely]] {
+            co_await _eventLoop.makeAioTask().prepClose(serverFd);
+            log::hxLog.debug("已退出...", serverFd);
+            co_return;
+        }
+        log::hxLog.warning("当前内核不支持 multishot accept, 回退为普通 accept");
+#endif
         for (;;) [[likely]] {
+#if defined(__linux__)
+            // 服务器关闭时, 取消正在等待的 accept
+            auto res = co_await _eventLoop.cancelable(
+                _isFixedFile
+                    ? _eventLoop.makeAioTask().prepAcceptDirect(
+                        serverFd, nullptr, nullptr, 0)
+                    : _eventLoop.makeAioTask().prepAccept(
+                        serverFd,
+                        nullptr,    // 如果需要, 可以 getpeername(fd, ...) 获取的说...
+                        nullptr,
+                        0
+                    ),
+                stopToken
+            );
+            if (res == -ECANCELED) [[unlikely]] {
+                break;
+            }
+            auto fd = HXLIBS_CHECK_EVENT_LOOP(res);
+#else
             auto fd = HXLIBS_CHECK_EVENT_LOOP((
                 co_await _eventLoop.makeAioTask().prepAccept(
                     serverFd,
@@ -56,12 +101,11 @@ struct Acceptor {
                     0
                 )
             ));
+#endif
             log::hxLog.debug("有新的连接:", fd);
-            ConnectionHandler::start<Timeout>(fd, isRun, _router, _eventLoop).detach();
-            if (!isRun.load(std::memory_order_acquire)) [[unlikely]] {
-                break;  // 最在乎性能的关闭方式是, 关闭时候通过请求来解决 prepAccept 的阻塞
-                        // 而不是写一个 whenAny 然后再写很复杂的逻辑什么的, 它浪费性能, 并且不是永远必须的
-                        // 我们牺牲一个 atomic_bool 的性能已经很让步了..., @todo 这甚至应该作为一个编译选项(?)
+            ConnectionHandler::start<Timeout>(fd, stopToken, _router, _eventLoop, _idleConns, _isFixedFile).detach();
+            if (stopToken.stop_requested()) [[unlikely]] {
+                break;  // IOCP 下尚不支持取消, 关闭时候仍通过请求来唤醒 accept
             }
         }
         co_await _eventLoop.makeAioTask().prepClose(serverFd);
@@ -69,6 +113,64 @@ struct Acceptor {
     }
 
 private:
+#if defined(__linux__)
+    /**
+     * @brief 多发 accept: 只提交一个 sqe, 之后每个新连接产生一个 cqe
+     * @param serverFd 服务端套接字
+     * @param stopToken 停止令牌
+     * @return true 正常退出
+     * @return false 内核不支持 multishot accept, 需要回退为普通 accept
+     */
+    template <typename Timeout>
+        requires(utils::HasTimeNTTP<Timeout>)
+    coroutine::Task<bool> multishotAccept(SocketFdType serverFd, std::stop_token stopToken) {
+        bool isAccepted = false;
+        for (;;) [[likely]] {
+            // 多发 accept 可能因为错误 (如 -EMFILE) 或者 cq 溢出而终止, 此时需要重新提交
+            auto acceptTask = _eventLoop.makeMultishotAioTask();
+            if (_isFixedFile) {
+                acceptTask.prepMultishotAcceptDirect(serverFd, nullptr, nullptr, 0);
+            } else {
+                acceptTask.prepMultishotAccept(serverFd, nullptr, nullptr, 0);
+            }
+            // 服务器关闭时取消; 取消后仍需等待到最后一个 cqe, acceptTask 才可以析构
+            auto _ = _eventLoop.onStop(stopToken, [this, &acceptTask] {
+                _eventLoop.makeAioTask().prepCancel(acceptTask.userData(), 0).detach();
+            });
+            bool isError = false;
+            do {
+                int fd = co_await acceptTask;
+                if (fd < 0) [[unlikely]] {
+                    if (fd == -EINVAL && !isAccepted) {
+                        co_return false;
+                    }
+                    if (fd != -ECANCELED) {
+                        log::hxLog.error("multishot accept:", std::error_code{-fd, std::system_category()}.message());
+                        isError = true;
+                    }
+                    continue;
+                }
+                isAccepted = true;
+                isError = false;
+                log::hxLog.debug("有新的连接:", fd);
+                ConnectionHandler::start<Timeout>(fd, stopToken, _router, _eventLoop, _idleConns, _isFixedFile).detach();
+            } while (acceptTask.isArmed());
+            if (stopToken.stop_requested()) [[unlikely]] {
+                co_return true;
+            }
+            // 因错误终止 (如 fd 耗尽的 -EMFILE / -ENFILE) 时, 立即重新提交只会立刻再次失败,
+            // 空转事件循环并刷屏日志; 因此先等待一段时间, 让已有连接有机会释放 fd
+            if (isError) [[unlikely]] {
+                if (co_await _eventLoop.cancelable(
+                    _eventLoop.makeTimer().sleepFor(kAcceptRetryDelay), stopToken) < 0
+                ) {
+                    co_return true;
+                }
+            }
+        }
+    }
+#endif
+
     coroutine::Task<SocketFdType> makeServerFd() {
 #if defined(__linux__)
         int serverFd = exception::IoUringErrorHandlingTools::check(
@@ -84,6 +186,10 @@ private:
         int on = 1;
         setsockopt(serverFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
         setsockopt(serverFd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+        // 接受的连接继承 TCP_NODELAY (注册文件表模式下无法对连接 setsockopt).
+        // 响应已经由 ConnectionHandler 合并写入, 不需要 Nagle; 否则流水线的响应超过一次写入时,
+        // 最后一次小的写入要等到对方 (延迟的) ACK, 每批多出约 40ms
+        setsockopt(serverFd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
 
         exception::LinuxErrorHandlingTools::convertError<int>(
             ::bind(serverFd, serAddr._addr, serAddr._addrlen)
@@ -120,9 +226,19 @@ private:
 #endif
     }
 
+#if defined(__linux__)
+    // 注册文件表的大小 (会被 RLIMIT_NOFILE 限制)
+    inline static constexpr unsigned int kFixedFileNum = 1U << 16;
+
+    // 多发 accept 因错误终止后, 重新提交前的等待时间
+    inline static constexpr std::chrono::milliseconds kAcceptRetryDelay{100};
+#endif
+
     Router const& _router;
     coroutine::EventLoop& _eventLoop;
     [[maybe_unused]] AddressResolver::AddressInfo const& _entry;
+    bool _isFixedFile; // 新连接是否放入 io_uring 注册文件表
+    IdleConnectionList _idleConns; // 本事件循环的空闲连接, 需要比所有的连接活得久 (事件循环退出后才析构)
 };
 
 } // namespace HX::net
@@ -20,6 +20,7 @@
 
 #include <HXLibs/coroutine/task/RootTask.hpp>
 #include <HXLibs/coroutine/loop/EventLoop.hpp>
+#include <HXLibs/coroutine/awaiter/WhenAll.hpp>
 #include <HXLibs/net/socket/SocketFd.hpp>
 #include <HXLibs/net/router/Router.hpp>
 #include <HXLibs/net/socket/IO.hpp>
@@ -30,37 +31,138 @@
 
 namespace HX::net {
 
+/**
+ * @brief 正在等待下一个请求的 (空闲) 连接; 服务器关闭时只断开它们,
+ *        正在处理请求的连接在响应发送完毕后, 看到停止请求自行退出
+ * @note 每个事件循环一个 (由 Acceptor 持有), 只在事件循环的线程上访问, 因此不需要加锁;
+ *       节点位于 ConnectionHandler 的协程帧中, 登记与注销都不申请内存
+ */
+class IdleConnectionList {
+public:
+    /**
+     * @brief 登记一个空闲连接, 析构时注销
+     */
+    class [[nodiscard]] Guard {
+    public:
+        Guard(IdleConnectionList& list, IO& io) noexcept
+            : _list{list}
+            , _io{io}
+            , _prev{nullptr}
+            , _next{list._head}
+        {
+            if (_next) {
+                _next->_prev = this;
+            }
+            _list._head = this;
+        }
+
+        Guard& operator=(Guard&&) noexcept = delete;
+
+        ~Guard() noexcept {
+            (_prev ? _prev->_next : _list._head) = _next;
+            if (_next) {
+                _next->_prev = _prev;
+            }
+        }
+    private:
+        friend class IdleConnectionList;
+
+        IdleConnectionList& _list;
+        IO& _io;
+        Guard* _prev;
+        Guard* _next;
+    };
+
+    IdleConnectionList() noexcept
+        : _head{nullptr}
+    {}
+
+    IdleConnectionList& operator=(IdleConnectionList&&) noexcept = delete;
+
+    /**
+     * @brief 登记连接为空闲 (等待请求中), 直到返回值析构
+     * @param io 连接
+     * @return Guard
+     */
+    Guard park(IO& io) noexcept {
+        return {*this, io};
+    }
+
+    /**
+     * @brief 关闭所有空闲连接的读写, 以唤醒它们正在等待的 recv, 而不是等到超时
+     * @note 连接在 recv 返回后才会注销, 因此遍历期间链表不会改变
+     */
+    void shutdownAll() {
+        for (Guard* node = _head; node; node = node->_next) {
+            node->_io.shutdown();
+        }
+    }
+private:
+    Guard* _head;
+};
+
 struct ConnectionHandler {
 
+    /**
+     * @brief 处理一个连接
+     * @param fd 套接字
+     * @param stopToken 服务器的停止令牌: 请求停止后, 处理完当前的请求就断开连接
+     * @param router 路由
+     * @param eventLoop 事件循环
+     * @param idleConns 本事件循环的空闲连接, 等待请求期间登记在其中 (服务器关闭时会被断开)
+     * @param isFixedFile fd 是否为 io_uring 注册文件表的下标
+     */
     template <typename Timeout>
         requires(utils::HasTimeNTTP<Timeout>)
     static coroutine::RootTask<> start(
         SocketFdType fd,
-        std::atomic_bool const& isRun,
+        std::stop_token stopToken,
         Router const& router,
-        coroutine::EventLoop& eventLoop
+        coroutine::EventLoop& eventLoop,
+        IdleConnectionList& idleConns,
+        bool isFixedFile = false
     ) {
         using namespace std::string_view_literals;
-        IO io{fd, eventLoop};
+        IO io{fd, eventLoop, isFixedFile};
         Request  req{io};
         Response res{io};
 
         try {
             for (;;) {
-                // 读
-                if (!co_await req.parserReq<Timeout>()) [[unlikely]] {
+                // 读: 缓冲区中已经有完整的请求 (流水线) 时直接解析;
+                // 否则需要等待读取, 先把积攒的响应发出去
+                if (!req._tryParserReq()) {
+                    co_await res._flushPending();
+                }
+                if (stopToken.stop_requested()) [[unlikely]] {
                     break;
                 }
+                bool isParsed;
+                {
+                    // 等待请求期间是空闲的, 服务器关闭时会被断开
+                    auto _ = idleConns.park(io);
+                    isParsed = co_await req.parserReq<Timeout>();
+                }
+                if (!isParsed) [[unlikely]] {
+                    break;
+                }
+                // 之后还有已经到达的请求时, 推迟发送响应, 与之后的响应一次写入
+                res._isDeferSend = req._hasPipelinedReq();
                 // 路由
-                co_await router.getEndpoint(
-                    req.getReqType(), 
-                    req.getReqPath()
-                )(req, res);
+                if (res._pendingBuf.empty()) [[likely]] {
+                    co_await router.getEndpoint(req)(req, res);
+                } else {
+                    // 有积攒的响应: 端点同步完成时与它的响应一次写入; 端点挂起时立即发出, 不被它拖延
+                    co_await coroutine::whenAll(
+                        router.getEndpoint(req)(req, res),
+                        res._flushPendingOnSuspend()
+                    );
+                }
                 
                 // 只要不是明确写 close 的, 我就复用连接 (keep-alive)
-                if (auto it = req.getHeaders().find(CONNECTION_SV);
-                    (it != req.getHeaders().end() && it->second == "close"sv)
-                    || !isRun.load(std::memory_order_acquire)
+                if (auto it = req.getHeadersView().find(CONNECTION_SV);
+                    (it != req.getHeadersView().end() && it->second == "close"sv)
+                    || stopToken.stop_requested()
                 ) [[unlikely]] {
                     break;
                 }
@@ -71,12 +173,24 @@ struct ConnectionHandler {
                 co_await req.clear();
                 res.clear();
             }
+            // 按顺序发出积攒的响应 (如 `Connection: close` 的请求及其之前的)
+            co_await res._flushPending();
         } catch (std::exception const& err) {
             // ps: 连接被对方重置 说明对方已经关闭连接, 而我还在等待读取, 这时候会异常, 可以忽视
             log::hxLog.error("发生异常:", err.what());
         } catch (...) {
             log::hxLog.error("发生未知错误!");
         }
+        if (req._parseError) [[unlikely]] {
+            // 请求不合法 (请求头、请求体长度或者分块编码): 回复错误码后断开连接
+            try {
+                co_await res._sendError(*req._parseError);
+            } catch (std::exception const& err) {
+                log::hxLog.error("发生异常:", err.what());
+            } catch (...) {
+                log::hxLog.error("发生未知错误!");
+            }
+        }
         log::hxLog.debug("连接已断开");
 
         co_await io.close();
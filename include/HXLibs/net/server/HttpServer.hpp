@@ -18,12 +18,16 @@
  * limitations under the License.
  */
 
+#include <mutex>
+#include <vector>
+
 #include <HXLibs/net/router/Router.hpp>
 #include <HXLibs/net/socket/AddressResolver.hpp>
 #include <HXLibs/net/server/Acceptor.hpp>
 #include <HXLibs/net/client/HttpClient.hpp>
 #include <HXLibs/coroutine/loop/EventLoop.hpp>
 #include <HXLibs/container/FutureResult.hpp>
+#include <HXLibs/reflection/json/JsonWrite.hpp>
 
 namespace HX::net {
 
@@ -39,22 +43,30 @@ public:
         std::string port
     )
         : _router{}
-        , _asyncStopThread{}
         , _name{std::move(name)}
         , _port{std::move(port)}
         , _runNum{0}
-        , _isRun{true}
+        , _stopSource{}
+        , _loopsMtx{}
+        , _loops{}
+        , _threads{}
+        , _asyncStopThread{}
     {}
 
     HttpServer& operator=(HttpServer&&) noexcept = delete;
 
     /**
      * @brief 同步关闭服务器
+     * @note 会取消正在等待的 accept, 并立即断开空闲 (等待下一个请求) 的长连接;
+     *       正在处理请求的连接会先发送完响应, 之后才自行关闭.
+     *       等待以上全部完成 (所有连接都已关闭), 事件循环才退出, 本方法才返回
      * @warning 该方法不可重入
      */
     void syncStop() {
-        using namespace utils;;
-        _isRun.store(false, std::memory_order_release);;
+        _stopSource.request_stop();
+#if defined(_WIN32)
+        using namespace utils;
+        // IOCP 下尚不支持取消 AcceptEx, 仍然通过请求来唤醒
         while (_runNum) {
             try {         
                 HttpClient cli{HttpClientOptions{.timeout = 1_s}};
@@ -66,6 +78,11 @@ public:
                 ;
             }
         }
+#else
+        for (auto n = _runNum.load(); n; n = _runNum.load()) {
+            _runNum.wait(n);
+        }
+#endif
         log::hxLog.warning("服务器已关闭...");
     }
 
@@ -87,6 +104,7 @@ public:
     * @param endpoint 端点函数
     * @param interceptors 拦截器
     * @return HttpServer& 可链式调用
+    * @warning 需要在启动服务器之前添加, 启动时路由会被编译 (冻结)
     */
     template <HttpMethod... Methods, typename Func, typename... Interceptors>
     HttpServer& addEndpoint(std::string_view path, Func endpoint, Interceptors&&... interceptors) {
@@ -112,19 +130,53 @@ public:
         return *this;
     }
 
+    /**
+     * @brief 聚合所有正在运行的事件循环的指标 (线程安全)
+     * @note 已经退出的事件循环不计入; 关闭 HX_LOOP_METRICS (CMake 选项) 则计数全部为 0
+     * @return coroutine::LoopMetricsSnapshot
+     */
+    coroutine::LoopMetricsSnapshot metrics() {
+        coroutine::LoopMetricsSnapshot res{};
+        std::lock_guard _{_loopsMtx};
+        for (auto* loop : _loops) {
+            res += loop->metrics();
+        }
+        return res;
+    }
+
+    /**
+     * @brief 添加内置的指标端点, 以 json 返回 metrics() 的结果
+     * @param path 端点的路径, 默认为 `/__hx/metrics`
+     * @return HttpServer& 可链式调用
+     */
+    HttpServer& addMetricsEndpoint(std::string_view path = "/__hx/metrics") {
+        return addEndpoint<HttpMethod::GET>(path, [this](
+            Request&, Response& res
+        ) -> coroutine::Task<> {
+            std::string json;
+            reflection::toJson(metrics(), json);
+            co_await res.setResLine(Status::CODE_200)
+                        .setContentType(JSON)
+                        .setBody(std::move(json))
+                        .sendRes();
+        });
+    }
+
     /**
      * @brief 同步启动 HttpServer
      * @tparam Timeout 字面常量, 表示超时时间 (单位: 秒(s))
      * @param threadNum 线程数
      * @param timeout 超时时间 (使用类型 utils::TimeNTTP)
+     * @param config 每个线程的事件循环的配置 (如 io_uring 环的创建方式)
      */
     template <typename Timeout = decltype(utils::operator""_s<'3', '0'>())>
         requires(utils::HasTimeNTTP<Timeout>)
     void syncRun(
         std::size_t threadNum = std::thread::hardware_concurrency(),
-        Timeout timeout = {}
+        Timeout timeout = {},
+        coroutine::EventLoopConfig const& config = {}
     ) {
-        asyncRun(threadNum, timeout);
+        asyncRun(threadNum, timeout, config);
         _threads.clear();
     }
 
@@ -134,19 +186,22 @@ public:
      * @tparam Timeout 字面常量, 表示超时时间 (单位: 秒(s))
      * @param threadNum 线程数
      * @param timeout 超时时间 (使用类型 utils::TimeNTTP)
+     * @param config 每个线程的事件循环的配置 (如 io_uring 环的创建方式)
      */
     template <typename Timeout = decltype(utils::operator""_s<'3', '0'>())>
         requires(utils::HasTimeNTTP<Timeout>)
     void asyncRun(
         std::size_t threadNum = std::thread::hardware_concurrency(),
-        Timeout = {}
+        Timeout = {},
+        coroutine::EventLoopConfig const& config = {}
     ) {
         if (!_threads.empty()) [[unlikely]] {
             throw std::runtime_error{"The server is already running"};
         }
+        _router.compile();
         for (std::size_t i = 0; i < threadNum; ++i) {
-            _threads.emplace_back([this] {
-                _sync<Timeout>();
+            _threads.emplace_back([this, config] {
+                _sync<Timeout>(config);
             });
         }
         log::hxLog.info("====== HXServer start: \033[33m\033]8;;http://" 
@@ -167,29 +222,47 @@ public:
 private:
     template <typename Timeout>
         requires(utils::HasTimeNTTP<Timeout>)
-    void _sync() {
+    void _sync(coroutine::EventLoopConfig const& config) {
         try {
-            coroutine::EventLoop _eventLoop;
+            // 在本线程内创建事件循环, 以满足 RingProfile::SingleIssuer 的要求
+            coroutine::EventLoop _eventLoop{config};
             AddressResolver addr;
             auto entry = addr.resolve(_name, _port);
             ++_runNum;
+            {
+                std::lock_guard _{_loopsMtx};
+                _loops.push_back(&_eventLoop);
+            }
+            struct LoopGuard {
+                HttpServer& _self;
+                coroutine::EventLoop* _loop;
+                ~LoopGuard() noexcept {
+                    std::lock_guard _{_self._loopsMtx};
+                    std::erase(_self._loops, _loop);
+                }
+            } _{*this, &_eventLoop};
             Acceptor acceptor{_router, _eventLoop, entry};
-            auto mainTask = acceptor.start<Timeout>(_isRun);
+            auto mainTask = acceptor.start<Timeout>(_stopSource.get_token());
             _eventLoop.start(mainTask);
             _eventLoop.run();
         } catch (std::exception const& ec) {
             log::hxLog.error("Server Error:", ec.what());
         }
         --_runNum;
+        _runNum.notify_all();
     }
     
     Router _router;
-    std::vector<std::jthread> _threads;
-    std::unique_ptr<std::jthread> _asyncStopThread; // 异步关闭服务器时候使用的线程
     std::string _name;
     std::string _port;
     std::atomic_uint16_t _runNum;
-    std::atomic_bool _isRun;
+    std::stop_source _stopSource;   // 关闭服务器时请求停止
+    std::mutex _loopsMtx;
+    std::vector<coroutine::EventLoop*> _loops; // 正在运行的事件循环, 用于聚合指标
+
+    // 线程放在最后: 最先析构 (join), 此时它们仍在使用的 _runNum, _loopsMtx 等成员还活着
+    std::vector<std::jthread> _threads;
+    std::unique_ptr<std::jthread> _asyncStopThread; // 异步关闭服务器时候使用的线程
 };
 
 } // namespace HX::net
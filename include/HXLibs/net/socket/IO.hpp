@@ -18,9 +18,17 @@
  * limitations under the License.
  */
 
+#include <array>
+#include <optional>
+#include <span>
+#include <algorithm>
+#include <stdexcept>
+
 #include <HXLibs/coroutine/task/Task.hpp>
 #include <HXLibs/coroutine/loop/EventLoop.hpp>
 #include <HXLibs/net/socket/SocketFd.hpp>
+#include <HXLibs/platform/LocalFdApi.hpp>
+#include <HXLibs/net/socket/RecvBuf.hpp>
 #include <HXLibs/exception/ExceptionMode.hpp>
 #include <HXLibs/utils/TimeNTTP.hpp>
 
@@ -54,29 +62,52 @@ auto* getTimePtr() noexcept {
  */
 class IO {
 public:
-    inline constexpr static std::size_t kBufMaxSize = 1 << 14; // 16kb
+    inline constexpr static std::size_t kBufMaxSize = RecvBuf::kBufMaxSize; // 16kb
+
+    // recvLinkTimeout 的返回值: index 0 为读取结果, index 1 为超时
+    using RecvLinkTimeoutResult =
+#if defined(__linux__)
+        coroutine::WhenAnyReturnType<
+            coroutine::AioTask,
+            decltype(std::declval<coroutine::AioTask>().prepLinkTimeout({}, {}))
+        >;
+#elif defined(_WIN32)
+        container::UninitializedNonVoidVariant<uint64_t, void>;
+#else
+    #error "Does not support the current operating system."
+#endif
 
     IO(coroutine::EventLoop& eventLoop)
         : _fd{kInvalidSocket}
         , _eventLoop{eventLoop}
+        , _isFixedFile{false}
+        , _isSendZcUnsupported{false}
     {}
 
-    IO(SocketFdType fd, coroutine::EventLoop& eventLoop)
+    /**
+     * @brief 构造 IO
+     * @param fd 套接字
+     * @param eventLoop 事件循环
+     * @param isFixedFile fd 是否为 io_uring 注册文件表的下标 (仅 io_uring 有效)
+     */
+    IO(SocketFdType fd, coroutine::EventLoop& eventLoop, bool isFixedFile = false)
         : _fd{fd}
         , _eventLoop{eventLoop}
+        , _isFixedFile{isFixedFile}
+        , _isSendZcUnsupported{false}
     {}
 
     IO& operator=(IO&&) noexcept = delete;
 
     coroutine::Task<int> recv(std::span<char> buf) {
         co_return static_cast<int>(
-            co_await _eventLoop.makeAioTask().prepRecv(_fd, buf, 0));
+            co_await _fixed(_eventLoop.makeAioTask().prepRecv(_fd, buf, 0)));
     }
 
     coroutine::Task<int> recv(std::span<char> buf, std::size_t n) {
         co_return static_cast<int>(
-            co_await _eventLoop.makeAioTask().prepRecv(
-                _fd, buf.subspan(0, n), 0));
+            co_await _fixed(_eventLoop.makeAioTask().prepRecv(
+                _fd, buf.subspan(0, n), 0)));
     }
 
     /**
@@ -118,7 +149,7 @@ public:
         decltype(std::declval<coroutine::AioTask>().prepLinkTimeout({}, {}))
     >> recvLinkTimeout(std::span<char> buf) {
         co_return co_await coroutine::AioTask::linkTimeout(
-            _eventLoop.makeAioTask().prepRecv(_fd, buf, 0),
+            _fixed(_eventLoop.makeAioTask().prepRecv(_fd, buf, 0)),
             _eventLoop.makeAioTask().prepLinkTimeout(
                 internal::getTimePtr<Timeout>(), 0)
         );
@@ -141,6 +172,44 @@ public:
     #error "Does not support the current operating system."
 #endif
 
+    /**
+     * @brief 读取到未持有内存的 buf 中, 读取后 buf 持有内存 (读取到的字节数需要调用者 addSize)
+     * @note 如果内核支持, 由内核在数据到达时从 provided buffer ring 中挑选缓冲区,
+     *       这样等待数据的空闲连接不会占用接收内存; 否则退化为 buf.hold() 后普通读取
+     * @warning buf 必须处于未持有状态
+     */
+    template <typename Timeout>
+        requires(utils::HasTimeNTTP<Timeout>)
+    coroutine::Task<RecvLinkTimeoutResult> recvLinkTimeout(RecvBuf& buf) {
+#if defined(__linux__)
+        if (auto* ring = _eventLoop.getEventDrive().getProvidedBufRing()) [[likely]] {
+            auto task = _eventLoop.makeAioTask();
+            auto res = co_await coroutine::AioTask::linkTimeout(
+                _fixed(std::move(task).prepRecvBufSelect(_fd, ring->bgid(), 0)),
+                _eventLoop.makeAioTask().prepLinkTimeout(
+                    internal::getTimePtr<Timeout>(), 0)
+            );
+            if (res.index() == 0) [[likely]] {
+                if (task.cqeFlags() & IORING_CQE_F_BUFFER) [[likely]] {
+                    buf.holdProvided(*ring, static_cast<unsigned short>(
+                        task.cqeFlags() >> IORING_CQE_BUFFER_SHIFT));
+                } else if (res.template get<0, exception::ExceptionMode::Nothrow>()
+                           == -ENOBUFS
+                ) [[unlikely]] {
+                    // 环中的缓冲区已经耗尽, 退化为自己申请
+                    buf.hold();
+                    co_return co_await recvLinkTimeout<Timeout>(
+                        std::span<char>{buf.data(), buf.max_size()});
+                }
+            }
+            co_return res;
+        }
+#endif
+        buf.hold();
+        co_return co_await recvLinkTimeout<Timeout>(
+            std::span<char>{buf.data(), buf.max_size()});
+    }
+
     /**
      * @brief 写入数据, 内部保证完全写入
      * @param buf 
@@ -151,14 +220,117 @@ public:
         while (!buf.empty()) {
             auto sent = static_cast<std::size_t>(
                 HXLIBS_CHECK_EVENT_LOOP(
-                    co_await _eventLoop.makeAioTask()
-                                       .prepSend(_fd, buf, 0)
+                    co_await _fixed(_eventLoop.makeAioTask()
+                                              .prepSend(_fd, buf, 0))
                 )
             );
             buf = buf.subspan(sent);
         }
     }
 
+    /**
+     * @brief 写入数据, 内部保证完全写入; 数据较大时使用零拷贝发送 (io_uring IORING_OP_SEND_ZC)
+     * @note 阈值见 EventLoopConfig::sendZcThreshold; 内核 (创建环时探测) 或套接字不支持,
+     *       以及单次发送失败 (-EINVAL) 时, 剩余的数据回退为 fullySend
+     * @param buf 返回前会一直被内核引用
+     * @return coroutine::Task<> 
+     */
+    coroutine::Task<> fullySendZc(std::span<char const> buf) {
+#if defined(__linux__)
+        auto threshold = _eventLoop.getEventDrive().sendZcThreshold();
+        coroutine::SendZcNotifier notifier;
+        int res = 0;
+        while (!_isSendZcUnsupported && buf.size() >= threshold) {
+            // MSG_WAITALL: 让内核尽量一次发完, 减少 sqe 与通知的个数
+            res = co_await _fixed(_eventLoop.makeAioTask()
+                                            .prepSendZc(_fd, buf, MSG_WAITALL, 0, notifier));
+            if (res < 0) [[unlikely]] {
+                break;
+            }
+            buf = buf.subspan(static_cast<std::size_t>(res));
+        }
+        // 发送结果先于通知到达, 返回前需要等内核不再引用 buf (出错时也是)
+        co_await notifier.wait();
+        _checkSendZc(res);
+#endif
+        co_await fullySend(buf);
+    }
+
+    /**
+     * @brief 聚集写入多段数据 (一次 sendmsg), 内部保证完全写入
+     * @note 部分写入时前移 iovec 继续写; 总大小不小于 EventLoop::sendmsgZcThreshold 时使用零拷贝发送,
+     *       回退规则同 fullySendZc
+     * @tparam N 段数
+     * @param bufs 多段数据, 返回前会一直被内核引用
+     * @return coroutine::Task<> 
+     */
+    template <std::size_t N>
+    coroutine::Task<> fullySendv(std::array<std::span<char const>, N> bufs) {
+#if defined(__linux__)
+        std::array<::iovec, N> iov;
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+            iov[i].iov_base = const_cast<char*>(bufs[i].data());
+            iov[i].iov_len = bufs[i].size();
+            total += bufs[i].size();
+        }
+        ::msghdr msg{};
+        msg.msg_iov = iov.data();
+        msg.msg_iovlen = N;
+        auto threshold = _eventLoop.getEventDrive().sendmsgZcThreshold();
+        std::optional<coroutine::SendZcNotifier> notifier; // 只有零拷贝时才需要
+        int errRes = 0;
+        while (total) {
+            int res;
+            if (!errRes && !_isSendZcUnsupported && total >= threshold) {
+                if (!notifier) {
+                    notifier.emplace();
+                }
+                res = co_await _fixed(_eventLoop.makeAioTask()
+                                                .prepSendmsgZc(_fd, &msg, MSG_WAITALL, *notifier));
+                if (res < 0) [[unlikely]] {
+                    errRes = res; // 本次调用剩余的数据改用普通发送
+                    if (res == -EINVAL || res == -EOPNOTSUPP) {
+                        _checkSendZc(res);
+                        continue;
+                    }
+                    break;
+                }
+            } else {
+                res = co_await _fixed(_eventLoop.makeAioTask()
+                                                .prepSendmsg(_fd, &msg, 0));
+                if (res < 0) [[unlikely]] {
+                    errRes = res;
+                    break;
+                }
+            }
+            auto sent = static_cast<std::size_t>(res);
+            total -= sent;
+            // 部分写入: 跳过已经写完的段, 并前移写了一部分的段
+            while (msg.msg_iovlen && sent >= msg.msg_iov->iov_len) {
+                sent -= msg.msg_iov->iov_len;
+                ++msg.msg_iov;
+                --msg.msg_iovlen;
+            }
+            if (sent) {
+                msg.msg_iov->iov_base = static_cast<char*>(msg.msg_iov->iov_base) + sent;
+                msg.msg_iov->iov_len -= sent;
+            }
+        }
+        if (notifier) {
+            co_await notifier->wait();
+        }
+        if (total) [[unlikely]] { // 只有出错才会提前结束
+            HXLIBS_CHECK_EVENT_LOOP(errRes);
+        }
+#else
+        /// @todo IOCP 的 WSASend 本身支持多段, 但 AioTask 目前只封装了单段
+        for (auto buf : bufs) {
+            co_await fullySend(buf);
+        }
+#endif
+    }
+
     /**
      * @brief 写入数据, 内部保证完全写入
      * @param buf 
@@ -169,6 +341,61 @@ public:
         co_await fullySend(buf.subspan(0, n));
     }
 
+    /**
+     * @brief 零拷贝发送文件的 [offset, offset + size) (io_uring splice: 文件 -> 管道 -> 套接字)
+     * @note 管道从事件循环借出, 用完归还; 数据全程不经过用户态
+     * @param fd 文件 (如 utils::AsyncFile::getFd())
+     * @param offset 文件偏移量
+     * @param size 发送的字节数
+     * @return true 已完全发送
+     * @return false 不支持 splice (如部分文件系统、IOCP), 此时什么也没有发送, 需要回退为读写
+     */
+    coroutine::Task<bool> sendFile(platform::LocalFdType fd, uint64_t offset, uint64_t size) {
+#if defined(__linux__)
+        auto& eventDrive = _eventLoop.getEventDrive();
+        auto pipe = eventDrive.acquirePipe();
+        bool isFirst = true;
+        try {
+            while (size) {
+                // 文件 -> 管道
+                int in = co_await _eventLoop.makeAioTask().prepSplice(
+                    fd, static_cast<int64_t>(offset), pipe.wr, -1,
+                    static_cast<unsigned int>(std::min<uint64_t>(size, pipe.size)), SPLICE_F_MOVE);
+                if (isFirst && (in == -EINVAL || in == -EOPNOTSUPP)) [[unlikely]] {
+                    eventDrive.releasePipe(pipe, false);
+                    co_return false;
+                }
+                isFirst = false;
+                if (HXLIBS_CHECK_EVENT_LOOP(in) == 0) [[unlikely]] {
+                    throw std::runtime_error{"The file is shorter than expected"};
+                }
+                offset += static_cast<uint64_t>(in);
+                size -= static_cast<uint64_t>(in);
+                // 管道 -> 套接字, 需要把管道中的数据全部发完
+                for (unsigned int left = static_cast<unsigned int>(in); left; ) {
+                    int out = HXLIBS_CHECK_EVENT_LOOP(co_await _fixed(
+                        _eventLoop.makeAioTask().prepSplice(
+                            pipe.rd, -1, _fd, -1, left, SPLICE_F_MOVE)));
+                    if (out == 0) [[unlikely]] {
+                        throw std::runtime_error{"is Close"};
+                    }
+                    left -= static_cast<unsigned int>(out);
+                }
+            }
+        } catch (...) {
+            eventDrive.releasePipe(pipe, true);
+            throw;
+        }
+        eventDrive.releasePipe(pipe, false);
+        co_return true;
+#else
+        static_cast<void>(fd);
+        static_cast<void>(offset);
+        static_cast<void>(size);
+        co_return false;
+#endif
+    }
+
     /**
      * @brief 完整的写入数据, 内部保证写入完成; 如果超时则抛出异常
      * @tparam Timeout 
@@ -180,7 +407,7 @@ public:
         // io_uring 也不保证其可以完全一次性写入...
         while (!buf.empty()) {
             auto res = co_await coroutine::AioTask::linkTimeout(
-                _eventLoop.makeAioTask().prepSend(_fd, buf, 0),
+                _fixed(_eventLoop.makeAioTask().prepSend(_fd, buf, 0)),
                 _eventLoop.makeAioTask().prepLinkTimeout(
                     internal::getTimePtr<Timeout>(), 0)
             );
@@ -229,12 +456,32 @@ public:
      */
     coroutine::Task<int> close() noexcept {
         /// @todo 此处可能也需要特化 ckose ? 因为 win 下的超时实际上就已经close了(?)
+#if defined(__linux__)
+        auto res = _isFixedFile
+            ? co_await _eventLoop.makeAioTask()
+                                 .prepCloseDirect(static_cast<unsigned int>(_fd))
+            : co_await _eventLoop.makeAioTask()
+                                 .prepClose(_fd);
+#else
         auto res = co_await _eventLoop.makeAioTask()
                                            .prepClose(_fd);
+#endif
         _fd = kInvalidSocket;
         co_return res;
     }
 
+    /**
+     * @brief 关闭套接字的读写 (不会关闭 fd), 用于主动断开连接 (如服务器关闭、过载时)
+     * @note 正在等待的读会立即得到 0 (对端关闭), 写会出错; 之后仍需要 close()
+     */
+    void shutdown() {
+#if defined(__linux__)
+        _fixed(_eventLoop.makeAioTask().prepShutdown(_fd, SHUT_RDWR)).detach();
+#else
+        ::shutdown(_fd, SD_BOTH);
+#endif
+    }
+
     /**
      * @brief 绑定新的 fd
      * @warning 必须把之前的 fd 给 close 了
@@ -243,6 +490,8 @@ public:
     coroutine::Task<> bindNewFd(SocketFdType fd) noexcept {
         co_await close();
         _fd = fd;
+        _isFixedFile = false;
+        _isSendZcUnsupported = false;
     }
 
     /**
@@ -271,8 +520,41 @@ public:
 #endif // !NDEBUG
 
 private:
+#if defined(__linux__)
+    /**
+     * @brief 处理零拷贝发送的错误: 套接字不支持 (-EOPNOTSUPP) 则之后不再尝试,
+     *        单次失败 (-EINVAL) 只回退本次调用, 其他错误抛出
+     * @param res 零拷贝发送的结果
+     */
+    void _checkSendZc(int res) {
+        if (res >= 0 || res == -EINVAL) [[likely]] {
+            return;
+        }
+        if (res == -EOPNOTSUPP) {
+            _isSendZcUnsupported = true;
+            return;
+        }
+        HXLIBS_CHECK_EVENT_LOOP(res);
+    }
+#endif
+
+    /**
+     * @brief 如果 _fd 是注册文件表的下标, 则为任务加上 IOSQE_FIXED_FILE
+     */
+    template <typename T>
+    T&& _fixed(T&& task) const noexcept {
+#if defined(__linux__)
+        if (_isFixedFile) {
+            return std::move(task).useFixedFile();
+        }
+#endif
+        return std::forward<T>(task);
+    }
+
     SocketFdType _fd;
     coroutine::EventLoop& _eventLoop;
+    bool _isFixedFile;
+    bool _isSendZcUnsupported; // 套接字不支持零拷贝 (-EOPNOTSUPP), 之后都使用普通发送
 };
 
 } // namespace HX::net
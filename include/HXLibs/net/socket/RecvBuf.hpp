@@ -0,0 +1,201 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-16 10:48:52
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <span>
+#include <memory>
+#include <cstring>
+
+#include <HXLibs/coroutine/loop/ProvidedBufRing.hpp>
+
+namespace HX::net {
+
+/**
+ * @brief 接收缓冲区, 接口同 `container::ArrayBuf`, 但是内存是按需持有的
+ * @note 空闲时不持有任何内存; 需要读取时, 要么由内核从 provided buffer ring 中挑选 (holdProvided),
+ *       要么自己申请 (hold). 解析完毕后应该调用 release() 归还.
+ */
+class RecvBuf {
+public:
+    inline constexpr static std::size_t kBufMaxSize = 1 << 14; // 16kb
+
+    RecvBuf() noexcept
+        : _data{nullptr}
+        , _nowSize{}
+        , _maxSize{}
+        , _heapBuf{}
+#if defined(__linux__)
+        , _bufRing{nullptr}
+        , _bid{}
+#endif
+    {}
+
+    RecvBuf& operator=(RecvBuf&&) noexcept = delete;
+
+    ~RecvBuf() noexcept {
+        release();
+    }
+
+    /**
+     * @brief 当前是否持有内存
+     */
+    bool isHold() const noexcept {
+        return _data;
+    }
+
+    /**
+     * @brief 持有一块自己申请的内存; 如果已经持有, 则什么也不做
+     */
+    void hold() {
+        if (_data) {
+            return;
+        }
+        _heapBuf = std::make_unique_for_overwrite<char[]>(kBufMaxSize);
+        _data = _heapBuf.get();
+        _maxSize = kBufMaxSize;
+    }
+
+#if defined(__linux__)
+    /**
+     * @brief 持有一块内核从 provided buffer ring 挑选的缓冲区
+     * @warning 必须处于未持有状态
+     * @param ring 缓冲区所属的环
+     * @param bid 缓冲区 id
+     */
+    void holdProvided(
+        coroutine::ProvidedBufRing& ring,
+        unsigned short bid
+    ) noexcept {
+        auto buf = ring.getBuf(bid);
+        _data = buf.data();
+        _nowSize = 0;
+        _maxSize = buf.size();
+        _bufRing = &ring;
+        _bid = bid;
+    }
+#endif
+
+    /**
+     * @brief 归还持有的内存 (provided buffer 会归还到环中), 并且清空数据
+     */
+    void release() noexcept {
+#if defined(__linux__)
+        if (_bufRing) {
+            _bufRing->recycle(_bid);
+            _bufRing = nullptr;
+        }
+#endif
+        _heapBuf.reset();
+        _data = nullptr;
+        _nowSize = 0;
+        _maxSize = 0;
+    }
+
+    /**
+     * @brief 固定住前 n 个字节 (如已经解析的请求头, 外界持有指向其中的视图)
+     * @note 之后 data(), size(), max_size() 都只表示其后的部分, 因此 moveToHead() 与 clear() 不会覆盖它们;
+     *       release() 时一并归还
+     * @warning n <= size()
+     * @param n
+     */
+    void pin(std::size_t n) noexcept {
+        _data += n;
+        _nowSize -= n;
+        _maxSize -= n;
+    }
+
+    /**
+     * @brief 取消 pin(), 并且把当前的数据 (如流水线中已经到达的下一个请求) 移动到缓冲区头部
+     * @warning 之前固定的部分会被覆盖, 外界不能再持有指向其中的视图
+     */
+    void unpin() noexcept {
+#if defined(__linux__)
+        char* base = _bufRing ? _bufRing->getBuf(_bid).data() : _heapBuf.get();
+#else
+        char* base = _heapBuf.get();
+#endif
+        _maxSize += static_cast<std::size_t>(_data - base);
+        std::memmove(base, _data, _nowSize);
+        _data = base;
+    }
+
+    /**
+     * @brief s 是指向 data() 的指针
+     * @warning s.size() <= max_size() && s.data 是 data() 的子区间
+     * @param s
+     */
+    void moveToHead(std::span<char const> s) {
+        _nowSize = s.size();
+        std::memmove(_data, s.data(), s.size());
+    }
+
+    /**
+     * @brief 设置长度 (注意, 如果外界对`.data()`进行写入, 需要自己调用此函数!)
+     * @param size
+     */
+    void resetSize(std::size_t size) {
+        _nowSize = size;
+    }
+
+    /**
+     * @brief 增加长度 (注意, 如果外界对`.data()`进行写入, 需要自己调用此函数!)
+     * @param size
+     */
+    void addSize(std::size_t size) {
+        _nowSize += size;
+    }
+
+    std::size_t size() const noexcept {
+        return _nowSize;
+    }
+
+    /**
+     * @brief 返回长度最大值 (未持有内存时为 0)
+     */
+    std::size_t max_size() const noexcept {
+        return _maxSize;
+    }
+
+    char const* data() const noexcept {
+        return _data;
+    }
+
+    char* data() noexcept {
+        return _data;
+    }
+
+    /**
+     * @brief 清空数据, 但是仍然持有内存
+     */
+    void clear() noexcept {
+        _nowSize = 0;
+    }
+
+private:
+    char* _data;
+    std::size_t _nowSize;
+    std::size_t _maxSize;
+    std::unique_ptr<char[]> _heapBuf;
+#if defined(__linux__)
+    coroutine::ProvidedBufRing* _bufRing;
+    unsigned short _bid;
+#endif
+};
+
+} // namespace HX::net
@@ -27,6 +27,14 @@
     namespace HX::platform {
         using SocketFdType = int;
         inline constexpr SocketFdType kInvalidSocket = -1;
+
+#if IO_URING_FIXED_FILE
+        // 服务端接受的连接直接放入 io_uring 的注册文件表 (accept_direct),
+        // 此时连接的 SocketFdType 是注册文件表的下标, 而不是 fd
+        inline constexpr bool kUseFixedFile = true;
+#else
+        inline constexpr bool kUseFixedFile = false;
+#endif
     } // namespace HX::platform
 #elif defined(_WIN32)
     #ifndef NOMINMAX
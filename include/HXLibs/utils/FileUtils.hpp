@@ -23,6 +23,8 @@
 #include <string_view>
 #include <filesystem>
 #include <span>
+#include <cstring>
+#include <exception>
 
 #include <HXLibs/platform/LocalFdApi.hpp>
 
@@ -113,10 +115,37 @@ public:
  */
 class AsyncFile {
 public:
-    AsyncFile(coroutine::EventLoop& eventLoop)
+    /**
+     * @brief 读写模式
+     */
+    enum class IoMode {
+        Buffered,   // 经过页缓存 (默认)
+        Direct,     // O_DIRECT: 绕过页缓存, 数据经过对齐的注册缓冲区 (READ_FIXED / WRITE_FIXED);
+                    // 适合只读写一遍的大文件 (如上传), 不会把热点数据挤出页缓存
+    };
+
+    /**
+     * @brief 创建异步文件
+     * @param eventLoop 
+     * @param mode 读写模式. IoMode::Direct 的限制:
+     *        - 一个文件只用于顺序写, 或者只用于顺序读 (不能混用);
+     *        - 写入从 setOffset 的位置 (默认 0) 开始, 不支持 OpenMode::Append;
+     *        - 偏移量可以不对齐: 读取时从它所在的块读入再截取; 写入时到下一个块边界为止的开头部分经过页缓存写入;
+     *        - 写入的数据先攒在缓冲区中, 直到 close() 才全部落盘;
+     *        - 文件系统不支持 O_DIRECT (如 tmpfs) 时, 以及在 Windows 上, 自动回退为 IoMode::Buffered
+     */
+    AsyncFile(coroutine::EventLoop& eventLoop, IoMode mode = IoMode::Buffered)
         : _eventLoop{eventLoop}
         , _offset{}
         , _fd{kInvalidLocalFd}
+        , _mode{mode}
+#if defined(__linux__)
+        , _ownBuf{}
+        , _directBuf{}
+        , _bufIdx{-1}
+        , _bufPos{}
+        , _bufLen{}
+#endif
     {}
 
     /**
@@ -134,12 +163,25 @@ public:
         ModeType mode = 0644
     ) {
 #if defined(__linux__)
+        if (_mode == IoMode::Direct) {
+            int fd = co_await _eventLoop.makeAioTask().prepOpenat(
+                dirfd, path.data(), static_cast<int>(flags) | O_DIRECT, mode
+            );
+            if (fd != -EINVAL) [[likely]] {
+                _fd = HXLIBS_CHECK_EVENT_LOOP(fd);
+                _acquireDirectBuf();
+                co_return;
+            }
+            // 文件系统不支持 O_DIRECT
+            _mode = IoMode::Buffered;
+        }
         _fd = HXLIBS_CHECK_EVENT_LOOP(
             co_await _eventLoop.makeAioTask().prepOpenat(
                 dirfd, path.data(), static_cast<int>(flags), mode
             )
         );
 #elif defined(_WIN32)
+        _mode = IoMode::Buffered;
         auto params =
             platform::Win32FileParamsBuilder(flags).enableIocp(true)
                                                    .build();
@@ -192,6 +234,11 @@ public:
      * @return int 读取的字节数
      */
     coroutine::Task<int> read(std::span<char> buf) {
+#if defined(__linux__)
+        if (_mode == IoMode::Direct) {
+            co_return co_await _directRead(buf);
+        }
+#endif
         int len = static_cast<int>(HXLIBS_CHECK_EVENT_LOOP(
             co_await _eventLoop.makeAioTask().prepRead(
                 _fd, buf, _offset
@@ -208,6 +255,11 @@ public:
      * @return int 读取的字节数
      */
     coroutine::Task<int> read(std::span<char> buf, unsigned int size) {
+#if defined(__linux__)
+        if (_mode == IoMode::Direct) {
+            co_return co_await _directRead(buf.first(size));
+        }
+#endif
         int len = static_cast<int>(HXLIBS_CHECK_EVENT_LOOP(
             co_await _eventLoop.makeAioTask().prepRead(
                 _fd, buf, size, _offset
@@ -259,6 +311,12 @@ public:
      * @param buf [in] 需要写入的数据
      */
     coroutine::Task<> write(std::span<char const> buf) {
+#if defined(__linux__)
+        if (_mode == IoMode::Direct) {
+            co_await _directWrite(buf);
+            co_return;
+        }
+#endif
         for (; !buf.empty(); buf = buf.subspan(
             static_cast<std::size_t>(HXLIBS_CHECK_EVENT_LOOP(
                 co_await _eventLoop.makeAioTask().prepWrite(
@@ -283,10 +341,27 @@ public:
      * @return coroutine::Task<> 
      */
     coroutine::Task<> close() {
+        std::exception_ptr err;
+#if defined(__linux__)
+        if (_directBuf.data()) {
+            try {
+                // 写模式下 (_bufLen == 0), 缓冲区里还有没落盘的数据
+                if (!_bufLen && _bufPos) {
+                    co_await _directWriteTail();
+                }
+            } catch (...) {
+                err = std::current_exception();
+            }
+            _releaseDirectBuf();
+        }
+#endif
         HXLIBS_CHECK_EVENT_LOOP(
             co_await _eventLoop.makeAioTask().prepClose(_fd)
         );
         _fd = kInvalidLocalFd;
+        if (err) [[unlikely]] {
+            std::rethrow_exception(err);
+        }
     }
 
     /**
@@ -296,18 +371,44 @@ public:
         _eventLoop.sync(close());
     }
 
+    /**
+     * @brief 获取底层的文件描述符 (如用于 net::IO::sendFile)
+     * @return LocalFdType 
+     */
+    LocalFdType getFd() const noexcept {
+        return _fd;
+    }
+
+    /**
+     * @brief 获取实际生效的读写模式 (可能因不支持 O_DIRECT 而回退)
+     * @return IoMode 
+     */
+    IoMode ioMode() const noexcept {
+        return _mode;
+    }
+
     /**
      * @brief 设置偏移量
+     * @note IoMode::Direct 时也可以不对齐 (见构造函数的说明)
+     * @warning IoMode::Direct 时只能在读之间或者写入之前调用
      * @param offset 
      */
     void setOffset(uint64_t offset) {
         _offset = offset;
+#if defined(__linux__)
+        if (_bufLen) { // 丢弃读缓冲
+            _bufPos = _bufLen = 0;
+        }
+#endif
     }
 
 #ifdef NDEBUG
-    ~AsyncFile() noexcept = default;
+    ~AsyncFile() noexcept {
+        _releaseDirectBuf();
+    }
 #else
     ~AsyncFile() noexcept(false) {
+        _releaseDirectBuf();
         if (_fd != kInvalidLocalFd) [[unlikely]] {
             throw std::runtime_error{"[AsyncFile]: Before that, it is necessary to call close()"};
         }
@@ -317,9 +418,147 @@ public:
     AsyncFile& operator=(AsyncFile&&) noexcept = delete;
 
 private:
+#if defined(__linux__)
+    /// @brief 没有空闲的注册缓冲区时, 自行分配的对齐缓冲区的大小
+    inline static constexpr std::size_t kDirectBufSize = 1 << 18; // 256kb
+    inline static constexpr std::size_t kAlign = coroutine::FixedBufPool::kAlign;
+
+    /**
+     * @brief 从事件循环借出注册缓冲区; 不支持或者用完时, 退化为自行分配的对齐缓冲区 (普通读写)
+     */
+    void _acquireDirectBuf() {
+        auto* pool = _eventLoop.getEventDrive().getFixedBufPool();
+        if (pool && (_bufIdx = pool->acquire()) >= 0) [[likely]] {
+            _directBuf = pool->getBuf(_bufIdx);
+        } else {
+            _ownBuf = coroutine::makeAlignedBuf(kAlign, kDirectBufSize);
+            _directBuf = {_ownBuf.get(), kDirectBufSize};
+        }
+        _bufPos = _bufLen = 0;
+    }
+
+    /**
+     * @brief 把不在缓冲区中的 data 普通地写到 _offset 处 (需要已经关闭 O_DIRECT), 内部保证完全写入
+     */
+    coroutine::Task<> _directFlushFrom(std::span<char const> data) {
+        while (!data.empty()) {
+            auto n = static_cast<std::size_t>(HXLIBS_CHECK_EVENT_LOOP(
+                co_await _eventLoop.makeAioTask().prepWrite(_fd, data, _offset)));
+            data = data.subspan(n);
+            _offset += n;
+        }
+    }
+
+    /**
+     * @brief 把缓冲区的 [begin, end) 写到 _offset 处, 内部保证完全写入
+     */
+    coroutine::Task<> _directFlush(std::size_t begin, std::size_t end) {
+        while (begin < end) {
+            std::span<char const> data{_directBuf.data() + begin, end - begin};
+            int res = _bufIdx >= 0
+                ? co_await _eventLoop.makeAioTask().prepWriteFixed(_fd, data, _offset, _bufIdx)
+                : co_await _eventLoop.makeAioTask().prepWrite(_fd, data, _offset);
+            auto n = static_cast<std::size_t>(HXLIBS_CHECK_EVENT_LOOP(res));
+            begin += n;
+            _offset += n;
+        }
+    }
+
+    /**
+     * @brief 开启或关闭文件的 O_DIRECT
+     */
+    void _setDirect(bool isDirect) {
+        int fl = ::fcntl(_fd, F_GETFL);
+        if (fl < 0 || ::fcntl(_fd, F_SETFL, isDirect ? fl | O_DIRECT : fl & ~O_DIRECT) < 0) [[unlikely]] {
+            throw std::system_error(errno, std::system_category());
+        }
+    }
+
+    /**
+     * @brief 攒满一整个缓冲区才写入, 以保证 O_DIRECT 的长度与偏移量对齐
+     * @note 开始的偏移量没有对齐时, 先关闭 O_DIRECT 写入到下一个块边界为止的部分
+     */
+    coroutine::Task<> _directWrite(std::span<char const> buf) {
+        if (!_bufPos && _offset % kAlign && !buf.empty()) [[unlikely]] {
+            auto head = buf.first(std::min(
+                buf.size(), kAlign - static_cast<std::size_t>(_offset % kAlign)));
+            _setDirect(false);
+            co_await _directFlushFrom(head);
+            _setDirect(true);
+            buf = buf.subspan(head.size());
+        }
+        while (!buf.empty()) {
+            auto n = std::min(buf.size(), _directBuf.size() - _bufPos);
+            std::memcpy(_directBuf.data() + _bufPos, buf.data(), n);
+            _bufPos += n;
+            buf = buf.subspan(n);
+            if (_bufPos == _directBuf.size()) {
+                co_await _directFlush(0, _bufPos);
+                _bufPos = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief 写入缓冲区中剩余的数据: 对齐的部分照常写入, 末尾不足一块的部分关闭 O_DIRECT 后写入
+     */
+    coroutine::Task<> _directWriteTail() {
+        auto end = std::exchange(_bufPos, 0);
+        auto aligned = end & ~(kAlign - 1);
+        co_await _directFlush(0, aligned);
+        if (aligned != end) {
+            _setDirect(false);
+            co_await _directFlush(aligned, end);
+        }
+    }
+
+    /**
+     * @brief 以缓冲区为单位, 从对齐的偏移量读入, 再拷贝给调用者 (偏移量不对齐时, 跳过向下对齐多读的开头部分)
+     */
+    coroutine::Task<int> _directRead(std::span<char> buf) {
+        if (_bufPos >= _bufLen) {
+            auto skip = static_cast<std::size_t>(_offset % kAlign);
+            auto begin = _offset - skip;
+            int res = _bufIdx >= 0
+                ? co_await _eventLoop.makeAioTask().prepReadFixed(_fd, _directBuf, begin, _bufIdx)
+                : co_await _eventLoop.makeAioTask().prepRead(_fd, _directBuf, begin);
+            _bufLen = static_cast<std::size_t>(HXLIBS_CHECK_EVENT_LOOP(res));
+            _bufPos = skip;
+            if (_bufLen <= skip) { // EOF
+                _bufPos = _bufLen = 0;
+                co_return 0;
+            }
+        }
+        auto n = std::min(buf.size(), _bufLen - _bufPos);
+        std::memcpy(buf.data(), _directBuf.data() + _bufPos, n);
+        _bufPos += n;
+        _offset += n;
+        co_return static_cast<int>(n);
+    }
+#endif
+
+    void _releaseDirectBuf() noexcept {
+#if defined(__linux__)
+        if (_bufIdx >= 0) {
+            _eventLoop.getEventDrive().getFixedBufPool()->release(_bufIdx);
+            _bufIdx = -1;
+        }
+        _ownBuf.reset();
+        _directBuf = {};
+#endif
+    }
+
     coroutine::EventLoop& _eventLoop;
     uint64_t _offset;
     LocalFdType _fd;
+    IoMode _mode;
+#if defined(__linux__)
+    coroutine::AlignedBufPtr _ownBuf;   // 自行分配的对齐缓冲区
+    std::span<char> _directBuf;         // IoMode::Direct 的缓冲区
+    int _bufIdx;                        // 注册缓冲区下标, -1 为非注册的缓冲区
+    std::size_t _bufPos;                // 写: 已缓冲的字节数; 读: 已拷贝到的位置
+    std::size_t _bufLen;                // 读: 缓冲区中有效的字节数 (写时恒为 0)
+#endif
 };
 
 /**
@@ -0,0 +1,126 @@
+// 每秒接受的连接数: 多发 accept (Acceptor 当前的路径) 与逐个 prepAccept (之前的路径) 对比
+// 用法: 01_accept_bench [客户端线程数=4] [每轮毫秒数=2000]
+#include <cstdio>
+
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+
+#include <BenchUtils.hpp>
+
+using namespace HX;
+using namespace HX::coroutine;
+
+namespace {
+
+constexpr uint16_t kPort = 28351;
+
+int makeListenFd() {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    ::sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(kPort);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::bind(fd, reinterpret_cast<::sockaddr*>(&addr), sizeof(addr)) < 0
+        || ::listen(fd, 4096) < 0
+    ) {
+        throw std::runtime_error{"bind/listen failed"};
+    }
+    return fd;
+}
+
+/**
+ * @brief 逐个提交 accept, 每个连接一次提交
+ */
+Task<> acceptOneByOne(EventLoop& loop, int serverFd, std::atomic_bool& isStop, uint64_t& accepted) {
+    while (!isStop) {
+        int fd = co_await loop.makeAioTask().prepAccept(serverFd, nullptr, nullptr, 0);
+        if (fd >= 0) {
+            ::close(fd);
+            ++accepted;
+        }
+    }
+}
+
+/**
+ * @brief 多发 accept: 一次提交, 每个连接一个 cqe
+ * @return false 内核不支持
+ */
+Task<bool> acceptMultishot(EventLoop& loop, int serverFd, std::atomic_bool& isStop, uint64_t& accepted) {
+    auto task = loop.makeMultishotAioTask();
+    task.prepMultishotAccept(serverFd, nullptr, nullptr, 0);
+    bool isCanceled = false;
+    do {
+        int fd = co_await task;
+        if (fd == -EINVAL && !accepted) {
+            co_return false;
+        }
+        if (fd >= 0) {
+            ::close(fd);
+            ++accepted;
+        }
+        if (isStop && !isCanceled) {
+            isCanceled = true;
+            loop.makeAioTask().prepCancel(task.userData(), 0).detach();
+        }
+    } while (task.isArmed());
+    co_return true;
+}
+
+/**
+ * @brief 客户端线程不停地建立、关闭连接, 直到时间用完
+ */
+void runClients(std::size_t threadNum, std::chrono::milliseconds duration) {
+    auto deadline = bench::Clock::now() + duration;
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 0; i < threadNum; ++i) {
+        threads.emplace_back([deadline] {
+            // 以 RST 关闭, 否则 TIME_WAIT 会耗尽本地端口, 后一轮会越跑越慢
+            ::linger lin{1, 0};
+            while (bench::Clock::now() < deadline) {
+                int fd = bench::connectTo(kPort);
+                ::setsockopt(fd, SOL_SOCKET, SO_LINGER, &lin, sizeof(lin));
+                ::close(fd);
+            }
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto threadNum = bench::argOr(argc, argv, 1, 4);
+    std::chrono::milliseconds duration{bench::argOr(argc, argv, 2, 2000)};
+    int serverFd = makeListenFd();
+    for (bool isMultishot : {false, true}) {
+        std::atomic_bool isStop{false};
+        uint64_t accepted = 0;
+        bool isSupported = true;
+        std::jthread server{[&] {
+            EventLoop loop;
+            if (isMultishot) {
+                isSupported = loop.sync(acceptMultishot(loop, serverFd, isStop, accepted));
+            } else {
+                loop.sync(acceptOneByOne(loop, serverFd, isStop, accepted));
+            }
+        }};
+        auto begin = bench::Clock::now();
+        auto cpu = bench::cpuSeconds();
+        runClients(threadNum, duration);
+        auto sec = std::chrono::duration<double>(bench::Clock::now() - begin).count();
+        cpu = bench::cpuSeconds() - cpu;
+        isStop = true;
+        ::close(bench::connectTo(kPort)); // 唤醒等待中的 accept
+        server.join();
+        auto num = accepted - 1;
+        if (!isSupported) {
+            std::printf("%-10s  not supported by the kernel\n", "multishot");
+            continue;
+        }
+        std::printf("%-10s  %10.0f accepts/s  %6.2f us cpu/accept (含客户端)\n",
+            isMultishot ? "multishot" : "single",
+            static_cast<double>(num) / sec,
+            cpu * 1e6 / static_cast<double>(num));
+    }
+    ::close(serverFd);
+}
@@ -0,0 +1,43 @@
+// hello world 的 RPS 与延迟; 以 IO_URING_FIXED_FILE=1 编译的同名 _fixed_file 目标与之对比
+// 用法: 03_hello_rps_bench [连接数=16] [毫秒数=3000] [服务端线程数=1]
+#include <cstdio>
+
+#include <HXLibs/net/Api.hpp>
+
+#include <BenchUtils.hpp>
+
+using namespace HX;
+using namespace std::string_view_literals;
+
+namespace {
+
+constexpr uint16_t kPort = 28353;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto connNum = bench::argOr(argc, argv, 1, 16);
+    std::chrono::milliseconds duration{bench::argOr(argc, argv, 2, 3000)};
+    auto threadNum = bench::argOr(argc, argv, 3, 1);
+
+    net::HttpServer ser{"127.0.0.1", std::to_string(kPort)};
+    ser.addEndpoint<net::GET>("/", [] ENDPOINT {
+        co_await res.setStatusAndContent(net::Status::CODE_200, "Hello World!").sendRes();
+    });
+    ser.asyncRun(threadNum);
+    test::waitForServer(kPort);
+
+    // 预热
+    bench::runHttpLoad(kPort, "GET / HTTP/1.1\r\nHost: x\r\n\r\n"sv, connNum,
+        std::chrono::milliseconds{300});
+
+    auto cpu = bench::cpuSeconds();
+    auto res = bench::runHttpLoad(kPort, "GET / HTTP/1.1\r\nHost: x\r\n\r\n"sv, connNum, duration);
+    cpu = bench::cpuSeconds() - cpu;
+    std::printf("%-10s  %10.0f req/s  p50 %7.1f us  p99 %7.1f us  %6.2f us cpu/req (含客户端)\n",
+        platform::kUseFixedFile ? "fixed-file" : "plain-fd",
+        res.rps(),
+        static_cast<double>(res.latency.percentile(0.5)) / 1e3,
+        static_cast<double>(res.latency.percentile(0.99)) / 1e3,
+        cpu * 1e6 / static_cast<double>(res.requests));
+}
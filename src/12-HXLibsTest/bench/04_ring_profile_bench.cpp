@@ -0,0 +1,54 @@
+// 不同 RingProfile 下 hello world 的延迟 (p50/p99) 与吞吐
+// 内核不支持的 profile 会逐级回退 (见 IoUring 的构造函数), 此时结果与回退到的 profile 相同
+// 用法: 04_ring_profile_bench [连接数=4] [每轮毫秒数=2000] [服务端线程数=1]
+#include <cstdio>
+
+#include <HXLibs/net/Api.hpp>
+
+#include <BenchUtils.hpp>
+
+using namespace HX;
+using namespace std::string_view_literals;
+
+namespace {
+
+constexpr uint16_t kPort = 28354;
+
+constexpr auto kGet = "GET / HTTP/1.1\r\nHost: x\r\n\r\n"sv;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto connNum = bench::argOr(argc, argv, 1, 4);
+    std::chrono::milliseconds duration{bench::argOr(argc, argv, 2, 2000)};
+    auto threadNum = bench::argOr(argc, argv, 3, 1);
+
+    constexpr std::pair<coroutine::RingProfile, char const*> kProfiles[] {
+        {coroutine::RingProfile::Default, "Default"},
+        {coroutine::RingProfile::CoopTaskrun, "CoopTaskrun"},
+        {coroutine::RingProfile::SingleIssuer, "SingleIssuer"},
+        {coroutine::RingProfile::SqPoll, "SqPoll"},
+    };
+    for (auto [profile, name] : kProfiles) {
+        bench::LoadResult res;
+        double cpu;
+        {
+            net::HttpServer ser{"127.0.0.1", std::to_string(kPort)};
+            ser.addEndpoint<net::GET>("/", [] ENDPOINT {
+                co_await res.setStatusAndContent(net::Status::CODE_200, "Hello World!").sendRes();
+            });
+            ser.asyncRun(threadNum, {}, coroutine::EventLoopConfig{.profile = profile});
+            test::waitForServer(kPort);
+            bench::runHttpLoad(kPort, kGet, connNum, std::chrono::milliseconds{300}); // 预热
+            cpu = bench::cpuSeconds();
+            res = bench::runHttpLoad(kPort, kGet, connNum, duration);
+            cpu = bench::cpuSeconds() - cpu;
+        }
+        std::printf("%-12s  %10.0f req/s  p50 %7.1f us  p99 %7.1f us  %6.2f us cpu/req (含客户端)\n",
+            name,
+            res.rps(),
+            static_cast<double>(res.latency.percentile(0.5)) / 1e3,
+            static_cast<double>(res.latency.percentile(0.99)) / 1e3,
+            cpu * 1e6 / static_cast<double>(res.requests));
+    }
+}
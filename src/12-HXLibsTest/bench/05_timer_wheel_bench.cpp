@@ -0,0 +1,137 @@
+// 定时器的插入、取消、到期吞吐: 分层时间轮 (当前的 TimerLoop) 与 std::multimap (之前的实现) 对比
+// 用法: 05_timer_wheel_bench [定时器数=500000]
+#include <cstdio>
+#include <map>
+#include <random>
+#include <thread>
+
+#include <HXLibs/coroutine/loop/TimerLoop.hpp>
+
+#include <BenchUtils.hpp>
+
+using namespace HX;
+using namespace HX::coroutine;
+
+namespace {
+
+using Clock = TimerLoop::Clock;
+
+/**
+ * @brief 当前的时间轮
+ */
+class WheelTimers {
+public:
+    void insert(std::vector<Clock::time_point> const& deadlines) {
+        _awaiters.clear();
+        _awaiters.reserve(deadlines.size());
+        for (auto t : deadlines) {
+            _awaiters.push_back(TimerLoop::makeTimer(_timerLoop).sleepUntil(t));
+            _awaiters.back().await_suspend(std::noop_coroutine());
+        }
+    }
+
+    void cancelAll() {
+        for (auto& awaiter : _awaiters) {
+            awaiter.cancel();
+        }
+    }
+
+    std::optional<Clock::duration> run() {
+        return _timerLoop.run();
+    }
+private:
+    TimerLoop _timerLoop;
+    std::vector<TimerLoop::TimerAwaiter> _awaiters;
+};
+
+/**
+ * @brief 之前的实现: 红黑树, 每个定时器一次节点分配, 取消为一次树上删除
+ */
+class MapTimers {
+public:
+    void insert(std::vector<Clock::time_point> const& deadlines) {
+        _its.clear();
+        _its.reserve(deadlines.size());
+        for (auto t : deadlines) {
+            _its.push_back(_map.emplace(t, std::noop_coroutine()));
+        }
+    }
+
+    void cancelAll() {
+        for (auto it : _its) {
+            _map.erase(it);
+        }
+    }
+
+    std::optional<Clock::duration> run() {
+        auto nowTime = Clock::now();
+        while (!_map.empty()) {
+            auto it = _map.begin();
+            if (it->first > nowTime) {
+                return it->first - nowTime;
+            }
+            auto handle = it->second;
+            _map.erase(it);
+            handle.resume();
+        }
+        return {};
+    }
+private:
+    std::multimap<Clock::time_point, std::coroutine_handle<>> _map;
+    std::vector<decltype(_map)::iterator> _its;
+};
+
+/**
+ * @brief 生成到期时间: [0, maxMs) 毫秒内均匀分布
+ */
+std::vector<Clock::time_point> makeDeadlines(std::size_t n, uint32_t maxMs) {
+    std::mt19937 rng{42};
+    auto now = Clock::now();
+    std::vector<Clock::time_point> res(n);
+    for (auto& t : res) {
+        t = now + std::chrono::microseconds{rng() % (maxMs * 1000ULL)};
+    }
+    return res;
+}
+
+double nsPerOp(Clock::duration d, std::size_t n) {
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()) / static_cast<double>(n);
+}
+
+template <typename Timers>
+void runBench(char const* name, std::size_t n) {
+    Timers timers;
+
+    // 插入 + 取消: 空闲连接的超时, 绝大多数不会到期
+    auto deadlines = makeDeadlines(n, 60'000);
+    auto t0 = Clock::now();
+    timers.insert(deadlines);
+    auto t1 = Clock::now();
+    timers.cancelAll();
+    auto t2 = Clock::now();
+
+    // 到期: 只统计 run() 内的时间, 不计等待
+    deadlines = makeDeadlines(n, 200);
+    timers.insert(deadlines);
+    Clock::duration runTime{};
+    for (;;) {
+        auto t = Clock::now();
+        auto next = timers.run();
+        runTime += Clock::now() - t;
+        if (!next) {
+            break;
+        }
+        std::this_thread::sleep_for(*next);
+    }
+    std::printf("%-10s  insert %6.1f ns/op  cancel %6.1f ns/op  expire %6.1f ns/op\n",
+        name, nsPerOp(t1 - t0, n), nsPerOp(t2 - t1, n), nsPerOp(runTime, n));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto n = bench::argOr(argc, argv, 1, 500'000);
+    runBench<WheelTimers>("wheel", n);
+    runBench<MapTimers>("multimap", n);
+}
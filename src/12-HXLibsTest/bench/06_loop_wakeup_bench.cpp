@@ -0,0 +1,72 @@
+// 事件循环的唤醒抖动:
+//  1. 定时器: sleepFor(d) 实际醒来比到期时间晚了多少
+//     (TimerLoop 精度 1ms, 到期时间向上取整到整毫秒, 这里按取整后的时间计算, 只统计事件循环本身的延迟)
+//  2. 投递: 事件循环只有定时器 (阻塞在内核的超时等待中) 时, 其他线程 post 到任务执行的延迟
+// 用法: 06_loop_wakeup_bench [每项次数=500]
+#include <cstdio>
+
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+
+#include <BenchUtils.hpp>
+
+using namespace HX;
+using namespace HX::coroutine;
+using namespace std::chrono_literals;
+
+namespace {
+
+void print(char const* name, bench::LatencyRecorder& lat) {
+    std::printf("%-22s  p50 %8.1f us  p99 %8.1f us  max %8.1f us\n",
+        name,
+        static_cast<double>(lat.percentile(0.5)) / 1e3,
+        static_cast<double>(lat.percentile(0.99)) / 1e3,
+        static_cast<double>(lat.percentile(1.0)) / 1e3);
+}
+
+Task<> sleepLateness(EventLoop& loop, std::chrono::milliseconds d, std::size_t n, bench::LatencyRecorder& lat) {
+    for (std::size_t i = 0; i < n; ++i) {
+        auto deadline = std::chrono::ceil<std::chrono::milliseconds>(bench::Clock::now() + d);
+        co_await loop.makeTimer().sleepUntil(deadline);
+        lat.add(bench::Clock::now() - deadline);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto n = bench::argOr(argc, argv, 1, 500);
+    {
+        EventLoop loop;
+        for (auto d : {1ms, 5ms, 20ms}) {
+            bench::LatencyRecorder lat;
+            loop.sync(sleepLateness(loop, d, d < 20ms ? n : n / 10, lat));
+            char name[32];
+            std::snprintf(name, sizeof(name), "sleep %ldms 迟到", static_cast<long>(d.count()));
+            print(name, lat);
+        }
+    }
+    {
+        EventLoop loop;
+        bench::LatencyRecorder lat;
+        std::size_t got = 0;
+        auto waiter = [&]() -> Task<> {
+            // 只有定时器, 没有 IO
+            while (got < n) {
+                co_await loop.makeTimer().sleepFor(100ms);
+            }
+        };
+        std::jthread poster{[&] {
+            std::this_thread::sleep_for(10ms);
+            for (std::size_t i = 0; i < n; ++i) {
+                auto t0 = bench::Clock::now();
+                loop.post([t0, &lat, &got] {
+                    lat.add(bench::Clock::now() - t0);
+                    ++got;
+                });
+                std::this_thread::sleep_for(1ms);
+            }
+        }};
+        loop.sync(waiter());
+        print("post -> 执行", lat);
+    }
+}
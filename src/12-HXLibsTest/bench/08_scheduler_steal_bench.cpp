@@ -0,0 +1,94 @@
+// 偏斜负载下 Scheduler 开启 / 关闭工作窃取的吞吐、任务完成时间 (p50/p99) 与各线程的负载分布
+// 所有任务都先切换到同一个事件循环 (模拟一个热点核心), 之后每轮计算一段时间再 yield()
+// 用法: 08_scheduler_steal_bench [线程数=4] [任务数=2000] [每任务轮数=50] [每轮计算量=20000]
+#include <cstdio>
+
+#include <HXLibs/coroutine/loop/Scheduler.hpp>
+
+#include <BenchUtils.hpp>
+
+using namespace HX;
+using namespace HX::coroutine;
+
+namespace {
+
+constexpr std::size_t kMaxThreadNum = 64;
+
+struct Stats {
+    std::atomic_uint64_t doneNum{0};
+    std::atomic_uint64_t rounds[kMaxThreadNum]{};
+    std::atomic_size_t threadNum{0};
+    std::vector<bench::Clock::time_point> doneAt;
+};
+
+/**
+ * @brief 本线程在 Stats::rounds 中的下标
+ */
+std::size_t threadIdx(Stats& stats) {
+    thread_local std::size_t idx = stats.threadNum++;
+    return idx;
+}
+
+Task<> work(Scheduler& s, EventLoop& hot, Stats& stats, std::size_t id,
+            std::size_t roundNum, std::size_t spin) {
+    co_await hot.schedule();
+    for (std::size_t r = 0; r < roundNum; ++r) {
+        std::size_t x = 0;
+        for (std::size_t i = 0; i < spin; ++i) {
+            x += i;
+            asm volatile("" : "+r"(x));
+        }
+        stats.rounds[threadIdx(stats)].fetch_add(1, std::memory_order_relaxed);
+        co_await s.yield();
+    }
+    stats.doneAt[id] = bench::Clock::now();
+    stats.doneNum.fetch_add(1, std::memory_order_release);
+}
+
+Task<> findLoop(std::atomic<EventLoop*>& res) {
+    res = &Scheduler::currentLoop();
+    co_return;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto threadNum = std::min<std::size_t>(bench::argOr(argc, argv, 1, 4), kMaxThreadNum);
+    auto taskNum = bench::argOr(argc, argv, 2, 2000);
+    auto roundNum = bench::argOr(argc, argv, 3, 50);
+    auto spin = bench::argOr(argc, argv, 4, 20000);
+    for (bool isSteal : {false, true}) {
+        Stats stats;
+        stats.doneAt.resize(taskNum);
+        double sec;
+        {
+            Scheduler s{threadNum, {}, isSteal};
+            std::atomic<EventLoop*> hot{nullptr};
+            s.spawn(findLoop(hot));
+            while (!hot) {
+                std::this_thread::yield();
+            }
+            auto begin = bench::Clock::now();
+            for (std::size_t i = 0; i < taskNum; ++i) {
+                s.spawn(work(s, *hot, stats, i, roundNum, spin));
+            }
+            while (stats.doneNum.load(std::memory_order_acquire) < taskNum) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+            sec = std::chrono::duration<double>(bench::Clock::now() - begin).count();
+            bench::LatencyRecorder lat;
+            for (auto t : stats.doneAt) {
+                lat.add(t - begin);
+            }
+            std::printf("%-9s  %10.0f rounds/s  完成时间 p50 %7.1f ms  p99 %7.1f ms  各线程轮数:",
+                isSteal ? "steal" : "no-steal",
+                static_cast<double>(taskNum * roundNum) / sec,
+                static_cast<double>(lat.percentile(0.5)) / 1e6,
+                static_cast<double>(lat.percentile(0.99)) / 1e6);
+        }
+        for (std::size_t i = 0; i < stats.threadNum; ++i) {
+            std::printf(" %lu", static_cast<unsigned long>(stats.rounds[i].load()));
+        }
+        std::printf("\n");
+    }
+}
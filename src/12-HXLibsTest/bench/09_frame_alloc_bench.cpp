@@ -0,0 +1,73 @@
+// hello world 每个请求在服务端线程上的内存分配次数与 RPS;
+// 以 HX_FRAME_POOL=0 编译的同名 _no_pool 目标 (协程帧直接走全局堆) 与之对比
+// 用法: 09_frame_alloc_bench [连接数=4] [毫秒数=3000]
+#include <cstdio>
+
+#include <HXLibs/net/Api.hpp>
+
+#include <BenchUtils.hpp>
+#include <CountingAlloc.hpp>
+
+using namespace HX;
+using namespace std::string_view_literals;
+
+namespace {
+
+constexpr uint16_t kPort = 28359;
+
+/**
+ * @brief 服务端线程在处理请求时发布的计数 (服务端只有一个线程)
+ */
+struct ServerCounters {
+    std::atomic_uint64_t requests{0};
+    std::atomic_uint64_t newNum{0};
+    std::atomic_uint64_t frameNum{0};
+    std::atomic_uint64_t frameHeapNum{0};
+};
+
+ServerCounters gCounters;
+
+struct Snapshot {
+    uint64_t requests, newNum, frameNum, frameHeapNum;
+
+    static Snapshot take() noexcept {
+        return {gCounters.requests.load(), gCounters.newNum.load(),
+                gCounters.frameNum.load(), gCounters.frameHeapNum.load()};
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto connNum = bench::argOr(argc, argv, 1, 4);
+    std::chrono::milliseconds duration{bench::argOr(argc, argv, 2, 3000)};
+
+    net::HttpServer ser{"127.0.0.1", std::to_string(kPort)};
+    ser.addEndpoint<net::GET>("/", [] ENDPOINT {
+        auto const& stats = coroutine::FrameAllocator::stats();
+        gCounters.newNum.store(bench::newNum(), std::memory_order_relaxed);
+        gCounters.frameNum.store(stats.allocNum, std::memory_order_relaxed);
+        gCounters.frameHeapNum.store(stats.heapNum, std::memory_order_relaxed);
+        gCounters.requests.fetch_add(1, std::memory_order_relaxed);
+        co_await res.setStatusAndContent(net::Status::CODE_200, "Hello World!").sendRes();
+    });
+    ser.asyncRun(1);
+    test::waitForServer(kPort);
+
+    constexpr auto kGet = "GET / HTTP/1.1\r\nHost: x\r\n\r\n"sv;
+    bench::runHttpLoad(kPort, kGet, connNum, std::chrono::milliseconds{300}); // 预热, 填满帧缓存
+    auto begin = Snapshot::take();
+    auto res = bench::runHttpLoad(kPort, kGet, connNum, duration);
+    auto end = Snapshot::take();
+
+    auto perReq = [n = static_cast<double>(end.requests - begin.requests)](uint64_t a, uint64_t b) {
+        return static_cast<double>(b - a) / n;
+    };
+    std::printf("%-8s  %10.0f req/s  p99 %7.1f us  服务端每请求: operator new %5.2f 次, 协程帧 %5.2f 个 (其中走全局堆 %5.2f)\n",
+        coroutine::kEnableFramePool ? "pool" : "no-pool",
+        res.rps(),
+        static_cast<double>(res.latency.percentile(0.99)) / 1e3,
+        perReq(begin.newNum, end.newNum),
+        perReq(begin.frameNum, end.frameNum),
+        perReq(begin.frameHeapNum, end.frameHeapNum));
+}
@@ -0,0 +1,116 @@
+// 零拷贝发送 (sendZcThreshold) 开启 / 关闭时的吞吐与每 GB 的 CPU 时间:
+//  1. IO 层: 一个连接上不停地 fullySendZc 同一块缓冲区
+//  2. HTTP 层: 大响应体 (走 Response 的 fullySendv)
+// 注意: 回环 (127.0.0.1) 上内核投递时仍然要拷贝, 零拷贝的收益需要在真实网卡上测量
+// 用法: 12_send_zc_bench [每轮 MB=2048] [响应体 KB=4096] [连接数=2] [每轮毫秒数=3000]
+#include <cstdio>
+
+#include <HXLibs/net/Api.hpp>
+
+#include <BenchUtils.hpp>
+
+using namespace HX;
+using namespace std::string_view_literals;
+
+namespace {
+
+constexpr uint16_t kPort = 28362;
+
+constexpr std::size_t kZcThreshold = 64 * 1024;
+
+constexpr std::size_t kChunkSize = 1 << 20;
+
+double toGB(uint64_t bytes) {
+    return static_cast<double>(bytes) / static_cast<double>(1ULL << 30);
+}
+
+void runIo(bool isZc, std::size_t total) {
+    int listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    ::sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::socklen_t len = sizeof(addr);
+    ::bind(listenFd, reinterpret_cast<::sockaddr*>(&addr), len);
+    ::listen(listenFd, 1);
+    ::getsockname(listenFd, reinterpret_cast<::sockaddr*>(&addr), &len);
+
+    std::jthread reader{[&] {
+        int fd = bench::connectTo(ntohs(addr.sin_port));
+        std::vector<char> buf(kChunkSize);
+        std::size_t got = 0;
+        while (got < total) {
+            auto n = ::recv(fd, buf.data(), buf.size(), 0);
+            if (n <= 0) {
+                break;
+            }
+            got += static_cast<std::size_t>(n);
+        }
+        ::close(fd);
+    }};
+    int fd = ::accept(listenFd, nullptr, nullptr);
+
+    coroutine::EventLoop loop{coroutine::EventLoopConfig{
+        .sendZcThreshold = isZc ? kZcThreshold : static_cast<std::size_t>(-1)}};
+    std::vector<char> buf(kChunkSize, 'x');
+    auto begin = bench::Clock::now();
+    auto cpu = bench::cpuSeconds();
+    loop.sync([&]() -> coroutine::Task<> {
+        net::IO io{fd, loop};
+        for (std::size_t sent = 0; sent < total; sent += kChunkSize) {
+            co_await io.fullySendZc(buf);
+        }
+        io.reset();
+    }());
+    reader.join();
+    auto sec = std::chrono::duration<double>(bench::Clock::now() - begin).count();
+    cpu = bench::cpuSeconds() - cpu;
+    std::printf("IO    %-4s  %6.2f GB/s  %6.3f s cpu/GB (含接收端)%s\n",
+        isZc ? "zc" : "copy",
+        toGB(total) / sec,
+        cpu / toGB(total),
+        isZc && loop.getEventDrive().sendZcThreshold() == static_cast<std::size_t>(-1)
+            ? "  (内核不支持, 已回退)" : "");
+    ::close(fd);
+    ::close(listenFd);
+}
+
+void runHttp(bool isZc, std::size_t bodySize, std::size_t connNum, std::chrono::milliseconds duration) {
+    bench::LoadResult load;
+    double cpu;
+    {
+        std::string body(bodySize, 'x');
+        net::HttpServer ser{"127.0.0.1", std::to_string(kPort)};
+        ser.addEndpoint<net::GET>("/", [&] ENDPOINT {
+            co_await res.setStatusAndContent(net::Status::CODE_200, body).sendRes();
+        });
+        ser.asyncRun(1, {}, coroutine::EventLoopConfig{
+            .sendZcThreshold = isZc ? kZcThreshold : static_cast<std::size_t>(-1)});
+        test::waitForServer(kPort);
+        constexpr auto kGet = "GET / HTTP/1.1\r\nHost: x\r\n\r\n"sv;
+        cpu = bench::cpuSeconds();
+        load = bench::runHttpLoad(kPort, kGet, connNum, duration);
+        cpu = bench::cpuSeconds() - cpu;
+    }
+    auto gb = toGB(load.requests * bodySize);
+    std::printf("HTTP  %-4s  %6.2f GB/s  %6.3f s cpu/GB (含客户端)  %8.0f req/s  p99 %8.1f us\n",
+        isZc ? "zc" : "copy",
+        gb / load.seconds,
+        cpu / gb,
+        load.rps(),
+        static_cast<double>(load.latency.percentile(0.99)) / 1e3);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto total = bench::argOr(argc, argv, 1, 2048) << 20;
+    auto bodySize = bench::argOr(argc, argv, 2, 4096) << 10;
+    auto connNum = bench::argOr(argc, argv, 3, 2);
+    std::chrono::milliseconds duration{bench::argOr(argc, argv, 4, 3000)};
+    for (bool isZc : {false, true}) {
+        runIo(isZc, total);
+    }
+    for (bool isZc : {false, true}) {
+        runHttp(isZc, bodySize, connNum, duration);
+    }
+}
@@ -0,0 +1,81 @@
+// Channel 生产者 / 消费者在不同容量下的每条消息耗时: 同一个事件循环内, 以及跨两个事件循环 (两个线程)
+// 用法: 16_channel_bench [消息数=2000000]
+#include <cstdio>
+
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+#include <HXLibs/coroutine/sync/Channel.hpp>
+
+#include <BenchUtils.hpp>
+
+using namespace HX;
+using namespace HX::coroutine;
+
+namespace {
+
+void print(char const* name, std::size_t cap, bench::Clock::duration d, std::size_t n, bool isOk) {
+    std::printf("cap %5zu  %-10s  %7.1f ns/msg%s\n", cap, name,
+        static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count())
+            / static_cast<double>(n),
+        isOk ? "" : "  (结果错误!)");
+}
+
+void runSameLoop(std::size_t cap, std::size_t n) {
+    EventLoop loop;
+    Channel<std::size_t> ch{cap};
+    std::size_t sum = 0;
+    auto producer = [&]() -> Task<> {
+        for (std::size_t i = 0; i < n; ++i) {
+            co_await ch.send(i);
+        }
+        ch.close();
+    };
+    auto consumer = [&]() -> Task<> {
+        while (auto val = co_await ch.recv()) {
+            sum += *val;
+        }
+    };
+    auto begin = bench::Clock::now();
+    loop.sync(whenAll(consumer(), producer()));
+    print("same loop", cap, bench::Clock::now() - begin, n, sum == n * (n - 1) / 2);
+}
+
+void runCrossLoop(std::size_t cap, std::size_t n) {
+    Channel<std::size_t> ch{cap};
+    std::size_t sum = 0;
+    // 唤醒可能投递到了对方的事件循环, 两边都退出后才能析构
+    std::atomic_int doneNum{0};
+    auto runLoop = [&](auto makeTask) {
+        EventLoop loop;
+        loop.sync(makeTask());
+        ++doneNum;
+        while (doneNum < 2) {
+            std::this_thread::yield();
+        }
+    };
+    auto begin = bench::Clock::now();
+    {
+        std::jthread consumer{runLoop, [&]() -> Task<> {
+            while (auto val = co_await ch.recv()) {
+                sum += *val;
+            }
+        }};
+        std::jthread producer{runLoop, [&]() -> Task<> {
+            for (std::size_t i = 0; i < n; ++i) {
+                co_await ch.send(i);
+            }
+            ch.close();
+        }};
+    }
+    print("cross loop", cap, bench::Clock::now() - begin, n, sum == n * (n - 1) / 2);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto n = bench::argOr(argc, argv, 1, 2'000'000);
+    for (std::size_t cap : {0, 1, 16, 256, 4096}) {
+        runSameLoop(cap, n);
+        // 无缓冲时每条消息都要跨线程交接一次, 减少消息数
+        runCrossLoop(cap, cap ? n : n / 10);
+    }
+}
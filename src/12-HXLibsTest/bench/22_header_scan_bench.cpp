@@ -0,0 +1,122 @@
+// 请求头扫描在 1 / 10 / 40 个请求头时的耗时, 按指令集 (标量 / SSE4.2 / AVX2) 对比:
+//  1. 只扫描: internal::LineScanner 找出所有行与 ':', 以及之前逐行 find("\r\n") 再找 ": " 的做法
+//  2. 完整解析: 经过 Request::parserReq / clear (见 ParseBench.hpp, 含摊销的 recv)
+// 只测试本机 CPU 支持的指令集
+// 用法: 22_header_scan_bench [扫描次数=200000] [解析的请求数=100000]
+#include <cstdio>
+
+#include <HXLibs/net/protocol/http/HttpScanner.hpp>
+
+#include <ParseBench.hpp>
+#include <BenchUtils.hpp>
+
+using namespace HX;
+using namespace HX::net::internal;
+
+namespace {
+
+std::string makeRequest(std::size_t headerNum) {
+    static constexpr char const* kHeaders[] {
+        "Host: www.example.com",
+        "Connection: keep-alive",
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+        "Chrome/128.0.0.0 Safari/537.36",
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8",
+        "Accept-Encoding: gzip, deflate, br, zstd",
+        "Accept-Language: zh-CN,zh;q=0.9,en;q=0.8",
+        "Cookie: session=9f8e7d6c5b4a39281706f5e4d3c2b1a0; theme=dark; _ga=GA1.1.123456789.1700000000",
+        "Referer: https://www.example.com/dashboard/overview",
+        "sec-ch-ua: \"Chromium\";v=\"128\", \"Not;A=Brand\";v=\"24\"",
+        "If-None-Match: \"65a1b2c3-1f2e\"",
+    };
+    std::string res = "GET /static/js/app.3f2a1c.js?v=20261017 HTTP/1.1\r\n";
+    for (std::size_t i = 0; i < headerNum; ++i) {
+        if (i < std::size(kHeaders)) {
+            res += kHeaders[i];
+        } else {
+            res += "X-Custom-Header-" + std::to_string(i) + ": value-" + std::to_string(i * 7919) + "-abcdefghij";
+        }
+        res += "\r\n";
+    }
+    return res + "\r\n";
+}
+
+/**
+ * @brief 多轮取最快的一轮
+ * @return double 每次调用的纳秒数
+ */
+template <typename Func>
+double bestNs(std::size_t n, Func&& func) {
+    std::size_t sink = 0;
+    double res = 1e18;
+    for (int r = 0; r < 5; ++r) {
+        auto begin = bench::Clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            sink += func();
+        }
+        res = std::min(res, std::chrono::duration<double, std::nano>(bench::Clock::now() - begin).count()
+                            / static_cast<double>(n));
+    }
+    asm volatile("" : : "r"(sink));
+    return res;
+}
+
+/**
+ * @brief 之前的做法: 逐行 find("\r\n"), 再在行内找 ": "
+ */
+std::size_t scanByFind(std::string_view buf) {
+    std::size_t acc = 0;
+    for (std::size_t i = 0; i < buf.size();) {
+        auto end = buf.find("\r\n", i);
+        if (end == std::string_view::npos) {
+            break;
+        }
+        acc += buf.substr(i, end - i).find(": ");
+        i = end + 2;
+    }
+    return acc;
+}
+
+std::size_t scanByLineScanner(std::string_view buf) {
+    std::size_t acc = 0;
+    LineScanner scanner{buf, 0};
+    for (HeaderLine line; scanner.next(line);) {
+        acc += line.colon;
+    }
+    return acc;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto scanNum = bench::argOr(argc, argv, 1, 200'000);
+    auto parseNum = bench::argOr(argc, argv, 2, 100'000);
+    auto const detected = detectSimdLevel();
+    constexpr std::pair<SimdLevel, char const*> kLevels[] {
+        {SimdLevel::Scalar, "scalar"},
+        {SimdLevel::Sse42, "sse4.2"},
+        {SimdLevel::Avx2, "avx2"},
+    };
+    for (std::size_t headerNum : {1, 10, 40}) {
+        auto raw = makeRequest(headerNum);
+        std::printf("%2zu 个请求头 (%zu B)\n", headerNum, raw.size());
+        std::printf("  %-16s  扫描 %7.1f ns\n", "find (之前)", bestNs(scanNum, [&] {
+            return scanByFind(raw);
+        }));
+        for (auto [level, name] : kLevels) {
+            if (level > detected) {
+                break;
+            }
+            simdLevel() = level;
+            auto scan = bestNs(scanNum, [&] {
+                return scanByLineScanner(raw);
+            });
+            auto parse = bench::runParseLoad({raw}, parseNum, [] {
+                return uint64_t{0};
+            });
+            std::printf("  %-16s  扫描 %7.1f ns  完整解析 %7.1f ns cpu/req%s\n",
+                name, scan, parse.cpuNs, parse.requests == parseNum ? "" : "  (解析失败!)");
+        }
+        simdLevel() = detected;
+    }
+}
@@ -0,0 +1,45 @@
+// HTTP/1.1 流水线: 每个连接一次发出 depth 个请求, 不同深度下的 RPS 与每批的延迟
+// 深度为 1 时即普通的保活连接; 流水线中已经到达的请求的响应会合并为一次写入
+// 用法: 23_pipeline_bench [连接数=4] [每种深度的毫秒数=2000]
+#include <cstdio>
+
+#include <HXLibs/net/Api.hpp>
+
+#include <BenchUtils.hpp>
+
+using namespace HX;
+using namespace std::string_view_literals;
+
+namespace {
+
+constexpr uint16_t kPort = 28323;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto connNum = bench::argOr(argc, argv, 1, 4);
+    std::chrono::milliseconds duration{bench::argOr(argc, argv, 2, 2000)};
+
+    net::HttpServer ser{"127.0.0.1", std::to_string(kPort)};
+    ser.addEndpoint<net::GET>("/", [] ENDPOINT {
+        co_await res.setStatusAndContent(net::Status::CODE_200, "Hello World!").sendRes();
+    });
+    ser.asyncRun(1);
+    test::waitForServer(kPort);
+
+    constexpr auto kRequest = "GET / HTTP/1.1\r\nHost: x\r\n\r\n"sv;
+    // 预热
+    bench::runHttpLoad(kPort, kRequest, connNum, std::chrono::milliseconds{300});
+
+    for (std::size_t depth : {1, 2, 8, 32, 128}) {
+        auto cpu = bench::cpuSeconds();
+        auto res = bench::runHttpLoad(kPort, kRequest, connNum, duration, depth);
+        cpu = bench::cpuSeconds() - cpu;
+        std::printf("depth %3zu  %10.0f req/s  每批 p50 %8.1f us  p99 %8.1f us  %6.2f us cpu/req (含客户端)\n",
+            depth,
+            res.rps(),
+            static_cast<double>(res.latency.percentile(0.5)) / 1e3,
+            static_cast<double>(res.latency.percentile(0.99)) / 1e3,
+            cpu * 1e6 / static_cast<double>(res.requests));
+    }
+}
@@ -0,0 +1,93 @@
+// 路由查找在 10 / 1k / 10k 条路由时的耗时与内存分配次数 (RouterTree::find)
+// 路由混合了静态路径、`{param}` 与 `/**`, 按乱序查找, 使每次查找的路径都不同
+// 用法: 25_router_lookup_bench [每轮查找次数=1000000]
+#include <cstdio>
+#include <random>
+#include <numeric>
+
+#include <HXLibs/net/router/RouterTree.hpp>
+
+#include <BenchUtils.hpp>
+#include <CountingAlloc.hpp>
+
+using namespace HX;
+using namespace HX::net;
+
+namespace {
+
+struct Tagged {
+    std::size_t id;
+
+    coroutine::Task<> operator()(Request&, Response&) const {
+        co_return;
+    }
+};
+
+/**
+ * @brief 第 i 条路由的模版, 以及一个能匹配它的请求路径
+ */
+std::pair<std::string, std::string> makeRoute(std::size_t i) {
+    auto s = std::to_string(i);
+    switch (i % 4) {
+    case 0:
+        return {"/api/v1/res" + s + "/list", "/api/v1/res" + s + "/list"};
+    case 1:
+        return {"/api/v1/res" + s + "/{id}", "/api/v1/res" + s + "/12345"};
+    case 2:
+        return {"/users/{uid}/item" + s + "/{x}", "/users/42/item" + s + "/abc"};
+    default:
+        return {"/static" + s + "/**", "/static" + s + "/css/app.css"};
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto lookupNum = bench::argOr(argc, argv, 1, 1'000'000);
+    bool isAllocated = false;
+    for (std::size_t routeNum : {10, 1'000, 10'000}) {
+        RouterTree tree;
+        std::vector<std::string> paths;
+        for (std::size_t i = 0; i < routeNum; ++i) {
+            auto [tpl, path] = makeRoute(i);
+            tree.insert("GET", tpl, Tagged{i});
+            paths.push_back(std::move(path));
+        }
+        auto begin = bench::Clock::now();
+        tree.compile();
+        auto compileMs = std::chrono::duration<double, std::milli>(bench::Clock::now() - begin).count();
+
+        std::vector<std::size_t> order(routeNum);
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::shuffle(order.begin(), order.end(), std::mt19937{42});
+
+        PathParams params;
+        // 预热: params 的容量在第一次匹配时增长, 不计入查找的分配
+        for (auto const& path : paths) {
+            (void)tree.find("GET", path, params);
+        }
+        std::size_t wrongNum = 0;
+        double bestNs = 1e18;
+        uint64_t newNum = 0;
+        for (int r = 0; r < 5; ++r) {
+            auto news = bench::newNum();
+            begin = bench::Clock::now();
+            for (std::size_t k = 0; k < lookupNum; ++k) {
+                auto idx = order[k % routeNum];
+                auto const* tagged = tree.find("GET", paths[idx], params).target<Tagged>();
+                wrongNum += !tagged || tagged->id != idx;
+            }
+            bestNs = std::min(bestNs, std::chrono::duration<double, std::nano>(bench::Clock::now() - begin).count()
+                                      / static_cast<double>(lookupNum));
+            newNum += bench::newNum() - news;
+        }
+        std::printf("%6zu 条路由  编译 %8.2f ms  查找 %6.1f ns  %.2f 次分配/查找%s%s\n",
+            routeNum, compileMs, bestNs,
+            static_cast<double>(newNum) / static_cast<double>(5 * lookupNum),
+            wrongNum ? "  (查找结果错误!)" : "",
+            newNum ? "  (查找时分配了内存!)" : "");
+        isAllocated |= newNum != 0;
+    }
+    // 查找应当不分配内存
+    return isAllocated ? 1 : 0;
+}
@@ -0,0 +1,267 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 18:21:47
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include <RawHttpClient.hpp>
+
+namespace HX::bench {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief 延迟样本, 用于计算百分位
+ */
+class LatencyRecorder {
+public:
+    void add(Clock::duration d) {
+        _samples.push_back(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()));
+        _isSorted = false;
+    }
+
+    void merge(LatencyRecorder const& that) {
+        _samples.insert(_samples.end(), that._samples.begin(), that._samples.end());
+        _isSorted = false;
+    }
+
+    /**
+     * @brief 百分位
+     * @param p 如 0.5, 0.99
+     * @return uint64_t 纳秒, 没有样本时为 0
+     */
+    uint64_t percentile(double p) {
+        if (_samples.empty()) {
+            return 0;
+        }
+        if (!_isSorted) {
+            std::sort(_samples.begin(), _samples.end());
+            _isSorted = true;
+        }
+        auto idx = static_cast<std::size_t>(p * static_cast<double>(_samples.size() - 1));
+        return _samples[idx];
+    }
+
+    std::size_t size() const noexcept {
+        return _samples.size();
+    }
+private:
+    std::vector<uint64_t> _samples;
+    bool _isSorted = false;
+};
+
+/**
+ * @brief 进程已经使用的 CPU 时间 (用户态 + 内核态)
+ * @return double 秒
+ */
+inline double cpuSeconds() noexcept {
+    ::rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    auto toSec = [](::timeval tv) {
+        return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1e6;
+    };
+    return toSec(usage.ru_utime) + toSec(usage.ru_stime);
+}
+
+/**
+ * @brief 读取命令行参数, 缺省时使用默认值
+ */
+inline std::size_t argOr(int argc, char** argv, int idx, std::size_t val) {
+    return idx < argc ? std::strtoull(argv[idx], nullptr, 10) : val;
+}
+
+/**
+ * @brief 阻塞地连接到 127.0.0.1:port (关闭 Nagle)
+ * @return int fd
+ */
+inline int connectTo(uint16_t port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) [[unlikely]] {
+        throw std::runtime_error{"socket failed"};
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    ::sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<::sockaddr*>(&addr), sizeof(addr)) < 0) [[unlikely]] {
+        ::close(fd);
+        throw std::runtime_error{"connect failed"};
+    }
+    return fd;
+}
+
+/**
+ * @brief 从响应流中数出完整的响应 (只支持 Content-Length 的响应)
+ * @note 响应体只计数、不保存, 因此大的响应体不会带来额外的拷贝
+ */
+class ResponseCounter {
+public:
+    /**
+     * @brief 追加收到的数据
+     * @return std::size_t 新完成的响应数
+     */
+    std::size_t feed(std::string_view data) {
+        std::size_t res = 0;
+        while (!data.empty()) {
+            if (_isInBody) {
+                auto n = std::min(_bodyRemain, data.size());
+                _bodyRemain -= n;
+                data.remove_prefix(n);
+                if (!_bodyRemain) {
+                    _isInBody = false;
+                    ++res;
+                }
+                continue;
+            }
+            // 响应头: 通常完整地在一次 recv 中, 只有跨越了两次 recv 时才需要拼接
+            std::string_view head;
+            if (_head.empty()) {
+                auto headEnd = data.find("\r\n\r\n");
+                if (headEnd == std::string_view::npos) {
+                    _head.assign(data);
+                    break;
+                }
+                head = data.substr(0, headEnd);
+                data.remove_prefix(headEnd + 4);
+            } else {
+                auto old = _head.size();
+                _head += data;
+                auto headEnd = _head.find("\r\n\r\n", old < 3 ? 0 : old - 3);
+                if (headEnd == std::string::npos) {
+                    break;
+                }
+                head = std::string_view{_head}.substr(0, headEnd);
+                data.remove_prefix(headEnd + 4 - old);
+            }
+            auto it = head.find("Content-Length: ");
+            _bodyRemain = it == std::string_view::npos
+                ? 0
+                : std::strtoull(head.data() + it + 16, nullptr, 10);
+            _head.clear();
+            if (_bodyRemain) {
+                _isInBody = true;
+            } else {
+                ++res;
+            }
+        }
+        return res;
+    }
+private:
+    std::string _head;              // 跨越了两次 recv 的响应头
+    std::size_t _bodyRemain = 0;    // 当前响应体还差的字节数
+    bool _isInBody = false;
+};
+
+/**
+ * @brief 压测结果
+ */
+struct LoadResult {
+    uint64_t requests;
+    double seconds;
+    LatencyRecorder latency;
+
+    double rps() const noexcept {
+        return static_cast<double>(requests) / seconds;
+    }
+};
+
+/**
+ * @brief 在 connNum 个保活连接上压测: 每个连接一次发出 depth 个请求 (流水线), 全部收到后再发下一批
+ * @note 每一批记一个延迟样本 (depth 为 1 时即单个请求的延迟)
+ * @param port
+ * @param request 一个完整的请求
+ * @param connNum 连接数 (每个连接一个线程)
+ * @param duration 压测时间
+ * @param depth 流水线深度
+ * @return LoadResult
+ */
+inline LoadResult runHttpLoad(
+    uint16_t port,
+    std::string_view request,
+    std::size_t connNum,
+    std::chrono::milliseconds duration,
+    std::size_t depth = 1
+) {
+    std::string batch;
+    for (std::size_t i = 0; i < depth; ++i) {
+        batch += request;
+    }
+    std::atomic_uint64_t total{0};
+    std::vector<LatencyRecorder> latencies(connNum);
+    auto begin = Clock::now();
+    auto deadline = begin + duration;
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t i = 0; i < connNum; ++i) {
+            threads.emplace_back([&, i] {
+                int fd = connectTo(port);
+                ResponseCounter counter;
+                char buf[1 << 16];
+                uint64_t done = 0;
+                while (Clock::now() < deadline) {
+                    auto t0 = Clock::now();
+                    if (::send(fd, batch.data(), batch.size(), MSG_NOSIGNAL)
+                        != static_cast<ssize_t>(batch.size())) [[unlikely]] {
+                        break;
+                    }
+                    std::size_t got = 0;
+                    while (got < depth) {
+                        auto n = ::recv(fd, buf, sizeof(buf), 0);
+                        if (n <= 0) [[unlikely]] {
+                            break;
+                        }
+                        got += counter.feed({buf, static_cast<std::size_t>(n)});
+                    }
+                    if (got < depth) [[unlikely]] {
+                        break;
+                    }
+                    latencies[i].add(Clock::now() - t0);
+                    done += depth;
+                }
+                ::close(fd);
+                total += done;
+            });
+        }
+    }
+    LoadResult res{total.load(), std::chrono::duration<double>(Clock::now() - begin).count(), {}};
+    for (auto const& lat : latencies) {
+        res.latency.merge(lat);
+    }
+    return res;
+}
+
+} // namespace HX::bench
@@ -0,0 +1,64 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 21:06:33
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <new>
+#include <cstdint>
+#include <cstdlib>
+
+/**
+ * @brief 替换全局 operator new / delete, 统计每个线程调用 operator new 的次数
+ * @warning 替换是全局的 (不能 inline), 因此只能被一个可执行文件中的一个翻译单元包含;
+ *          每个压测都是单独的可执行文件, 在其 .cpp 中包含即可
+ */
+
+namespace HX::bench {
+
+namespace internal {
+
+inline thread_local uint64_t tNewNum = 0;
+
+} // namespace internal
+
+/**
+ * @brief 当前线程到目前为止调用 operator new 的次数
+ * @return uint64_t
+ */
+inline uint64_t newNum() noexcept {
+    return internal::tNewNum;
+}
+
+} // namespace HX::bench
+
+// 不内联: 否则 gcc 会把内联后的 free 误报为与 new 不匹配 (-Wmismatched-new-delete)
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    ++HX::bench::internal::tNewNum;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
@@ -0,0 +1,115 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 21:36:08
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include <HXLibs/net/Api.hpp>
+
+namespace HX::bench {
+
+/**
+ * @brief 本线程已经使用的 CPU 时间
+ * @return uint64_t 纳秒
+ */
+inline uint64_t threadCpuNs() noexcept {
+    ::timespec ts{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * @brief 请求解析压测的结果
+ */
+struct ParseResult {
+    uint64_t requests;  // 成功解析的请求数
+    double cpuNs;       // 解析线程每个请求的 CPU 时间 (纳秒)
+    double allocNum;    // 解析线程每个请求的内存分配次数
+};
+
+/**
+ * @brief 通过公开的接口 (Request::parserReq / clear) 解析流水线中的请求
+ * @note 写入端在另一个线程中不停地把 corpus 写入 Unix 套接字, 只统计解析线程的 CPU 时间
+ *       (其中包括摊销到每个请求上的 recv); 请求都没有请求体
+ * @param corpus 完整的请求, 轮流发送
+ * @param rounds 发送 corpus 的轮数
+ * @param allocNum 返回本线程累计的内存分配次数, 形如 uint64_t()
+ * @return ParseResult
+ */
+template <typename AllocNum>
+ParseResult runParseLoad(std::vector<std::string> const& corpus, std::size_t rounds, AllocNum allocNum) {
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) [[unlikely]] {
+        throw std::runtime_error{"socketpair failed"};
+    }
+    std::jthread writer{[&corpus, rounds, fd = fds[1]] {
+        // 多轮拼成一次写入, 减少写入端的系统调用
+        constexpr std::size_t kRoundsPerSend = 64;
+        std::string blob;
+        for (std::size_t i = 0; i < kRoundsPerSend; ++i) {
+            for (auto const& req : corpus) {
+                blob += req;
+            }
+        }
+        for (std::size_t sent = 0; sent < rounds; sent += kRoundsPerSend) {
+            auto n = std::min(kRoundsPerSend, rounds - sent);
+            std::string_view data{blob.data(), blob.size() / kRoundsPerSend * n};
+            while (!data.empty()) {
+                auto res = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+                if (res <= 0) [[unlikely]] {
+                    break;
+                }
+                data.remove_prefix(static_cast<std::size_t>(res));
+            }
+        }
+        ::shutdown(fd, SHUT_WR);
+    }};
+    ParseResult res{};
+    coroutine::EventLoop loop;
+    loop.sync([&]() -> coroutine::Task<> {
+        net::IO io{fds[0], loop};
+        net::Request req{io};
+        uint64_t num = 0;
+        auto cpu = threadCpuNs();
+        auto allocs = allocNum();
+        while (co_await req.parserReq<decltype(utils::operator""_s<"5">())>()) {
+            ++num;
+            co_await req.clear();
+        }
+        auto n = static_cast<double>(num ? num : 1);
+        res = {num,
+               static_cast<double>(threadCpuNs() - cpu) / n,
+               static_cast<double>(allocNum() - allocs) / n};
+        co_await io.close();
+    }());
+    writer.join();
+    ::close(fds[1]);
+    return res;
+}
+
+} // namespace HX::bench
@@ -0,0 +1,227 @@
+#pragma once
+/*
+ * Copyright Heng_Xin. All rights reserved.
+ *
+ * @Author: Heng_Xin
+ * @Date: 2026-10-17 17:05:12
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cctype>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+namespace HX::test {
+
+/**
+ * @brief 阻塞的原始 TCP 客户端, 用于向服务器发送任意 (包括非法的) 请求字节
+ */
+class RawHttpClient {
+public:
+    /**
+     * @brief 连接到 127.0.0.1:port
+     * @param port
+     * @param timeout 每次接收的超时时间, 超时视为对端不再发送
+     */
+    explicit RawHttpClient(uint16_t port, std::chrono::milliseconds timeout = std::chrono::milliseconds{1000})
+        : _fd{::socket(AF_INET, SOCK_STREAM, 0)}
+    {
+        if (_fd < 0) [[unlikely]] {
+            throw std::runtime_error{"socket failed"};
+        }
+        ::timeval tv{
+            static_cast<decltype(tv.tv_sec)>(timeout.count() / 1000),
+            static_cast<decltype(tv.tv_usec)>(timeout.count() % 1000 * 1000)
+        };
+        ::setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        ::sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::connect(_fd, reinterpret_cast<::sockaddr*>(&addr), sizeof(addr)) < 0) {
+            ::close(_fd);
+            throw std::runtime_error{"connect failed"};
+        }
+    }
+
+    RawHttpClient& operator=(RawHttpClient&&) noexcept = delete;
+
+    ~RawHttpClient() noexcept {
+        ::close(_fd);
+    }
+
+    /**
+     * @brief 发送全部数据
+     * @param data
+     */
+    void send(std::string_view data) {
+        while (!data.empty()) {
+            auto n = ::send(_fd, data.data(), data.size(), MSG_NOSIGNAL);
+            if (n <= 0) [[unlikely]] {
+                throw std::runtime_error{"send failed"};
+            }
+            data.remove_prefix(static_cast<std::size_t>(n));
+        }
+    }
+
+    /**
+     * @brief 一直接收, 直到对端关闭或者超时
+     * @return std::string 收到的全部数据
+     */
+    std::string recvAll() {
+        std::string res;
+        char buf[1 << 16];
+        for (;;) {
+            auto n = ::recv(_fd, buf, sizeof(buf), 0);
+            if (n <= 0) {
+                // 服务器在还有未读数据时关闭, 对端收到的是 RST
+                _isClosed = n == 0 || errno == ECONNRESET;
+                break;
+            }
+            res.append(buf, static_cast<std::size_t>(n));
+        }
+        return res;
+    }
+
+    /**
+     * @brief 接收一次
+     * @return std::string 对端关闭或者超时时为空
+     */
+    std::string recvSome() {
+        char buf[1 << 16];
+        auto n = ::recv(_fd, buf, sizeof(buf), 0);
+        return n > 0 ? std::string(buf, static_cast<std::size_t>(n)) : std::string{};
+    }
+
+    /**
+     * @brief 上一次 recvAll() 是否因为对端关闭 (或者重置) 而结束, 而不是超时
+     */
+    bool isClosed() const noexcept {
+        return _isClosed;
+    }
+private:
+    int _fd;
+    bool _isClosed = false;
+};
+
+/**
+ * @brief 发送一次请求 (可以是多个请求拼在一起), 返回收到的全部数据
+ * @param port
+ * @param raw
+ * @return std::string
+ */
+inline std::string request(uint16_t port, std::string_view raw) {
+    RawHttpClient cli{port};
+    cli.send(raw);
+    return cli.recvAll();
+}
+
+/**
+ * @brief 等待服务器开始监听
+ * @param port
+ */
+inline void waitForServer(uint16_t port) {
+    for (int i = 0; i < 500; ++i) {
+        try {
+            RawHttpClient cli{port};
+            return;
+        } catch (...) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+    }
+    throw std::runtime_error{"server is not listening"};
+}
+
+/**
+ * @brief 拆分后的一个响应
+ */
+struct RawResponse {
+    int status;
+    std::unordered_map<std::string, std::string> headers; // 键为小写
+    std::string body;
+};
+
+/**
+ * @brief 把收到的数据按顺序拆分为响应 (支持 Content-Length 与 chunked)
+ * @param data
+ * @return std::vector<RawResponse> 无法解析的剩余部分会被丢弃
+ */
+inline std::vector<RawResponse> splitResponses(std::string_view data) {
+    std::vector<RawResponse> res;
+    while (!data.empty()) {
+        auto headEnd = data.find("\r\n\r\n");
+        if (headEnd == std::string_view::npos || data.size() < 12) {
+            break;
+        }
+        RawResponse r{std::stoi(std::string{data.substr(9, 3)}), {}, {}};
+        auto head = data.substr(0, headEnd);
+        for (auto pos = head.find("\r\n"); pos != std::string_view::npos; ) {
+            auto next = head.find("\r\n", pos + 2);
+            auto line = head.substr(pos + 2, next == std::string_view::npos
+                ? std::string_view::npos : next - pos - 2);
+            if (auto colon = line.find(':'); colon != std::string_view::npos) {
+                std::string key{line.substr(0, colon)};
+                for (auto& c : key) {
+                    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                }
+                auto val = line.substr(colon + 1);
+                while (!val.empty() && val.front() == ' ') {
+                    val.remove_prefix(1);
+                }
+                r.headers[std::move(key)] = std::string{val};
+            }
+            pos = next;
+        }
+        data.remove_prefix(headEnd + 4);
+        if (auto it = r.headers.find("content-length"); it != r.headers.end()) {
+            auto n = std::min(std::stoul(it->second), data.size());
+            r.body = data.substr(0, n);
+            data.remove_prefix(n);
+        } else if (r.headers.count("transfer-encoding")) {
+            for (;;) {
+                auto lineEnd = data.find("\r\n");
+                if (lineEnd == std::string_view::npos) {
+                    data = {};
+                    break;
+                }
+                auto n = std::stoul(std::string{data.substr(0, lineEnd)}, nullptr, 16);
+                data.remove_prefix(lineEnd + 2);
+                if (!n) {
+                    data.remove_prefix(std::min<std::size_t>(2, data.size()));
+                    break;
+                }
+                r.body += data.substr(0, n);
+                data.remove_prefix(std::min(n + 2, data.size()));
+            }
+        }
+        res.push_back(std::move(r));
+    }
+    return res;
+}
+
+} // namespace HX::test
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include <HXLibs/net/Api.hpp>
+
+#include <RawHttpClient.hpp>
+
+using namespace HX;
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace {
+
+constexpr uint16_t kPort = 28301;
+
+class HttpParserTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        _ser = std::make_unique<net::HttpServer>("127.0.0.1", std::to_string(kPort));
+        _ser->addEndpoint<net::GET>("/", [] ENDPOINT {
+            co_await res.setStatusAndContent(net::Status::CODE_200, "hello").sendRes();
+        });
+        _ser->addEndpoint<net::POST>("/echo", [] ENDPOINT {
+            auto body = co_await req.parseBody();
+            co_await res.setStatusAndContent(net::Status::CODE_200, body).sendRes();
+        });
+        _ser->addEndpoint<net::GET>("/hdr/**", [] ENDPOINT {
+            auto const& headers = req.getHeadersView();
+            std::string out;
+            for (auto key : {"x-fold", "host"}) {
+                auto it = headers.find(key);
+                out += it == headers.end() ? std::string{"<none>"} : std::string{it->second};
+                out += "|";
+            }
+            auto query = req.getParseQueryParametersView();
+            out += std::string{query["a"]} + "|" + std::string{req.getPureReqPathView()};
+            co_await res.setStatusAndContent(net::Status::CODE_200, out).sendRes();
+        });
+        // 默认的访问器返回拥有所有权的副本: 保存到下一个请求时仍然有效
+        _ser->addEndpoint<net::GET>("/keep/**", [] ENDPOINT {
+            static net::HeaderHashMap kept;
+            static std::string keptPath;
+            static std::unordered_map<std::string, std::string> keptQuery;
+            std::string out = keptPath + "|" + keptQuery["a"] + "|"
+                + (kept.count("host") ? kept.at("host") : std::string{"<none>"});
+            kept = req.getHeaders();
+            keptPath = req.getPureReqPath();
+            keptQuery = req.getParseQueryParameters();
+            EXPECT_EQ(req.getHeaders().at("x-a"), req.getHeadersView().at("X-A"));
+            EXPECT_EQ(req.getHeadersView().count("x-a"), 1u);
+            EXPECT_THROW((void)req.getHeadersView().at("x-none"), std::out_of_range);
+            co_await res.setStatusAndContent(net::Status::CODE_200, out).sendRes();
+        });
+        _ser->asyncRun(1);
+        test::waitForServer(kPort);
+    }
+
+    static void TearDownTestSuite() {
+        _ser.reset();
+    }
+
+    /**
+     * @brief 发送请求, 期望服务器以 status 回应并关闭连接
+     */
+    static void expectRejected(std::string_view raw, std::string_view status) {
+        test::RawHttpClient cli{kPort};
+        cli.send(raw);
+        auto out = cli.recvAll();
+        EXPECT_TRUE(out.starts_with("HTTP/1.1 "s + std::string{status})) << raw.substr(0, 80);
+        EXPECT_NE(out.find("Connection: close"), std::string::npos) << raw.substr(0, 80);
+        EXPECT_TRUE(cli.isClosed()) << raw.substr(0, 80);
+    }
+
+    inline static std::unique_ptr<net::HttpServer> _ser{};
+};
+
+constexpr auto kPost = "POST /echo HTTP/1.1\r\nHost: x\r\n"sv;
+
+TEST_F(HttpParserTest, ContentLengthBody) {
+    auto res = test::splitResponses(test::request(kPort,
+        "POST /echo HTTP/1.1\r\nContent-Length: 5\r\nConnection: close\r\n\r\nhello"));
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].status, 200);
+    EXPECT_EQ(res[0].body, "hello");
+}
+
+TEST_F(HttpParserTest, ChunkedBodyWithExtensions) {
+    auto res = test::splitResponses(test::request(kPort, std::string{kPost}
+        + "Transfer-Encoding: chunked\r\nConnection: close\r\n\r\n"
+          "5;name=val\r\nhello\r\n5 ;x\r\nworld\r\n0\r\n\r\n"));
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].status, 200);
+    EXPECT_EQ(res[0].body, "helloworld");
+}
+
+TEST_F(HttpParserTest, ChunkedIsCaseInsensitive) {
+    auto res = test::splitResponses(test::request(kPort, std::string{kPost}
+        + "Transfer-Encoding: CHUNKED\r\nConnection: close\r\n\r\n5\r\nhello\r\n0\r\n\r\n"));
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].body, "hello");
+}
+
+TEST_F(HttpParserTest, ChunkedTrailersAreSkipped) {
+    auto res = test::splitResponses(test::request(kPort, std::string{kPost}
+        + "Transfer-Encoding: chunked\r\nConnection: close\r\n\r\n"
+          "3\r\nabc\r\n0\r\nX-Trailer: 1\r\n\r\n"));
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].body, "abc");
+}
+
+TEST_F(HttpParserTest, ChunkedBodySplitAcrossReads) {
+    test::RawHttpClient cli{kPort};
+    auto raw = std::string{kPost}
+        + "Transfer-Encoding: chunked\r\nConnection: close\r\n\r\n"
+          "a\r\n0123456789\r\n3\r\nabc\r\n0\r\n\r\n";
+    // 在块大小、块数据与结尾的 CRLF 中间截断
+    for (std::size_t i = 0; i < raw.size(); i += 7) {
+        cli.send(std::string_view{raw}.substr(i, 7));
+        std::this_thread::sleep_for(std::chrono::milliseconds{2});
+    }
+    auto res = test::splitResponses(cli.recvAll());
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].body, "0123456789abc");
+}
+
+TEST_F(HttpParserTest, HeadersByteByByte) {
+    auto raw = "GET /hdr/x?a=1 HTTP/1.1\r\nHost: h\r\nX-Fold: v\r\nConnection: close\r\n\r\n"sv;
+    test::RawHttpClient cli{kPort};
+    for (char c : raw) {
+        cli.send({&c, 1});
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    auto res = test::splitResponses(cli.recvAll());
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].body, "v|h|1|/hdr/x");
+}
+
+TEST_F(HttpParserTest, OwningAccessorsOutliveTheRequest) {
+    // 同一个连接上的两个请求: 第二个请求覆盖了接收缓冲区, 第一个请求保存的副本不受影响
+    auto res = test::splitResponses(test::request(kPort,
+        "GET /keep/first?a=1 HTTP/1.1\r\nHost: one\r\nX-A: 1\r\n\r\n"
+        "GET /keep/second?a=2 HTTP/1.1\r\nHost: two\r\nX-A: 2\r\nConnection: close\r\n\r\n"));
+    ASSERT_EQ(res.size(), 2u);
+    EXPECT_EQ(res[0].body, "||<none>");
+    EXPECT_EQ(res[1].body, "/keep/first|1|one");
+}
+
+TEST_F(HttpParserTest, ManyHeadersGrowPastTheInlineStorage) {
+    std::string raw = "GET /hdr/z HTTP/1.1\r\n";
+    for (int i = 0; i < 40; ++i) {
+        raw += "X-H" + std::to_string(i) + ": " + std::to_string(i) + "\r\n";
+    }
+    raw += "X-Fold: last\r\nHost: h\r\nConnection: close\r\n\r\n";
+    auto res = test::splitResponses(test::request(kPort, raw));
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].body, "last|h||/hdr/z");
+}
+
+TEST_F(HttpParserTest, LeadingEmptyLineIsIgnored) {
+    auto res = test::splitResponses(test::request(kPort,
+        "\r\nGET /hdr/y HTTP/1.1\r\nHost: h\r\nConnection: close\r\n\r\n"));
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].body, "<none>|h||/hdr/y");
+}
+
+TEST_F(HttpParserTest, RejectsBadContentLength) {
+    auto post = std::string{kPost};
+    expectRejected(post + "Content-Length: +5\r\n\r\nhello", "400");
+    expectRejected(post + "Content-Length: 5, 5\r\n\r\nhello", "400");
+    expectRejected(post + "Content-Length: 5\r\nContent-Length: 5\r\n\r\nhello", "400");
+    expectRejected(post + "Content-Length: 5\r\nContent-Length: 6\r\n\r\nhello!", "400");
+    expectRejected(post + "Content-Length: 99999999999999999999999\r\n\r\n", "400");
+    expectRejected(post + "Content-Length: 0x5\r\n\r\nhello", "400");
+}
+
+TEST_F(HttpParserTest, RejectsBadTransferEncoding) {
+    auto post = std::string{kPost};
+    expectRejected(post + "Transfer-Encoding: chunked\r\nContent-Length: 5\r\n\r\n"
+                          "5\r\nhello\r\n0\r\n\r\n", "400");
+    expectRejected(post + "Transfer-Encoding: chunked, gzip\r\n\r\n", "400");
+    expectRejected(post + "Transfer-Encoding: identity\r\n\r\n", "400");
+}
+
+TEST_F(HttpParserTest, RejectsBadChunks) {
+    auto post = std::string{kPost} + "Transfer-Encoding: chunked\r\n\r\n";
+    expectRejected(post + "0x5\r\nhello\r\n0\r\n\r\n", "400");
+    expectRejected(post + "FFFFFFFFFFFFFFFFFF\r\nhello\r\n0\r\n\r\n", "400");
+    expectRejected(post + "5\r\nhelloXX0\r\n\r\n", "400");
+    expectRejected(post + "5;" + std::string(3000, 'a'), "400");
+}
+
+TEST_F(HttpParserTest, RejectsBadRequestHead) {
+    expectRejected("GET\r\n\r\n", "400");
+    expectRejected("G(T / HTTP/1.1\r\n\r\n", "400");
+    expectRejected("GET / HTTX/1.1\r\n\r\n", "400");
+    expectRejected("GET /a\x01" "b HTTP/1.1\r\n\r\n", "400");
+    expectRejected("GET / HTTP/1.1\r\nHost : h\r\n\r\n", "400");
+    expectRejected("GET / HTTP/1.1\r\nBa d: x\r\n\r\n", "400");
+    expectRejected("GET / HTTP/1.1\r\nHost: h\nX: y\r\n\r\n", "400");
+}
+
+TEST_F(HttpParserTest, RejectsBareCrRegardlessOfLength) {
+    // 短的请求头使用标量实现, 长的 (>= 256 字节) 使用 SIMD 实现 (CPU 支持时), 结果应该一致
+    auto const shortHead = "GET / HTTP/1.1\r\nX: a\rb\r\n\r\n"s;
+    auto const longHead = "GET / HTTP/1.1\r\nX-Pad: "s + std::string(300, 'p') + "\r\nX: a\rb\r\n\r\n";
+    ASSERT_LT(shortHead.size(), 256u);
+    ASSERT_GE(longHead.size(), 256u);
+    expectRejected(shortHead, "400");
+    expectRejected(longHead, "400");
+    expectRejected("GET /\ra HTTP/1.1\r\n\r\n", "400");
+}
+
+TEST_F(HttpParserTest, RejectsOversizedHead) {
+    expectRejected("GET /" + std::string(20000, 'a') + " HTTP/1.1\r\n\r\n", "414");
+    expectRejected("GET / HTTP/1.1\r\nX: " + std::string(20000, 'a') + "\r\n\r\n", "431");
+}
+
+} // namespace
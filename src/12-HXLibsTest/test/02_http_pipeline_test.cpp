@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include <HXLibs/net/Api.hpp>
+
+#include <RawHttpClient.hpp>
+
+using namespace HX;
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace {
+
+// 注册文件表版本 (*_fixed_file) 与普通版本可能被 ctest 并行运行, 使用不同的端口
+constexpr uint16_t kPort = platform::kUseFixedFile ? 28402 : 28302;
+
+constexpr auto kGet = "GET / HTTP/1.1\r\nHost: x\r\n\r\n"sv;
+
+std::atomic_bool gIsSlowReleased{false};
+
+class HttpPipelineTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        _ser = std::make_unique<net::HttpServer>("127.0.0.1", std::to_string(kPort));
+        _ser->addEndpoint<net::GET>("/", [] ENDPOINT {
+            co_await res.setStatusAndContent(net::Status::CODE_200, "hello").sendRes();
+        });
+        _ser->addEndpoint<net::POST>("/echo", [] ENDPOINT {
+            auto body = co_await req.parseBody();
+            co_await res.setStatusAndContent(net::Status::CODE_200, body).sendRes();
+        });
+        _ser->addEndpoint<net::GET>("/slow", [] ENDPOINT {
+            // 等到客户端收到前面的响应才完成 (最多等 5s, 以免测试挂起)
+            for (int i = 0; i < 1000 && !gIsSlowReleased; ++i) {
+                co_await coroutine::EventLoop::current()->makeTimer().sleepFor(
+                    std::chrono::milliseconds{5});
+            }
+            co_await res.setStatusAndContent(net::Status::CODE_200, "slow").sendRes();
+        });
+        _ser->addEndpoint<net::GET>("/stream", [] ENDPOINT {
+            auto gen = []() -> coroutine::AsyncGenerator<std::span<char const>> {
+                std::string line;
+                for (int i = 0; i < 1000; ++i) {
+                    line = std::to_string(i) + "\n";
+                    co_yield line;
+                }
+            };
+            co_await res.setResLine(net::Status::CODE_200)
+                        .setContentType(net::TEXT)
+                        .sendStream(gen());
+        });
+        _ser->asyncRun(1);
+        test::waitForServer(kPort);
+    }
+
+    static void TearDownTestSuite() {
+        _ser.reset();
+    }
+
+    static std::string repeat(std::string_view str, std::size_t n) {
+        std::string res;
+        for (std::size_t i = 0; i < n; ++i) {
+            res += str;
+        }
+        return res;
+    }
+
+    static std::vector<std::string> bodies(std::string_view data) {
+        std::vector<std::string> res;
+        for (auto& r : test::splitResponses(data)) {
+            res.push_back(std::move(r.body));
+        }
+        return res;
+    }
+
+    inline static std::unique_ptr<net::HttpServer> _ser{};
+};
+
+TEST_F(HttpPipelineTest, AnswersInOrder) {
+    auto out = test::request(kPort, repeat(kGet, 3));
+    EXPECT_EQ(bodies(out), std::vector<std::string>(3, "hello"));
+}
+
+TEST_F(HttpPipelineTest, ManyRequestsInOneSend) {
+    auto out = test::request(kPort, repeat(kGet, 200));
+    EXPECT_EQ(bodies(out), std::vector<std::string>(200, "hello"));
+}
+
+TEST_F(HttpPipelineTest, BodiesAreNotMistakenForRequests) {
+    auto out = test::request(kPort,
+        "POST /echo HTTP/1.1\r\nContent-Length: 5\r\n\r\nabcde"s + std::string{kGet}
+        + "POST /echo HTTP/1.1\r\nContent-Length: 3\r\n\r\nxyz" + std::string{kGet});
+    EXPECT_EQ(bodies(out), (std::vector<std::string>{"abcde", "hello", "xyz", "hello"}));
+}
+
+TEST_F(HttpPipelineTest, ChunkedBodyFollowedByRequest) {
+    auto out = test::request(kPort,
+        "POST /echo HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "3\r\nabc\r\n2\r\nde\r\n0\r\n\r\n"s + std::string{kGet});
+    EXPECT_EQ(bodies(out), (std::vector<std::string>{"abcde", "hello"}));
+}
+
+TEST_F(HttpPipelineTest, StopsAfterConnectionClose) {
+    test::RawHttpClient cli{kPort};
+    cli.send(std::string{kGet} + "GET / HTTP/1.1\r\nConnection: close\r\n\r\n" + std::string{kGet});
+    auto out = cli.recvAll();
+    EXPECT_EQ(bodies(out), std::vector<std::string>(2, "hello"));
+    EXPECT_TRUE(cli.isClosed());
+}
+
+TEST_F(HttpPipelineTest, RequestSplitAcrossReads) {
+    test::RawHttpClient cli{kPort};
+    cli.send(std::string{kGet} + std::string{kGet.substr(0, 10)});
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    cli.send(std::string{kGet.substr(10)} + std::string{kGet});
+    EXPECT_EQ(bodies(cli.recvAll()), std::vector<std::string>(3, "hello"));
+}
+
+TEST_F(HttpPipelineTest, StreamedResponseInTheMiddle) {
+    auto out = test::request(kPort,
+        repeat(kGet, 2) + "GET /stream HTTP/1.1\r\n\r\n" + std::string{kGet});
+    auto res = bodies(out);
+    ASSERT_EQ(res.size(), 4u);
+    EXPECT_EQ(res[0], "hello");
+    EXPECT_EQ(res[1], "hello");
+    EXPECT_TRUE(res[2].starts_with("0\n1\n2\n"));
+    EXPECT_TRUE(res[2].ends_with("998\n999\n"));
+    EXPECT_EQ(res[3], "hello");
+}
+
+TEST_F(HttpPipelineTest, BadRequestAfterGoodOne) {
+    test::RawHttpClient cli{kPort};
+    cli.send(std::string{kGet} + "BAD\r\n\r\n");
+    auto out = cli.recvAll();
+    auto res = test::splitResponses(out);
+    ASSERT_EQ(res.size(), 2u);
+    EXPECT_EQ(res[0].body, "hello");
+    EXPECT_EQ(res[1].status, 400);
+    EXPECT_TRUE(cli.isClosed());
+}
+
+TEST_F(HttpPipelineTest, ReadyResponseIsNotHeldBehindSlowHandler) {
+    gIsSlowReleased = false;
+    test::RawHttpClient cli{kPort, std::chrono::milliseconds{2000}};
+    cli.send(std::string{kGet} + "GET /slow HTTP/1.1\r\nHost: x\r\n\r\n" + std::string{kGet});
+    // 慢请求在客户端收到第一个响应之前不会完成: 如果第一个响应被压在慢请求后面, 这里会超时
+    std::string out;
+    while (test::splitResponses(out).empty()) {
+        auto data = cli.recvSome();
+        ASSERT_FALSE(data.empty()) << "the first response was held behind the slow handler";
+        out += data;
+    }
+    EXPECT_EQ(bodies(out), (std::vector<std::string>{"hello"}));
+    gIsSlowReleased = true;
+    while (test::splitResponses(out).size() < 3) {
+        auto data = cli.recvSome();
+        ASSERT_FALSE(data.empty());
+        out += data;
+    }
+    EXPECT_EQ(bodies(out), (std::vector<std::string>{"hello", "slow", "hello"}));
+}
+
+} // namespace
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include <HXLibs/net/Api.hpp>
+
+#include <RawHttpClient.hpp>
+
+using namespace HX;
+using namespace std::string_literals;
+
+namespace {
+
+// 注册文件表版本 (*_fixed_file) 与普通版本可能被 ctest 并行运行, 使用不同的端口
+constexpr uint16_t kPort = platform::kUseFixedFile ? 28403 : 28303;
+
+constexpr std::size_t kFileSize = 300'123;
+
+class HttpRangeTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        auto dir = std::filesystem::temp_directory_path();
+        _filePath = (dir / "hx_range_test.bin").string();
+        _shortPath = (dir / "hx_range_test_short.bin").string();
+        _data.resize(kFileSize);
+        std::mt19937 rng{42};
+        for (auto& c : _data) {
+            c = static_cast<char>(rng());
+        }
+        writeFile(_filePath, _data);
+        writeFile(_shortPath, _data);
+
+        _ser = std::make_unique<net::HttpServer>("127.0.0.1", std::to_string(kPort));
+        _ser->addEndpoint<net::GET, net::HEAD>("/file", [] ENDPOINT {
+            co_await res.useRangeTransferFile(req.getRangeRequestView(), _filePath);
+        });
+        _ser->addEndpoint<net::GET>("/short", [] ENDPOINT {
+            co_await res.useRangeTransferFile(req.getRangeRequestView(), _shortPath);
+        });
+        _ser->addEndpoint<net::GET>("/chunk", [] ENDPOINT {
+            co_await res.useChunkedEncodingTransferFile(_filePath);
+        });
+        _ser->asyncRun(1);
+        test::waitForServer(kPort);
+    }
+
+    static void TearDownTestSuite() {
+        _ser.reset();
+        std::filesystem::remove(_filePath);
+        std::filesystem::remove(_shortPath);
+    }
+
+    static void writeFile(std::string const& path, std::string_view data) {
+        std::ofstream out{path, std::ios::binary | std::ios::trunc};
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    static std::vector<test::RawResponse> get(std::string_view path, std::string_view range = {}) {
+        auto raw = "GET "s + std::string{path} + " HTTP/1.1\r\nConnection: close\r\n";
+        if (!range.empty()) {
+            raw += "Range: " + std::string{range} + "\r\n";
+        }
+        return test::splitResponses(test::request(kPort, raw + "\r\n"));
+    }
+
+    inline static std::string _filePath{};
+    inline static std::string _shortPath{};
+    inline static std::string _data{};
+    inline static std::unique_ptr<net::HttpServer> _ser{};
+};
+
+TEST_F(HttpRangeTest, WholeFile) {
+    auto res = get("/file");
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].status, 200);
+    EXPECT_EQ(res[0].headers["content-length"], std::to_string(kFileSize));
+    EXPECT_FALSE(res[0].headers["etag"].empty());
+    EXPECT_TRUE(res[0].body == _data);
+}
+
+TEST_F(HttpRangeTest, ChunkedFile) {
+    auto res = get("/chunk");
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].status, 200);
+    EXPECT_TRUE(res[0].body == _data);
+}
+
+TEST_F(HttpRangeTest, HeadHasLengthButNoBody) {
+    auto out = test::request(kPort, "HEAD /file HTTP/1.1\r\nConnection: close\r\n\r\n");
+    EXPECT_TRUE(out.starts_with("HTTP/1.1 200"));
+    EXPECT_NE(out.find("Content-Length: " + std::to_string(kFileSize)), std::string::npos);
+    EXPECT_TRUE(out.ends_with("\r\n\r\n"));
+}
+
+TEST_F(HttpRangeTest, SingleRange) {
+    auto res = get("/file", "bytes=100-199");
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].status, 206);
+    EXPECT_EQ(res[0].headers["content-range"], "bytes 100-199/" + std::to_string(kFileSize));
+    EXPECT_TRUE(res[0].body == _data.substr(100, 100));
+}
+
+TEST_F(HttpRangeTest, OpenEndedAndSuffixRanges) {
+    auto tail = get("/file", "bytes=300000-");
+    ASSERT_EQ(tail.size(), 1u);
+    EXPECT_EQ(tail[0].status, 206);
+    EXPECT_TRUE(tail[0].body == _data.substr(300000));
+
+    auto suffix = get("/file", "bytes=-50");
+    ASSERT_EQ(suffix.size(), 1u);
+    EXPECT_EQ(suffix[0].status, 206);
+    EXPECT_TRUE(suffix[0].body == _data.substr(kFileSize - 50));
+
+    // 超出文件的后缀长度: 整个文件
+    auto all = get("/file", "bytes=-999999999");
+    ASSERT_EQ(all.size(), 1u);
+    EXPECT_TRUE(all[0].body == _data);
+}
+
+TEST_F(HttpRangeTest, LastPositionIsClampedToFileSize) {
+    auto res = get("/file", "bytes=300100-999999999");
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].status, 206);
+    EXPECT_EQ(res[0].headers["content-range"],
+        "bytes 300100-" + std::to_string(kFileSize - 1) + "/" + std::to_string(kFileSize));
+    EXPECT_TRUE(res[0].body == _data.substr(300100));
+}
+
+TEST_F(HttpRangeTest, UnsatisfiableRanges) {
+    for (auto range : {"bytes=300123-", "bytes=5-1", "bytes=abc", "bytes=-0", "bytes=1-2x", "bytes=+1-2"}) {
+        auto res = get("/file", range);
+        ASSERT_EQ(res.size(), 1u) << range;
+        EXPECT_EQ(res[0].status, 416) << range;
+        EXPECT_EQ(res[0].headers["content-range"], "bytes */" + std::to_string(kFileSize)) << range;
+        EXPECT_EQ(res[0].headers["content-length"], "0") << range;
+    }
+}
+
+TEST_F(HttpRangeTest, UnknownUnitIsIgnored) {
+    auto res = get("/file", "items=0-9");
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].status, 200);
+    EXPECT_EQ(res[0].body.size(), kFileSize);
+}
+
+TEST_F(HttpRangeTest, MultipleRangesAreSelfDelimiting) {
+    // 保活连接上的第二个请求能被正确读到, 说明多段响应的长度是正确的
+    auto out = test::request(kPort,
+        "GET /file HTTP/1.1\r\nRange: bytes=0-9, 20-29, 999999999-\r\n\r\n"
+        "GET /file HTTP/1.1\r\nRange: bytes=0-0\r\nConnection: close\r\n\r\n");
+    auto res = test::splitResponses(out);
+    ASSERT_EQ(res.size(), 2u);
+    EXPECT_EQ(res[0].status, 206);
+    EXPECT_TRUE(res[0].headers["content-type"].starts_with("multipart/byteranges"));
+    auto const& body = res[0].body;
+    EXPECT_NE(body.find("Content-Range: bytes 0-9/"), std::string::npos);
+    EXPECT_NE(body.find("Content-Range: bytes 20-29/"), std::string::npos);
+    EXPECT_NE(body.find(_data.substr(0, 10)), std::string::npos);
+    EXPECT_NE(body.find(_data.substr(20, 10)), std::string::npos);
+    EXPECT_TRUE(body.ends_with("--BOUNDARY_STRING--\r\n"));
+    EXPECT_EQ(res[1].status, 206);
+    EXPECT_TRUE(res[1].body == _data.substr(0, 1));
+}
+
+TEST_F(HttpRangeTest, FileTruncatedAfterItWasCached) {
+    auto before = get("/short");
+    ASSERT_EQ(before.size(), 1u);
+    EXPECT_EQ(before[0].body.size(), kFileSize);
+
+    std::filesystem::resize_file(_shortPath, 1000);
+
+    // 不能按缓存中的旧大小发送 (否则保活的客户端会一直等待剩余的数据)
+    test::RawHttpClient cli{kPort};
+    cli.send("GET /short HTTP/1.1\r\n\r\n"
+             "GET /short HTTP/1.1\r\nRange: bytes=0-99999\r\nConnection: close\r\n\r\n");
+    auto res = test::splitResponses(cli.recvAll());
+    ASSERT_EQ(res.size(), 2u);
+    EXPECT_EQ(res[0].status, 200);
+    EXPECT_TRUE(res[0].body == _data.substr(0, 1000));
+    EXPECT_EQ(res[1].status, 206);
+    EXPECT_EQ(res[1].headers["content-range"], "bytes 0-999/1000");
+    EXPECT_TRUE(res[1].body == _data.substr(0, 1000));
+    EXPECT_TRUE(cli.isClosed());
+}
+
+} // namespace
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <HXLibs/net/router/RouterTree.hpp>
+
+using namespace HX;
+using namespace HX::net;
+
+namespace {
+
+/**
+ * @brief 带编号的端点, 用于判断 find() 找到的是哪一个
+ */
+struct Tagged {
+    int id;
+
+    coroutine::Task<> operator()(Request&, Response&) const {
+        co_return;
+    }
+};
+
+class RouterTreeTest : public ::testing::Test {
+protected:
+    void add(std::string_view method, std::string_view path, int id) {
+        _tree.insert(method, path, Tagged{id});
+    }
+
+    /**
+     * @brief 查找路由
+     * @return int 端点编号, 找不到 (404) 为 -1
+     */
+    int find(std::string_view method, std::string_view path) {
+        _params = {};
+        auto const* tagged = _tree.find(method, path, _params).target<Tagged>();
+        return tagged ? tagged->id : -1;
+    }
+
+    RouterTree _tree;
+    PathParams _params;
+};
+
+TEST_F(RouterTreeTest, StaticRoutes) {
+    add("GET", "/", 1);
+    add("GET", "/a/b", 2);
+    add("GET", "/a/bc", 3);
+    add("POST", "/a/b", 4);
+    _tree.compile();
+    EXPECT_EQ(find("GET", "/"), 1);
+    EXPECT_EQ(find("GET", "/a/b"), 2);
+    EXPECT_EQ(find("GET", "/a/bc"), 3);
+    EXPECT_EQ(find("POST", "/a/b"), 4);
+    EXPECT_EQ(find("GET", "/a"), -1);
+    EXPECT_EQ(find("GET", "/a/b/c"), -1);
+    EXPECT_EQ(find("PUT", "/a/b"), -1);
+    // 末尾与重复的 `/` 不影响匹配
+    EXPECT_EQ(find("GET", "/a/b/"), 2);
+    EXPECT_EQ(find("GET", "//a//b"), 2);
+}
+
+TEST_F(RouterTreeTest, RoutesAreFoundOnlyAfterCompile) {
+    _tree.compile();
+    add("GET", "/late", 1);
+    EXPECT_EQ(find("GET", "/late"), -1);
+    _tree.compile();
+    EXPECT_EQ(find("GET", "/late"), 1);
+}
+
+TEST_F(RouterTreeTest, PathParams) {
+    add("GET", "/users/{uid}/items/{id}", 1);
+    _tree.compile();
+    ASSERT_EQ(find("GET", "/users/42/items/abc"), 1);
+    ASSERT_EQ(_params.paramNum, 2u);
+    EXPECT_EQ(_params.params[0], "42");
+    EXPECT_EQ(_params.params[1], "abc");
+    EXPECT_EQ(find("GET", "/users/42/items"), -1);
+}
+
+TEST_F(RouterTreeTest, StaticBeatsParamAndParamBeatsWildcard) {
+    add("GET", "/files/list", 1);
+    add("GET", "/files/{name}", 2);
+    add("GET", "/files/**", 3);
+    _tree.compile();
+    EXPECT_EQ(find("GET", "/files/list"), 1);
+    EXPECT_EQ(_params.paramNum, 0u);
+    EXPECT_EQ(find("GET", "/files/a.txt"), 2);
+    EXPECT_EQ(_params.params[0], "a.txt");
+    EXPECT_EQ(find("GET", "/files/a/b"), 3);
+    EXPECT_EQ(_params.wildcard, "/a/b");
+    EXPECT_EQ(_params.paramNum, 0u);
+}
+
+TEST_F(RouterTreeTest, BacktracksOutOfDeadEnds) {
+    add("GET", "/a/b/c", 1);
+    add("GET", "/a/{x}/d", 2);
+    _tree.compile();
+    // 静态边 `b` 匹配后没有 `d`, 回退到参数边
+    EXPECT_EQ(find("GET", "/a/b/d"), 2);
+    ASSERT_EQ(_params.paramNum, 1u);
+    EXPECT_EQ(_params.params[0], "b");
+    EXPECT_EQ(find("GET", "/a/b/c"), 1);
+    EXPECT_EQ(_params.paramNum, 0u);
+}
+
+TEST_F(RouterTreeTest, Wildcard) {
+    add("GET", "/static/**", 1);
+    add("GET", "/home/{id}/**", 2);
+    _tree.compile();
+    EXPECT_EQ(find("GET", "/static/css/a.css"), 1);
+    EXPECT_EQ(_params.wildcard, "/css/a.css");
+    EXPECT_EQ(find("GET", "/static/"), 1);
+    EXPECT_EQ(_params.wildcard, "/");
+    EXPECT_EQ(find("GET", "/static"), -1);
+    EXPECT_EQ(find("GET", "/home/7/x/y"), 2);
+    EXPECT_EQ(_params.params[0], "7");
+    EXPECT_EQ(_params.wildcard, "/x/y");
+}
+
+TEST_F(RouterTreeTest, LaterInsertOverridesEarlier) {
+    add("GET", "/dup", 1);
+    add("GET", "/dup", 2);
+    _tree.compile();
+    EXPECT_EQ(find("GET", "/dup"), 2);
+}
+
+TEST_F(RouterTreeTest, RejectsBadTemplates) {
+    EXPECT_THROW(add("GET", "/a/**/b", 1), std::runtime_error);
+    std::string path;
+    for (std::size_t i = 0; i <= PathParams::kMaxParamNum; ++i) {
+        path += "/{p" + std::to_string(i) + "}";
+    }
+    EXPECT_THROW(add("GET", path, 1), std::runtime_error);
+}
+
+TEST_F(RouterTreeTest, ManyRoutes) {
+    for (int i = 0; i < 1000; ++i) {
+        auto s = std::to_string(i);
+        add("GET", "/api/v1/res" + s + "/list", i);
+        add("GET", "/api/v1/res" + s + "/{id}", 10000 + i);
+    }
+    _tree.compile();
+    for (int i = 0; i < 1000; ++i) {
+        auto s = std::to_string(i);
+        ASSERT_EQ(find("GET", "/api/v1/res" + s + "/list"), i);
+        auto path = "/api/v1/res" + s + "/12345"; // 路径参数指向 path
+        ASSERT_EQ(find("GET", path), 10000 + i);
+        ASSERT_EQ(_params.params[0], "12345");
+    }
+    EXPECT_EQ(find("GET", "/api/v1/res1000/list"), -1);
+}
+
+} // namespace
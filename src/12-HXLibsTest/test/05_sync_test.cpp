@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+#include <HXLibs/coroutine/sync/AsyncMutex.hpp>
+#include <HXLibs/coroutine/sync/AsyncSemaphore.hpp>
+#include <HXLibs/coroutine/sync/AsyncEvent.hpp>
+#include <HXLibs/coroutine/sync/Channel.hpp>
+
+using namespace HX::coroutine;
+using namespace std::chrono_literals;
+
+namespace {
+
+TEST(AsyncMutexTest, MutualExclusionOnOneLoop) {
+    EventLoop loop;
+    AsyncMutex mtx;
+    int inside = 0, maxInside = 0, total = 0;
+    auto worker = [&]() -> Task<> {
+        for (int i = 0; i < 100; ++i) {
+            auto _ = co_await mtx.scopedLock();
+            ++inside;
+            maxInside = std::max(maxInside, inside);
+            co_await loop.makeTimer().sleepFor(10us);
+            ++total;
+            --inside;
+        }
+    };
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 8; ++i) {
+        tasks.push_back(worker());
+    }
+    loop.sync(whenAll(std::move(tasks)));
+    EXPECT_EQ(total, 800);
+    EXPECT_EQ(maxInside, 1);
+    EXPECT_TRUE(mtx.tryLock());
+}
+
+TEST(AsyncMutexTest, DeepQueueDoesNotRecurseThroughUnlock) {
+    EventLoop loop;
+    AsyncMutex mtx;
+    constexpr int N = 200'000;
+    int total = 0;
+    auto holder = [&]() -> Task<> {
+        co_await mtx.lock();
+        co_await loop.makeTimer().sleepFor(1ms);
+        mtx.unlock();
+    };
+    auto worker = [&]() -> Task<> {
+        co_await mtx.lock();
+        ++total;
+        mtx.unlock();
+    };
+    std::vector<Task<>> tasks;
+    tasks.push_back(holder());
+    for (int i = 0; i < N; ++i) {
+        tasks.push_back(worker());
+    }
+    loop.sync(whenAll(std::move(tasks)));
+    EXPECT_EQ(total, N);
+    EXPECT_TRUE(mtx.tryLock());
+}
+
+TEST(AsyncSemaphoreTest, LimitsConcurrency) {
+    EventLoop loop;
+    AsyncSemaphore sem{3};
+    int inside = 0, maxInside = 0;
+    auto worker = [&]() -> Task<> {
+        co_await sem.acquire();
+        ++inside;
+        maxInside = std::max(maxInside, inside);
+        co_await loop.makeTimer().sleepFor(1ms);
+        --inside;
+        sem.release();
+    };
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 10; ++i) {
+        tasks.push_back(worker());
+    }
+    loop.sync(whenAll(std::move(tasks)));
+    EXPECT_EQ(maxInside, 3);
+    EXPECT_EQ(sem.available(), 3u);
+}
+
+TEST(AsyncEventTest, SetWakesAllWaitersOnTheNextIteration) {
+    EventLoop loop;
+    AsyncEvent ev;
+    int woke = 0;
+    auto waiter = [&]() -> Task<> {
+        co_await ev.wait();
+        ++woke;
+    };
+    auto setter = [&]() -> Task<> {
+        co_await loop.makeTimer().sleepFor(2ms);
+        EXPECT_EQ(woke, 0);
+        ev.set();
+        // 唤醒是投递到事件循环的, 不会在 set() 内部恢复
+        EXPECT_EQ(woke, 0);
+    };
+    loop.sync(whenAll(waiter(), waiter(), waiter(), setter()));
+    EXPECT_EQ(woke, 3);
+    EXPECT_TRUE(ev.isSet());
+    loop.sync(waiter());
+    EXPECT_EQ(woke, 4);
+}
+
+class ChannelTest : public ::testing::TestWithParam<std::size_t> {};
+
+TEST_P(ChannelTest, DeliversEveryElementOnce) {
+    EventLoop loop;
+    Channel<std::unique_ptr<int>> ch{GetParam()};
+    long sum = 0;
+    int got = 0;
+    auto producer = [&]() -> Task<> {
+        for (int i = 1; i <= 1000; ++i) {
+            EXPECT_TRUE(co_await ch.send(std::make_unique<int>(i)));
+        }
+        ch.close();
+        EXPECT_FALSE(co_await ch.send(std::make_unique<int>(0)));
+    };
+    auto consumer = [&]() -> Task<> {
+        while (auto val = co_await ch.recv()) {
+            sum += **val;
+            ++got;
+        }
+    };
+    loop.sync(whenAll(consumer(), consumer(), producer()));
+    EXPECT_EQ(sum, 500500);
+    EXPECT_EQ(got, 1000);
+}
+
+TEST_P(ChannelTest, CrossLoopWithMutex) {
+    constexpr int kPerProducer = 20'000;
+    std::atomic_bool done{false};
+    std::atomic_int producerNum{2};
+    Channel<int> ch{GetParam()};
+    AsyncMutex mtx;
+    long shared = 0;
+    long sum = 0;
+    auto producerLoop = [&] {
+        EventLoop loop;
+        auto task = [&]() -> Task<> {
+            for (int i = 1; i <= kPerProducer; ++i) {
+                EXPECT_TRUE(co_await ch.send(i));
+                auto _ = co_await mtx.scopedLock();
+                ++shared;
+            }
+        };
+        loop.sync(task());
+        --producerNum;
+        // 唤醒可能投递到了其他事件循环, 等它们都退出后再析构
+        while (!done) {
+            std::this_thread::yield();
+        }
+    };
+    std::jthread consumer([&] {
+        EventLoop loop;
+        auto task = [&]() -> Task<> {
+            int n = 0;
+            while (auto val = co_await ch.recv()) {
+                sum += *val;
+                if (++n == 2 * kPerProducer) {
+                    break;
+                }
+                auto _ = co_await mtx.scopedLock();
+                ++shared;
+            }
+            done = true;
+        };
+        loop.sync(task());
+        while (producerNum) {
+            std::this_thread::yield();
+        }
+    });
+    std::jthread p1{producerLoop};
+    std::jthread p2{producerLoop};
+    p1.join();
+    p2.join();
+    consumer.join();
+    EXPECT_EQ(sum, 2L * kPerProducer * (kPerProducer + 1) / 2);
+    EXPECT_EQ(shared, 2L * kPerProducer + 2L * kPerProducer - 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(Capacity, ChannelTest, ::testing::Values(0u, 1u, 16u));
+
+TEST(ChannelTryTest, TrySendAndTryRecv) {
+    Channel<int> ch{1};
+    int val = 1;
+    EXPECT_TRUE(ch.trySend(val));
+    EXPECT_FALSE(ch.trySend(val));
+    EXPECT_EQ(ch.tryRecv(), 1);
+    EXPECT_FALSE(ch.tryRecv());
+
+    // 无缓冲且没有接收者
+    Channel<int> unbuffered{0};
+    EXPECT_FALSE(unbuffered.trySend(val));
+}
+
+TEST(ChannelTryTest, FailedRvalueTrySendKeepsTheValue) {
+    Channel<std::string> ch{1};
+    EXPECT_TRUE(ch.trySend(std::string{"a"}));
+    std::string val = "b";
+    EXPECT_FALSE(ch.trySend(std::move(val)));
+    EXPECT_EQ(val, "b");
+    ch.close();
+    EXPECT_TRUE(ch.isClosed());
+    EXPECT_EQ(ch.tryRecv(), "a");
+    EXPECT_FALSE(ch.tryRecv());
+}
+
+} // namespace
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <future>
+
+#include <sys/resource.h>
+
+#include <HXLibs/net/Api.hpp>
+
+#include <RawHttpClient.hpp>
+
+using namespace HX;
+using namespace std::string_view_literals;
+
+namespace {
+
+constexpr uint16_t kPort = 28306;
+
+constexpr auto kGet = "GET / HTTP/1.1\r\nHost: x\r\n\r\n"sv;
+
+std::unique_ptr<net::HttpServer> makeServer() {
+    auto ser = std::make_unique<net::HttpServer>("127.0.0.1", std::to_string(kPort));
+    ser->addEndpoint<net::GET>("/", [] ENDPOINT {
+        co_await res.setStatusAndContent(net::Status::CODE_200, "hello").sendRes();
+    });
+    ser->asyncRun(1);
+    test::waitForServer(kPort);
+    return ser;
+}
+
+bool isListening() {
+    try {
+        test::RawHttpClient cli{kPort};
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+/**
+ * @brief 在另一个线程中关闭服务器, 超时则视为没有关闭 (避免测试挂起)
+ * @return std::chrono::milliseconds 关闭耗时
+ */
+std::chrono::milliseconds stopServer(std::unique_ptr<net::HttpServer>& ser) {
+    auto begin = std::chrono::steady_clock::now();
+    auto done = std::async(std::launch::async, [&] {
+        ser.reset();
+    });
+    if (done.wait_for(std::chrono::seconds{5}) != std::future_status::ready) {
+        ADD_FAILURE() << "server did not stop";
+        std::abort();
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - begin);
+}
+
+} // namespace
+
+TEST(AcceptTest, ManyConnectionsFromOneSubmission) {
+    auto ser = makeServer();
+    // 多发 accept 只提交一次, 之后每个连接一个 cqe (带 IORING_CQE_F_MORE)
+    constexpr std::size_t kConnNum = 64;
+    std::vector<std::unique_ptr<test::RawHttpClient>> clis;
+    for (std::size_t i = 0; i < kConnNum; ++i) {
+        clis.push_back(std::make_unique<test::RawHttpClient>(kPort));
+    }
+    for (auto& cli : clis) {
+        cli->send(kGet);
+    }
+    for (auto& cli : clis) {
+        auto res = test::splitResponses(cli->recvSome());
+        ASSERT_EQ(res.size(), 1u);
+        EXPECT_EQ(res[0].body, "hello");
+    }
+    stopServer(ser);
+}
+
+TEST(AcceptTest, StopCancelsAcceptAndClosesIdleConnections) {
+    auto ser = makeServer();
+    std::vector<std::unique_ptr<test::RawHttpClient>> clis;
+    for (std::size_t i = 0; i < 16; ++i) {
+        clis.push_back(std::make_unique<test::RawHttpClient>(kPort));
+    }
+    // 一半的连接先完成一个请求, 处于保活的空闲状态; 另一半从未发送过请求
+    for (std::size_t i = 0; i < clis.size(); i += 2) {
+        clis[i]->send(kGet);
+        ASSERT_EQ(test::splitResponses(clis[i]->recvSome()).size(), 1u);
+    }
+    // 只有取消了多发 accept (最后一个 cqe 不带 IORING_CQE_F_MORE), 事件循环才会退出
+    EXPECT_LT(stopServer(ser), std::chrono::seconds{2});
+    // 监听套接字已经关闭
+    EXPECT_FALSE(isListening());
+    for (auto& cli : clis) {
+        cli->recvAll();
+        EXPECT_TRUE(cli->isClosed());
+    }
+}
+
+TEST(AcceptTest, RearmsAfterTheMultishotAcceptTerminates) {
+    // io_uring 在准备 accept 的 sqe 时读取 RLIMIT_NOFILE: 在较低的限制下启动服务器 (提交多发 accept),
+    // 之后恢复限制, 多发 accept 就会在服务端的 fd 超过旧的限制时以 -EMFILE 结束 (不带 IORING_CQE_F_MORE);
+    // 重新提交的 accept 使用恢复后的限制, 可以接受剩下的连接
+    constexpr rlim_t kLowLimit = 64;
+    ::rlimit old{};
+    ::getrlimit(RLIMIT_NOFILE, &old);
+    ASSERT_GT(old.rlim_cur, 4 * kLowLimit);
+    ::rlimit low = old;
+    low.rlim_cur = kLowLimit;
+    ::setrlimit(RLIMIT_NOFILE, &low);
+    auto ser = makeServer();
+    ::setrlimit(RLIMIT_NOFILE, &old);
+
+    // 每个连接在本进程中占用两个 fd (客户端与服务端)
+    std::vector<std::unique_ptr<test::RawHttpClient>> clis;
+    for (std::size_t i = 0; i < kLowLimit; ++i) {
+        clis.push_back(std::make_unique<test::RawHttpClient>(kPort, std::chrono::milliseconds{3000}));
+    }
+    for (auto& cli : clis) {
+        cli->send(kGet);
+    }
+    for (auto& cli : clis) {
+        auto res = test::splitResponses(cli->recvSome());
+        ASSERT_EQ(res.size(), 1u);
+        EXPECT_EQ(res[0].body, "hello");
+    }
+    stopServer(ser);
+}
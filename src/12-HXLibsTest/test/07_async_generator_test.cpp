@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <span>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+#include <HXLibs/coroutine/task/AsyncGenerator.hpp>
+#include <HXLibs/net/Api.hpp>
+
+#include <RawHttpClient.hpp>
+
+using namespace HX;
+using namespace HX::coroutine;
+using namespace std::chrono_literals;
+using namespace std::string_view_literals;
+
+namespace {
+
+/**
+ * @brief 析构时计数, 用于观察协程帧是否被销毁
+ */
+struct DtorCounter {
+    int& num;
+
+    ~DtorCounter() noexcept {
+        ++num;
+    }
+};
+
+TEST(AsyncGeneratorTest, YieldsInOrderAcrossAwaits) {
+    EventLoop loop;
+    auto gen = [&]() -> AsyncGenerator<int> {
+        for (int i = 0; i < 5; ++i) {
+            // 协程体内可以 co_await, 之后再 co_yield
+            co_await loop.makeTimer().sleepFor(1ms);
+            co_yield i;
+        }
+    };
+    std::vector<int> out;
+    loop.sync([&]() -> Task<> {
+        auto g = gen();
+        while (auto v = co_await g.next()) {
+            out.push_back(*v);
+        }
+        // 结束之后再次 next() 仍然为空
+        EXPECT_FALSE(co_await g.next());
+    }());
+    EXPECT_EQ(out, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+TEST(AsyncGeneratorTest, IsLazy) {
+    EventLoop loop;
+    int started = 0;
+    auto gen = [&]() -> AsyncGenerator<int> {
+        ++started;
+        co_yield 1;
+    };
+    loop.sync([&]() -> Task<> {
+        auto g = gen();
+        EXPECT_EQ(started, 0);
+        EXPECT_EQ(*co_await g.next(), 1);
+        EXPECT_EQ(started, 1);
+    }());
+}
+
+TEST(AsyncGeneratorTest, ExceptionIsRethrownFromNext) {
+    EventLoop loop;
+    auto gen = [&]() -> AsyncGenerator<int> {
+        co_yield 1;
+        co_await loop.makeTimer().sleepFor(1ms);
+        throw std::runtime_error{"boom"};
+    };
+    loop.sync([&]() -> Task<> {
+        auto g = gen();
+        EXPECT_EQ(*co_await g.next(), 1);
+        bool isThrown = false;
+        try {
+            co_await g.next();
+        } catch (std::runtime_error const& err) {
+            isThrown = err.what() == "boom"sv;
+        }
+        EXPECT_TRUE(isThrown);
+        // 异常只抛出一次, 之后生成器已经结束
+        EXPECT_FALSE(co_await g.next());
+    }());
+}
+
+TEST(AsyncGeneratorTest, DestroyMidStreamReleasesFrame) {
+    EventLoop loop;
+    int dtorNum = 0;
+    int resumed = 0;
+    auto gen = [&]() -> AsyncGenerator<int> {
+        DtorCounter _{dtorNum};
+        co_yield 1;
+        ++resumed;
+        co_yield 2;
+    };
+    loop.sync([&]() -> Task<> {
+        {
+            auto g = gen();
+            EXPECT_EQ(*co_await g.next(), 1);
+        }
+        // 停在 co_yield 处的生成器被销毁: 局部变量析构, 之后的代码不会运行
+        EXPECT_EQ(dtorNum, 1);
+        EXPECT_EQ(resumed, 0);
+        {
+            // 从未开始的生成器: 协程体没有运行, 帧同样被释放
+            auto g = gen();
+        }
+        EXPECT_EQ(dtorNum, 1);
+        co_return;
+    }());
+}
+
+TEST(AsyncGeneratorTest, MovedFromGeneratorIsEmpty) {
+    EventLoop loop;
+    auto gen = []() -> AsyncGenerator<int> {
+        co_yield 7;
+    };
+    loop.sync([&]() -> Task<> {
+        auto a = gen();
+        auto b = std::move(a);
+        EXPECT_FALSE(co_await a.next());
+        EXPECT_EQ(*co_await b.next(), 7);
+    }());
+}
+
+constexpr uint16_t kPort = 28307;
+
+TEST(SendStreamTest, ChunksAreSentAsTheyAreProduced) {
+    // 生产者产出第一个片段后, 一直等到客户端收到它才继续; 如果片段被积攒, 客户端会超时
+    std::atomic_bool isReceived{false};
+    net::HttpServer ser{"127.0.0.1", std::to_string(kPort)};
+    ser.addEndpoint<net::GET>("/slow", [&] ENDPOINT {
+        auto gen = [&]() -> AsyncGenerator<std::span<char const>> {
+            co_yield "first"sv;
+            for (int i = 0; i < 400 && !isReceived; ++i) {
+                co_await EventLoop::current()->makeTimer().sleepFor(5ms);
+            }
+            co_yield ""sv;
+            co_yield "second"sv;
+        };
+        co_await res.setResLine(net::Status::CODE_200)
+                    .setContentType(net::TEXT)
+                    .sendStream(gen());
+    });
+    ser.asyncRun(1);
+    test::waitForServer(kPort);
+
+    test::RawHttpClient cli{kPort, 1000ms};
+    cli.send("GET /slow HTTP/1.1\r\nHost: x\r\n\r\n");
+    std::string out;
+    while (out.find("5\r\nfirst\r\n") == std::string::npos) {
+        auto data = cli.recvSome();
+        ASSERT_FALSE(data.empty()) << "the first chunk was not sent before the producer suspended";
+        out += data;
+    }
+    EXPECT_EQ(out.find("second"), std::string::npos);
+    isReceived = true;
+    while (!out.ends_with("0\r\n\r\n")) {
+        auto data = cli.recvSome();
+        ASSERT_FALSE(data.empty());
+        out += data;
+    }
+    auto res = test::splitResponses(out);
+    ASSERT_EQ(res.size(), 1u);
+    // 空的片段被跳过, 没有被当作结束标记
+    EXPECT_EQ(res[0].body, "firstsecond");
+}
+
+} // namespace
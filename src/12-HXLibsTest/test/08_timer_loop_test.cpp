@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <HXLibs/coroutine/loop/TimerLoop.hpp>
+
+using namespace HX::coroutine;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = TimerLoop::Clock;
+using TimerAwaiter = TimerLoop::TimerAwaiter;
+
+/**
+ * @brief 被定时器恢复时执行 fn 的协程 (直接交给 await_suspend, 不经过事件循环)
+ */
+struct Probe {
+    struct promise_type {
+        Probe get_return_object() noexcept {
+            return {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    Probe(std::coroutine_handle<promise_type> h) noexcept
+        : _h{h}
+    {}
+
+    Probe(Probe&& that) noexcept
+        : _h{std::exchange(that._h, nullptr)}
+    {}
+
+    ~Probe() noexcept {
+        if (_h) {
+            _h.destroy();
+        }
+    }
+
+    std::coroutine_handle<promise_type> _h;
+};
+
+Probe makeProbe(std::function<void()> fn) {
+    fn();
+    co_return;
+}
+
+/**
+ * @brief 对齐到整毫秒的起点, 使 base + d 恰好是定时器到期的 tick
+ */
+Clock::time_point alignedNow() {
+    return std::chrono::ceil<std::chrono::milliseconds>(Clock::now());
+}
+
+/**
+ * @brief 一组以 base 为起点的定时器, 记录它们被唤醒的顺序
+ */
+struct Timers {
+    explicit Timers(TimerLoop& loop)
+        : _loop{loop}
+        , _base{alignedNow()}
+    {}
+
+    /**
+     * @brief 添加一个 base + ms 到期的定时器, 到期时记录 id
+     */
+    TimerAwaiter& add(uint64_t ms, int id) {
+        _probes.push_back(makeProbe([this, id] { _fired.push_back(id); }));
+        auto& aw = _awaiters.emplace_back(std::make_unique<TimerAwaiter>(
+            TimerLoop::makeTimer(_loop).sleepUntil(at(ms))));
+        aw->await_suspend(_probes.back()._h);
+        return *aw;
+    }
+
+    Clock::time_point at(uint64_t ms) const {
+        return _base + std::chrono::milliseconds{ms};
+    }
+
+    std::optional<Clock::duration> run(uint64_t ms) {
+        return _loop.run(at(ms));
+    }
+
+    TimerLoop& _loop;
+    Clock::time_point _base;
+    std::vector<Probe> _probes;
+    std::vector<std::unique_ptr<TimerAwaiter>> _awaiters;
+    std::vector<int> _fired;
+};
+
+} // namespace
+
+TEST(TimerLoopTest, ExpiresInOrderAcrossLevelBoundaries) {
+    TimerLoop loop;
+    Timers t{loop};
+    // 每层 256 个槽: 255 / 256 在第 0 / 1 层的边界, 65535 / 65536 在第 1 / 2 层的边界, 2^24 在第 2 / 3 层的边界
+    std::vector<uint64_t> deadlines{65536, 1, 256, 16777216, 255, 65535, 257, 65537, 512, 16777215};
+    for (std::size_t i = 0; i < deadlines.size(); ++i) {
+        t.add(deadlines[i], static_cast<int>(deadlines[i]));
+    }
+    auto sorted = deadlines;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> want;
+    for (auto d : sorted) {
+        // 到期前一毫秒不唤醒, 到期时恰好唤醒这一个
+        auto next = t.run(d - 1);
+        ASSERT_TRUE(next);
+        EXPECT_EQ(t._fired, want) << "fired early before " << d;
+        // 返回的等待时间不会越过下一个到期时间 (高层可能提前返回, 用于降级)
+        EXPECT_LE(*next, 1ms) << d;
+        want.push_back(static_cast<int>(d));
+        t.run(d);
+        EXPECT_EQ(t._fired, want) << "not fired at " << d;
+    }
+    EXPECT_FALSE(t.run(sorted.back() + 1));
+}
+
+TEST(TimerLoopTest, FiresInDeadlineOrderWhenManyExpireAtOnce) {
+    TimerLoop loop;
+    Timers t{loop};
+    std::vector<uint64_t> deadlines{65536, 1, 256, 255, 65535, 257, 3, 70000};
+    for (auto d : deadlines) {
+        t.add(d, static_cast<int>(d));
+    }
+    // 一次推进越过所有定时器, 途经的槽按时间顺序接到就绪链表
+    EXPECT_FALSE(t.run(100000));
+    EXPECT_EQ(t._fired, (std::vector<int>{1, 3, 255, 256, 257, 65535, 65536, 70000}));
+    EXPECT_EQ(loop.firedNum(), deadlines.size());
+}
+
+TEST(TimerLoopTest, DeadlineBeyondTheWheelRange) {
+    TimerLoop loop;
+    Timers t{loop};
+    // 超过 2^32 ms 的定时器先放在最高层, 在最高层反复降级, 不会提前到期
+    constexpr uint64_t kFar = (uint64_t{1} << 32) + 5;
+    t.add(kFar, 1);
+    t.add(10, 2);
+    t.run(10);
+    EXPECT_EQ(t._fired, (std::vector<int>{2}));
+    for (uint64_t ms : {uint64_t{1} << 31, (uint64_t{1} << 32) - 1, uint64_t{1} << 32, kFar - 1}) {
+        ASSERT_TRUE(t.run(ms)) << ms;
+        EXPECT_EQ(t._fired, (std::vector<int>{2})) << "fired early at " << ms;
+    }
+    EXPECT_FALSE(t.run(kFar));
+    EXPECT_EQ(t._fired, (std::vector<int>{2, 1}));
+}
+
+TEST(TimerLoopTest, CancelAfterSpliceToReadyList) {
+    TimerLoop loop;
+    Timers t{loop};
+    // a 与 b 在同一个槽, 到期时整个槽接到就绪链表 (节点的 _slotId 仍然指向原来的槽);
+    // a 被唤醒时取消仍在就绪链表中的 b, 并添加一个之后会降级到同一个槽的定时器 c
+    constexpr uint64_t kDeadline = 10;
+    TimerAwaiter* b = nullptr;
+    t._probes.push_back(makeProbe([&] {
+        t._fired.push_back(1);
+        b->cancel();
+        t.add(kDeadline + 256, 3);
+    }));
+    auto a = TimerLoop::makeTimer(loop).sleepUntil(t.at(kDeadline));
+    a.await_suspend(t._probes.back()._h);
+    b = &t.add(kDeadline, 2);
+    // 同一层其他的槽也有定时器, 取消 b 不能影响它们
+    t.add(kDeadline + 1, 4);
+
+    t.run(kDeadline);
+    EXPECT_EQ(t._fired, (std::vector<int>{1}));
+    // 已经取消的 b 不再处于任何链表中, 再次取消什么也不做
+    b->cancel();
+    t.run(kDeadline + 1);
+    EXPECT_EQ(t._fired, (std::vector<int>{1, 4}));
+    ASSERT_TRUE(t.run(kDeadline + 255));
+    EXPECT_EQ(t._fired, (std::vector<int>{1, 4}));
+    // c 唤醒之后时间轮为空 (计数没有因为 b 被多减或少减)
+    EXPECT_FALSE(t.run(kDeadline + 256));
+    EXPECT_EQ(t._fired, (std::vector<int>{1, 4, 3}));
+    EXPECT_EQ(loop.firedNum(), 3u);
+}
+
+TEST(TimerLoopTest, MoveAwaiterWhileArmed) {
+    TimerLoop loop;
+    Timers t{loop};
+    // 同一个槽中的三个定时器, 中间的那个在等待期间被移动, 邻居要指向新的地址
+    t.add(5, 1);
+    t._probes.push_back(makeProbe([&] { t._fired.push_back(2); }));
+    auto mid = std::make_unique<TimerAwaiter>(TimerLoop::makeTimer(loop).sleepUntil(t.at(5)));
+    mid->await_suspend(t._probes.back()._h);
+    t.add(5, 3);
+
+    auto moved = std::make_unique<TimerAwaiter>(std::move(*mid));
+    mid.reset(); // 被移动后的对象析构, 不会取消已经转移的定时器
+
+    // 移动赋值给一个正在等待的定时器: 原来的定时器被取消
+    auto& other = t.add(7, 4);
+    other = std::move(*moved);
+    moved.reset();
+
+    // 移动赋值给自己什么也不做
+    auto& self = other;
+    other = std::move(self);
+
+    EXPECT_FALSE(t.run(10));
+    EXPECT_EQ(t._fired, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(TimerLoopTest, TimerAddedInThePastIsReadyImmediately) {
+    TimerLoop loop;
+    Timers t{loop};
+    t.add(100, 1);
+    t.run(50);
+    // 到期时间早于时间轮当前的 tick, 直接进入就绪链表, run() 返回 0 等待
+    t._probes.push_back(makeProbe([&] { t._fired.push_back(2); }));
+    auto past = TimerLoop::makeTimer(loop).sleepUntil(t.at(0));
+    past.await_suspend(t._probes.back()._h);
+    t.run(50);
+    EXPECT_EQ(t._fired, (std::vector<int>{2}));
+    EXPECT_FALSE(t.run(100));
+    EXPECT_EQ(t._fired, (std::vector<int>{2, 1}));
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+#include <HXLibs/coroutine/awaiter/WhenAll.hpp>
+
+using namespace HX::coroutine;
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+
+namespace {
+
+Task<int> syncValue(int v) {
+    co_return v;
+}
+
+Task<> syncVoid(int& num) {
+    ++num;
+    co_return;
+}
+
+TEST(WhenAllTest, AllChildrenSynchronousDoesNotSuspend) {
+    int num = 0;
+    // 不经过事件循环直接执行: 如果 whenAll 挂起了, 没有人会恢复它, runSync() 会抛出
+    auto [a, b, c] = whenAll(syncValue(1), syncVoid(num), syncValue(3)).runSync();
+    EXPECT_EQ(a, 1);
+    EXPECT_EQ(c, 3);
+    EXPECT_EQ(num, 1);
+
+    std::vector<Task<int>> tasks;
+    for (int i = 0; i < 10'000; ++i) {
+        tasks.push_back(syncValue(i));
+    }
+    auto res = whenAll(std::move(tasks)).runSync();
+    ASSERT_EQ(res.size(), 10'000u);
+    EXPECT_EQ(res.front(), 0);
+    EXPECT_EQ(res.back(), 9'999);
+
+    // 空的 vector 同样不挂起
+    EXPECT_TRUE(whenAll(std::vector<Task<int>>{}).runSync().empty());
+}
+
+TEST(WhenAllTest, MixedVoidAndNonVoidChildren) {
+    EventLoop loop;
+    std::vector<std::string> order;
+    auto value = [&](std::string s, std::chrono::milliseconds delay) -> Task<std::string> {
+        co_await loop.makeTimer().sleepFor(delay);
+        order.push_back(s);
+        co_return s;
+    };
+    auto nothing = [&](std::chrono::milliseconds delay) -> Task<> {
+        co_await loop.makeTimer().sleepFor(delay);
+        order.push_back("void");
+    };
+    auto [a, v, b, n] = loop.sync(whenAll(
+        value("a", 20ms), nothing(10ms), value("b", 1ms), syncValue(7)));
+    static_assert(std::is_same_v<decltype(v), HX::container::NonVoidHelper<>>);
+    // 返回值按参数的顺序, 与完成的顺序无关
+    EXPECT_EQ(a, "a");
+    EXPECT_EQ(b, "b");
+    EXPECT_EQ(n, 7);
+    EXPECT_EQ(order, (std::vector<std::string>{"b", "void", "a"}));
+}
+
+TEST(WhenAllTest, VectorOverloadKeepsArgumentOrder) {
+    EventLoop loop;
+    auto delayed = [&](int i) -> Task<int> {
+        // 越靠前的完成得越晚
+        co_await loop.makeTimer().sleepFor(std::chrono::milliseconds{20 - i});
+        co_return i * i;
+    };
+    std::vector<Task<int>> tasks;
+    for (int i = 0; i < 20; ++i) {
+        tasks.push_back(delayed(i));
+    }
+    auto res = loop.sync(whenAll(std::move(tasks)));
+    ASSERT_EQ(res.size(), 20u);
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(res[static_cast<std::size_t>(i)], i * i);
+    }
+
+    int num = 0;
+    auto nothing = [&]() -> Task<> {
+        co_await loop.makeTimer().sleepFor(1ms);
+        ++num;
+    };
+    std::vector<Task<>> voids;
+    voids.push_back(nothing());
+    voids.push_back(nothing());
+    EXPECT_EQ(loop.sync(whenAll(std::move(voids))).size(), 2u);
+    EXPECT_EQ(num, 2);
+}
+
+TEST(WhenAllTest, FirstExceptionIsRethrownAfterAllChildrenFinish) {
+    EventLoop loop;
+    int finished = 0;
+    auto fail = [&](std::string msg, std::chrono::milliseconds delay) -> Task<int> {
+        co_await loop.makeTimer().sleepFor(delay);
+        ++finished;
+        throw std::runtime_error{msg};
+    };
+    auto slow = [&]() -> Task<int> {
+        co_await loop.makeTimer().sleepFor(30ms);
+        ++finished;
+        co_return 1;
+    };
+    auto syncFail = [&]() -> Task<int> {
+        ++finished;
+        throw std::runtime_error{"sync"};
+        co_return 0;
+    };
+    loop.sync([&]() -> Task<> {
+        // "first" 最先抛出, 此时其他子协程还在等待; whenAll 要等它们全部完成后才抛出
+        try {
+            co_await whenAll(slow(), fail("second", 10ms), fail("first", 1ms));
+            ADD_FAILURE() << "not thrown";
+        } catch (std::runtime_error const& err) {
+            EXPECT_EQ(err.what(), "first"s);
+            EXPECT_EQ(finished, 3);
+        }
+        // 同步抛出的子协程 (启动阶段) 同样要等待其他子协程完成
+        finished = 0;
+        std::vector<Task<int>> tasks;
+        tasks.push_back(slow());
+        tasks.push_back(syncFail());
+        tasks.push_back(fail("later", 5ms));
+        try {
+            co_await whenAll(std::move(tasks));
+            ADD_FAILURE() << "not thrown";
+        } catch (std::runtime_error const& err) {
+            EXPECT_EQ(err.what(), "sync"s);
+            EXPECT_EQ(finished, 3);
+        }
+    }());
+}
+
+} // namespace
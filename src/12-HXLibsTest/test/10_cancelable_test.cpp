@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+
+#include <future>
+#include <stop_token>
+#include <thread>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+#include <HXLibs/net/Api.hpp>
+
+#include <RawHttpClient.hpp>
+
+using namespace HX;
+using namespace HX::coroutine;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief 一对本地套接字, 在 recv 上等待的一端没有数据时会一直挂起
+ * @note 5s 后看门狗写入数据, 让没有被取消的 recv 完成 (断言失败而不是测试挂起)
+ */
+struct SocketPair {
+    SocketPair() {
+        ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds);
+        watchdog = std::jthread{[this](std::stop_token token) {
+            auto end = Clock::now() + 5s;
+            while (!token.stop_requested() && Clock::now() < end) {
+                std::this_thread::sleep_for(5ms);
+            }
+            if (!token.stop_requested()) {
+                [[maybe_unused]] auto _ = ::write(fds[1], "x", 1);
+            }
+        }};
+    }
+
+    ~SocketPair() noexcept {
+        watchdog = {};
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    int fds[2]{-1, -1};
+    std::jthread watchdog;
+};
+
+/**
+ * @brief 事件循环已经没有未完成的 IO (取消请求与被取消的任务的 cqe 都已经收到)
+ */
+void expectNoPendingIo(EventLoop& loop) {
+    EXPECT_FALSE(loop.getEventDrive().isRun());
+    // 还可以再次 sync, 说明没有残留的任务
+    EXPECT_NO_THROW(loop.sync([]() -> Task<> { co_return; }()));
+}
+
+TEST(CancelableAioTest, StopBeforeSubmission) {
+    EventLoop loop;
+    SocketPair sp;
+    std::stop_source src;
+    src.request_stop();
+    char buf[16];
+    auto begin = Clock::now();
+    int res = loop.sync([&]() -> Task<int> {
+        co_return co_await loop.cancelable(
+            loop.makeAioTask().prepRecv(sp.fds[0], buf, 0), src.get_token());
+    }());
+    EXPECT_EQ(res, -ECANCELED);
+    EXPECT_LT(Clock::now() - begin, 2s);
+    expectNoPendingIo(loop);
+}
+
+TEST(CancelableAioTest, StopInFlight) {
+    EventLoop loop;
+    SocketPair sp;
+    std::stop_source src;
+    char buf[16];
+    auto begin = Clock::now();
+    // 在另一个线程上请求停止, 取消被投递回事件循环的线程执行
+    auto stopper = std::async(std::launch::async, [&] {
+        std::this_thread::sleep_for(20ms);
+        src.request_stop();
+    });
+    int res = loop.sync([&]() -> Task<int> {
+        co_return co_await loop.cancelable(
+            loop.makeAioTask().prepRecv(sp.fds[0], buf, 0), src.get_token());
+    }());
+    stopper.get();
+    EXPECT_EQ(res, -ECANCELED);
+    EXPECT_LT(Clock::now() - begin, 2s);
+    expectNoPendingIo(loop);
+
+    // 取消之后套接字仍然可以正常读取 (没有残留的 recv 抢走数据)
+    ASSERT_EQ(::write(sp.fds[1], "ab", 2), 2);
+    res = loop.sync([&]() -> Task<int> {
+        co_return co_await loop.makeAioTask().prepRecv(sp.fds[0], buf, 0);
+    }());
+    EXPECT_EQ(res, 2);
+}
+
+TEST(CancelableAioTest, StopAfterCompletion) {
+    EventLoop loop;
+    SocketPair sp;
+    std::stop_source src;
+    char buf[16];
+    ASSERT_EQ(::write(sp.fds[1], "abc", 3), 3);
+    int res = loop.sync([&]() -> Task<int> {
+        int n = co_await loop.cancelable(
+            loop.makeAioTask().prepRecv(sp.fds[0], buf, 0), src.get_token());
+        // 已经完成后再请求停止: 回调已经注销, 什么也不会发生
+        src.request_stop();
+        co_await loop.makeTimer().sleepFor(5ms);
+        co_return n;
+    }());
+    EXPECT_EQ(res, 3);
+    expectNoPendingIo(loop);
+}
+
+TEST(CancelableTimerTest, StopBeforeSubmission) {
+    EventLoop loop;
+    std::stop_source src;
+    src.request_stop();
+    auto begin = Clock::now();
+    int res = loop.sync(loop.cancelable(loop.makeTimer().sleepFor(10s), src.get_token()));
+    EXPECT_EQ(res, -ECANCELED);
+    EXPECT_LT(Clock::now() - begin, 2s);
+    expectNoPendingIo(loop);
+}
+
+TEST(CancelableTimerTest, StopInFlight) {
+    EventLoop loop;
+    std::stop_source src;
+    auto begin = Clock::now();
+    auto stopper = std::async(std::launch::async, [&] {
+        std::this_thread::sleep_for(20ms);
+        src.request_stop();
+    });
+    int res = loop.sync(loop.cancelable(loop.makeTimer().sleepFor(10s), src.get_token()));
+    stopper.get();
+    EXPECT_EQ(res, -ECANCELED);
+    EXPECT_LT(Clock::now() - begin, 2s);
+    expectNoPendingIo(loop);
+}
+
+TEST(CancelableTimerTest, StopAfterCompletion) {
+    EventLoop loop;
+    std::stop_source src;
+    int res = loop.sync([&]() -> Task<int> {
+        int r = co_await loop.cancelable(loop.makeTimer().sleepFor(1ms), src.get_token());
+        src.request_stop();
+        co_await loop.makeTimer().sleepFor(5ms);
+        co_return r;
+    }());
+    EXPECT_EQ(res, 0);
+    expectNoPendingIo(loop);
+}
+
+constexpr uint16_t kPort = 28310;
+
+TEST(ServerStopTest, StopsPromptlyWithIdleKeepAliveConnections) {
+    auto ser = std::make_unique<net::HttpServer>("127.0.0.1", std::to_string(kPort));
+    ser->addEndpoint<net::GET>("/", [] ENDPOINT {
+        co_await res.setStatusAndContent(net::Status::CODE_200, "hello").sendRes();
+    });
+    ser->asyncRun(2);
+    test::waitForServer(kPort);
+
+    // 每个连接完成一个请求后保持空闲; 保活超时 (默认 30s) 远长于期望的关闭耗时
+    std::vector<std::unique_ptr<test::RawHttpClient>> clis;
+    for (int i = 0; i < 8; ++i) {
+        auto& cli = clis.emplace_back(std::make_unique<test::RawHttpClient>(kPort));
+        cli->send("GET / HTTP/1.1\r\nHost: x\r\n\r\n");
+        ASSERT_EQ(test::splitResponses(cli->recvSome()).size(), 1u);
+    }
+    auto begin = Clock::now();
+    auto done = std::async(std::launch::async, [&] {
+        ser.reset();
+    });
+    if (done.wait_for(10s) != std::future_status::ready) {
+        ADD_FAILURE() << "server did not stop";
+        std::abort();
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin);
+    EXPECT_LT(cost, 1s) << cost.count() << " ms";
+    for (auto& cli : clis) {
+        cli->recvAll();
+        EXPECT_TRUE(cli->isClosed());
+    }
+}
+
+} // namespace
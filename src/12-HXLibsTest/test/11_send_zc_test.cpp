@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+
+#include <future>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+#include <HXLibs/net/socket/IO.hpp>
+
+using namespace HX;
+using namespace HX::coroutine;
+
+namespace {
+
+constexpr std::size_t kMaxSize = static_cast<std::size_t>(-1);
+
+/**
+ * @brief 一对已经连接的本地 TCP 套接字 (零拷贝发送需要 TCP; AF_UNIX 不支持)
+ */
+struct TcpPair {
+    TcpPair() {
+        int lfd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        ::sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = ::htonl(INADDR_LOOPBACK);
+        ::socklen_t len = sizeof(addr);
+        ::bind(lfd, reinterpret_cast<::sockaddr*>(&addr), len);
+        ::listen(lfd, 1);
+        ::getsockname(lfd, reinterpret_cast<::sockaddr*>(&addr), &len);
+        rd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        ::connect(rd, reinterpret_cast<::sockaddr*>(&addr), len);
+        wr = ::accept4(lfd, nullptr, nullptr, SOCK_CLOEXEC);
+        ::close(lfd);
+    }
+
+    ~TcpPair() noexcept {
+        ::close(rd);
+        if (wr >= 0) {
+            ::close(wr);
+        }
+    }
+
+    int rd;
+    int wr;
+};
+
+/**
+ * @brief 在另一个线程上读取 n 字节
+ */
+std::future<std::string> readN(int fd, std::size_t n) {
+    return std::async(std::launch::async, [fd, n] {
+        std::string res;
+        char buf[1 << 16];
+        while (res.size() < n) {
+            auto r = ::recv(fd, buf, sizeof(buf), 0);
+            if (r <= 0) {
+                break;
+            }
+            res.append(buf, static_cast<std::size_t>(r));
+        }
+        return res;
+    });
+}
+
+bool isSendZcSupported() {
+    ::io_uring_probe* probe = ::io_uring_get_probe();
+    bool res = probe && ::io_uring_opcode_supported(probe, IORING_OP_SEND_ZC);
+    if (probe) {
+        ::io_uring_free_probe(probe);
+    }
+    return res;
+}
+
+} // namespace
+
+TEST(SendZcTest, BufferIsReleasedOnlyAfterWait) {
+    if (!isSendZcSupported()) {
+        GTEST_SKIP() << "IORING_OP_SEND_ZC is not supported";
+    }
+    EventLoop loop;
+    TcpPair tcp;
+    constexpr std::size_t kSize = 1 << 20;
+    auto received = readN(tcp.rd, 2 * kSize);
+    loop.sync([&]() -> Task<> {
+        SendZcNotifier notifier;
+        // 没有发送过时 wait() 立即返回
+        co_await notifier.wait();
+        std::vector<char> buf(kSize, 'a');
+        for (char c : {'a', 'b'}) {
+            std::fill(buf.begin(), buf.end(), c);
+            int n = co_await loop.makeAioTask().prepSendZc(tcp.wr, buf, MSG_WAITALL, 0, notifier);
+            EXPECT_EQ(n, static_cast<int>(kSize));
+            co_await notifier.wait();
+            // wait() 返回时, 通知的 cqe 已经收到: 内核不再引用 buf, 之后可以改写它
+            EXPECT_FALSE(loop.getEventDrive().isRun());
+        }
+    }());
+    auto data = received.get();
+    ASSERT_EQ(data.size(), 2 * kSize);
+    EXPECT_EQ(data, std::string(kSize, 'a') + std::string(kSize, 'b'));
+}
+
+TEST(SendZcTest, SecondOutstandingSendIsRejected) {
+    if (!isSendZcSupported()) {
+        GTEST_SKIP() << "IORING_OP_SEND_ZC is not supported";
+    }
+    EventLoop loop;
+    TcpPair tcp;
+    std::string a(4096, 'a'), b(4096, 'b'), c(4096, 'c');
+    auto received = readN(tcp.rd, a.size() + c.size());
+    loop.sync([&]() -> Task<> {
+        SendZcNotifier notifier;
+        AioTask first = loop.makeAioTask();
+        (void)std::move(first).prepSendZc(tcp.wr, a, MSG_WAITALL, 0, notifier);
+        // 结果的 cqe 只能恢复一个任务: 上一次发送的结果返回之前不能再关联
+        EXPECT_THROW({
+            AioTask second = loop.makeAioTask();
+            (void)std::move(second).prepSendZc(tcp.wr, b, MSG_WAITALL, 0, notifier);
+        }, std::logic_error);
+        EXPECT_EQ(co_await first, static_cast<int>(a.size()));
+        // 得到结果后就可以继续发送, 不必等待通知
+        EXPECT_EQ(co_await loop.makeAioTask().prepSendZc(tcp.wr, c, MSG_WAITALL, 0, notifier),
+                  static_cast<int>(c.size()));
+        co_await notifier.wait();
+        // 被拒绝的 sqe 作为空操作提交, 它的 cqe 也已经处理
+        EXPECT_FALSE(loop.getEventDrive().isRun());
+    }());
+    EXPECT_EQ(received.get(), a + c);
+}
+
+TEST(SendZcTest, ProbeMatchesTheKernel) {
+    // 默认关闭, 不探测
+    EventLoop off;
+    EXPECT_EQ(off.getEventDrive().sendZcThreshold(), kMaxSize);
+    EXPECT_EQ(off.getEventDrive().sendmsgZcThreshold(), kMaxSize);
+
+    EventLoop on{EventLoopConfig{.sendZcThreshold = 4096}};
+    ::io_uring_probe* probe = ::io_uring_get_probe();
+    ASSERT_TRUE(probe);
+    // 内核不支持的操作, 阈值回退为最大值 (之后都使用普通发送)
+    EXPECT_EQ(on.getEventDrive().sendZcThreshold(),
+        ::io_uring_opcode_supported(probe, IORING_OP_SEND_ZC) ? 4096 : kMaxSize);
+    EXPECT_EQ(on.getEventDrive().sendmsgZcThreshold(),
+        ::io_uring_opcode_supported(probe, IORING_OP_SENDMSG_ZC) ? 4096 : kMaxSize);
+    ::io_uring_free_probe(probe);
+}
+
+TEST(SendZcTest, FullySendZcFallsBackOnUnsupportedSocket) {
+    EventLoop loop{EventLoopConfig{.sendZcThreshold = 1}};
+    // AF_UNIX 不支持零拷贝 (-EOPNOTSUPP), 回退为普通发送, 数据完整
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+    std::string data(1 << 20, 'x');
+    for (std::size_t i = 0; i < data.size(); i += 4096) {
+        data[i] = static_cast<char>('a' + i / 4096 % 26);
+    }
+    auto received = readN(fds[1], 2 * data.size());
+    loop.sync([&]() -> Task<> {
+        net::IO io{fds[0], loop};
+        co_await io.fullySendZc(data);
+        // 第二次直接使用普通发送
+        co_await io.fullySendZc(data);
+        co_await io.close();
+    }());
+    EXPECT_EQ(received.get(), data + data);
+    ::close(fds[1]);
+}
+
+TEST(SendZcTest, FullySendZcOverTcp) {
+    EventLoop loop{EventLoopConfig{.sendZcThreshold = 4096}};
+    TcpPair tcp;
+    std::string data(3 << 20, 'x');
+    for (std::size_t i = 0; i < data.size(); i += 4096) {
+        data[i] = static_cast<char>('a' + i / 4096 % 26);
+    }
+    auto received = readN(tcp.rd, data.size() + 100);
+    loop.sync([&]() -> Task<> {
+        net::IO io{tcp.wr, loop};
+        co_await io.fullySendZc(data);
+        // 小于阈值的部分使用普通发送
+        co_await io.fullySendZc(std::string_view{data}.substr(0, 100));
+        co_await io.close();
+    }());
+    tcp.wr = -1;
+    EXPECT_EQ(received.get(), data + data.substr(0, 100));
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <HXLibs/container/ThreadPool.hpp>
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+#include <HXLibs/coroutine/awaiter/ThreadPoolAwaiter.hpp>
+#include <HXLibs/coroutine/awaiter/WhenAll.hpp>
+
+using namespace HX;
+using namespace HX::coroutine;
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+
+namespace {
+
+class ScheduleTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        _pool.setFixedThreadNum(2).run<container::ThreadPool::Model::FixedSizeAndNoCheck>();
+    }
+
+    container::ThreadPool _pool;
+};
+
+TEST_F(ScheduleTest, ResumesOnTheOriginatingLoopThread) {
+    EventLoop loop;
+    auto loopId = std::this_thread::get_id();
+    std::thread::id workId;
+    auto res = loop.sync([&]() -> Task<std::unique_ptr<int>> {
+        // 返回值可以是只能移动的类型
+        auto p = co_await schedule(_pool, [&] {
+            workId = std::this_thread::get_id();
+            return std::make_unique<int>(42);
+        });
+        EXPECT_EQ(std::this_thread::get_id(), loopId);
+        EXPECT_EQ(EventLoop::current(), &loop);
+        co_return p;
+    }());
+    ASSERT_TRUE(res);
+    EXPECT_EQ(*res, 42);
+    EXPECT_NE(workId, loopId);
+}
+
+TEST_F(ScheduleTest, ExceptionIsRethrownAtCoAwait) {
+    EventLoop loop;
+    auto loopId = std::this_thread::get_id();
+    loop.sync([&]() -> Task<> {
+        try {
+            co_await schedule(_pool, []() -> int {
+                throw std::runtime_error{"boom"};
+            });
+            ADD_FAILURE() << "not thrown";
+        } catch (std::runtime_error const& err) {
+            EXPECT_EQ(err.what(), "boom"s);
+            // 异常同样在原来的事件循环的线程上抛出
+            EXPECT_EQ(std::this_thread::get_id(), loopId);
+        }
+        bool isThrown = false;
+        try {
+            co_await schedule(_pool, [] {
+                throw std::logic_error{"void"};
+            });
+        } catch (std::logic_error const&) {
+            isThrown = true;
+        }
+        EXPECT_TRUE(isThrown);
+    }());
+}
+
+TEST_F(ScheduleTest, LoopStaysAliveWhileWorkRuns) {
+    EventLoop loop;
+    std::atomic_bool isDone{false};
+    // 事件循环中没有 IO 与定时器: 如果不 retain, run() 会立即退出, sync 拿不到结果
+    int res = loop.sync([&]() -> Task<int> {
+        co_return co_await schedule(_pool, [&] {
+            std::this_thread::sleep_for(100ms);
+            isDone = true;
+            return 7;
+        });
+    }());
+    EXPECT_EQ(res, 7);
+    EXPECT_TRUE(isDone);
+    // 之后事件循环为空, 可以再次 sync
+    EXPECT_FALSE(loop.getEventDrive().isRun());
+}
+
+TEST_F(ScheduleTest, LoopIsNotBlockedWhileWorkRuns) {
+    EventLoop loop;
+    std::atomic_bool isTicked{false};
+    auto work = [&]() -> Task<bool> {
+        // 任务等待事件循环上的定时器协程设置标记 (最多 5s); 如果事件循环被阻塞, 就等不到
+        co_return co_await schedule(_pool, [&] {
+            for (int i = 0; i < 1000 && !isTicked; ++i) {
+                std::this_thread::sleep_for(5ms);
+            }
+            return isTicked.load();
+        });
+    };
+    auto tick = [&]() -> Task<> {
+        co_await loop.makeTimer().sleepFor(1ms);
+        isTicked = true;
+    };
+    auto [isSeen, _] = loop.sync(whenAll(work(), tick()));
+    EXPECT_TRUE(isSeen);
+}
+
+} // namespace
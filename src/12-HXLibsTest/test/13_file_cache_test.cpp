@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <HXLibs/coroutine/loop/EventLoop.hpp>
+#include <HXLibs/net/protocol/http/FileCache.hpp>
+
+using namespace HX;
+using namespace std::chrono_literals;
+
+namespace {
+
+namespace fs = std::filesystem;
+
+using FilePtr = std::shared_ptr<net::CachedFile const>;
+
+class FileCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        _dir = fs::temp_directory_path() / ("hx_file_cache_" + std::to_string(::getpid()));
+        fs::create_directories(_dir);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(_dir, ec);
+    }
+
+    std::string write(std::string const& name, std::string_view data) {
+        auto path = (_dir / name).string();
+        std::ofstream{path, std::ios::binary | std::ios::trunc} << data;
+        return path;
+    }
+
+    /**
+     * @brief 通过 rename 把 name 替换为一个新文件 (新的 inode)
+     */
+    void replace(std::string const& name, std::string_view data) {
+        auto tmp = write(name + ".tmp", data);
+        fs::rename(tmp, _dir / name);
+    }
+
+    FilePtr open(std::string const& path) {
+        return _loop.sync(_cache.open(_loop, path));
+    }
+
+    /**
+     * @brief 通过缓存的 fd 读取整个文件
+     */
+    static std::string read(FilePtr const& file) {
+        std::string res(file->size, '\0');
+        auto n = ::pread(file->fd, res.data(), res.size(), 0);
+        res.resize(n < 0 ? 0 : static_cast<std::size_t>(n));
+        return res;
+    }
+
+    static void setMtime(std::string const& path, ::timespec mtime) {
+        ::timespec ts[2]{mtime, mtime};
+        ASSERT_EQ(::utimensat(AT_FDCWD, path.c_str(), ts, 0), 0);
+    }
+
+    fs::path _dir;
+    coroutine::EventLoop _loop;
+    net::FileCache _cache;
+};
+
+TEST_F(FileCacheTest, HitReturnsTheSameFile) {
+    auto path = write("a", "hello");
+    auto f = open(path);
+    EXPECT_EQ(read(f), "hello");
+    EXPECT_EQ(open(path), f);
+    EXPECT_EQ(_cache.size(), 1u);
+}
+
+TEST_F(FileCacheTest, LruEvictionAtSetMaxSize) {
+    std::vector<std::string> paths;
+    std::vector<FilePtr> files;
+    for (auto name : {"a", "b", "c", "d"}) {
+        paths.push_back(write(name, name));
+        files.push_back(open(paths.back()));
+    }
+    EXPECT_EQ(_cache.size(), 4u);
+    // 访问 a, 使它成为最近使用的; 之后缩小到 2 个, 留下 a 与 d
+    EXPECT_EQ(open(paths[0]), files[0]);
+    _cache.setMaxSize(2);
+    EXPECT_EQ(_cache.size(), 2u);
+    EXPECT_EQ(open(paths[3]), files[3]);
+    EXPECT_EQ(open(paths[0]), files[0]);
+    // b 已被淘汰, 重新打开; 淘汰的是此时最久未使用的 d
+    auto b = open(paths[1]);
+    EXPECT_NE(b, files[1]);
+    EXPECT_EQ(_cache.size(), 2u);
+    EXPECT_NE(open(paths[3]), files[3]);
+    // 已被淘汰但仍被持有的文件, fd 仍然有效
+    EXPECT_EQ(read(files[1]), "b");
+    EXPECT_EQ(read(files[2]), "c");
+
+    _cache.setMaxSize(0);
+    EXPECT_EQ(_cache.size(), 0u);
+    EXPECT_NE(open(paths[0]), open(paths[0]));
+    EXPECT_EQ(_cache.size(), 0u);
+}
+
+TEST_F(FileCacheTest, EmptyFileIsNotCached) {
+    auto path = write("empty", "");
+    EXPECT_NE(open(path), open(path));
+    EXPECT_EQ(_cache.size(), 0u);
+}
+
+TEST_F(FileCacheTest, InPlaceChangeIsDetectedImmediately) {
+    auto path = write("a", "hello");
+    auto f = open(path);
+    // 原地改写 (同一个 inode, 大小变化): 命中时用 fd 检查, 不等 ttl
+    write("a", "hello world");
+    auto g = open(path);
+    EXPECT_NE(g, f);
+    EXPECT_EQ(g->ino, f->ino);
+    EXPECT_EQ(read(g), "hello world");
+}
+
+TEST_F(FileCacheTest, RevalidatesByStatxAfterTtl) {
+    _cache.setTtl(300ms);
+    auto path = write("a", "hello");
+    auto f = open(path);
+
+    // 过期之后, 没有变化的文件重新验证后继续使用
+    std::this_thread::sleep_for(350ms);
+    EXPECT_EQ(open(path), f);
+
+    // 被 rename 替换为大小、修改时间都相同的新文件, 只有 inode 不同
+    replace("a", "HELLO");
+    setMtime(path, {f->mtime, static_cast<long>(f->mtimeNsec)});
+    // ttl 之内仍然返回旧的文件 (旧的 inode 没有变化, fd 检查通过)
+    EXPECT_EQ(open(path), f);
+    EXPECT_EQ(read(f), "hello");
+
+    std::this_thread::sleep_for(350ms);
+    auto g = open(path);
+    EXPECT_NE(g, f);
+    EXPECT_NE(g->ino, f->ino);
+    EXPECT_EQ(g->etag, f->etag);
+    EXPECT_EQ(read(g), "HELLO");
+    // 旧的文件仍然被持有, 读到的还是旧的内容
+    EXPECT_EQ(read(f), "hello");
+    EXPECT_EQ(open(path), g);
+}
+
+TEST_F(FileCacheTest, RemovedFileThrowsAfterTtl) {
+    _cache.setTtl(50ms);
+    auto path = write("a", "hello");
+    auto f = open(path);
+    fs::remove(path);
+    std::this_thread::sleep_for(60ms);
+    EXPECT_THROW(open(path), std::system_error);
+    EXPECT_EQ(_cache.size(), 0u);
+}
+
+TEST_F(FileCacheTest, EtagAndLastModified) {
+    auto path = write("a", "hello");
+    // 784111777 = 0x2ebc98a1
+    setMtime(path, {784111777, 0});
+    auto f = open(path);
+    EXPECT_EQ(f->size, 5u);
+    EXPECT_EQ(f->etag, "\"2ebc98a1-5\"");
+    EXPECT_EQ(f->lastModified, "Sun, 06 Nov 1994 08:49:37 GMT");
+
+    // 大小或修改时间变化, ETag 随之变化
+    write("a", "hello!");
+    setMtime(path, {784111777, 0});
+    auto g = open(path);
+    EXPECT_EQ(g->etag, "\"2ebc98a1-6\"");
+    EXPECT_EQ(g->lastModified, f->lastModified);
+
+    setMtime(path, {784111778, 0});
+    auto h = open(path);
+    EXPECT_EQ(h->etag, "\"2ebc98a2-6\"");
+    EXPECT_EQ(h->lastModified, "Sun, 06 Nov 1994 08:49:38 GMT");
+}
+
+} // namespace
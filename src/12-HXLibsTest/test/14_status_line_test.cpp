@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <HXLibs/net/Api.hpp>
+
+#include <RawHttpClient.hpp>
+
+using namespace HX;
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace {
+
+TEST(StatusLineTest, MatchesTheDescriptionForEveryKnownCode) {
+    std::size_t knownNum = 0;
+    for (int code = 0; code < 1000; ++code) {
+        auto status = static_cast<net::Status>(code);
+        auto msg = net::getStatusCodeDataStrView(status);
+        auto line = net::getStatusLineStrView(status);
+        if (msg.empty()) {
+            // 未知的状态码 (包括表的范围之外的) 没有响应行
+            EXPECT_TRUE(line.empty()) << code;
+            continue;
+        }
+        ++knownNum;
+        EXPECT_EQ(line, "HTTP/1.1 "s + std::to_string(code) + " " + std::string{msg} + "\r\n") << code;
+    }
+    // 与 Status 中列出的状态码个数一致
+    EXPECT_EQ(knownNum, 62u);
+}
+
+TEST(StatusLineTest, IsUsableAtCompileTime) {
+    static_assert(net::getStatusLineStrView(net::Status::CODE_200) == "HTTP/1.1 200 OK\r\n"sv);
+    static_assert(net::getStatusLineStrView(net::Status::CODE_511)
+                  == "HTTP/1.1 511 Network Authentication Required\r\n"sv);
+    static_assert(net::getStatusLineStrView(static_cast<net::Status>(299)).empty());
+    static_assert(net::getStatusLineStrView(static_cast<net::Status>(-1)).empty());
+    SUCCEED();
+}
+
+constexpr uint16_t kPort = 28314;
+
+/**
+ * @brief 响应头中名为 key 的行数 (不区分大小写)
+ */
+std::size_t countHeader(std::string_view raw, std::string_view key) {
+    auto head = raw.substr(0, raw.find("\r\n\r\n"));
+    std::size_t n = 0;
+    for (auto pos = head.find("\r\n"); pos != std::string_view::npos; pos = head.find("\r\n", pos + 2)) {
+        auto line = head.substr(pos + 2, key.size() + 1);
+        n += line.size() == key.size() + 1 && line.back() == ':'
+            && net::RequestHeaderView::equalsIgnoreCase(line.substr(0, key.size()), key);
+    }
+    return n;
+}
+
+class DefaultHeadersTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        _ser = std::make_unique<net::HttpServer>("127.0.0.1", std::to_string(kPort));
+        _ser->addEndpoint<net::GET>("/", [] ENDPOINT {
+            co_await res.setStatusAndContent(net::Status::CODE_200, "x").sendRes();
+        });
+        _ser->addEndpoint<net::GET>("/custom", [] ENDPOINT {
+            co_await res.setStatusAndContent(net::Status::CODE_200, "x")
+                        .addHeader("Server", "custom")
+                        .addHeader("Date", "Thu, 01 Jan 1970 00:00:00 GMT")
+                        .sendRes();
+        });
+        _ser->addEndpoint<net::GET>("/lower", [] ENDPOINT {
+            co_await res.setStatusAndContent(net::Status::CODE_200, "x")
+                        .addHeader("connection", "keep-alive")
+                        .addHeader("server", "lower")
+                        .sendRes();
+        });
+        _ser->addEndpoint<net::GET>("/close", [] ENDPOINT {
+            co_await res.setStatusAndContent(net::Status::CODE_200, "x")
+                        .addHeader("Connection", "close")
+                        .sendRes();
+        });
+        _ser->asyncRun(1);
+        test::waitForServer(kPort);
+    }
+
+    static void TearDownTestSuite() {
+        _ser.reset();
+    }
+
+    static std::string get(std::string_view path) {
+        test::RawHttpClient cli{kPort};
+        cli.send("GET "s + std::string{path} + " HTTP/1.1\r\nHost: x\r\n\r\n");
+        return cli.recvSome();
+    }
+
+    inline static std::unique_ptr<net::HttpServer> _ser;
+};
+
+TEST_F(DefaultHeadersTest, DefaultsAreSentOnce) {
+    auto raw = get("/");
+    EXPECT_TRUE(raw.starts_with("HTTP/1.1 200 OK\r\n"));
+    EXPECT_EQ(countHeader(raw, "connection"), 1u);
+    EXPECT_EQ(countHeader(raw, "server"), 1u);
+    EXPECT_EQ(countHeader(raw, "date"), 1u);
+    auto res = test::splitResponses(raw);
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].headers["connection"], "keep-alive");
+    EXPECT_EQ(res[0].headers["server"], "HXLibs::net");
+}
+
+TEST_F(DefaultHeadersTest, UserHeadersSuppressTheDefaults) {
+    auto raw = get("/custom");
+    EXPECT_EQ(countHeader(raw, "server"), 1u);
+    EXPECT_EQ(countHeader(raw, "date"), 1u);
+    // 没有被设置的仍然使用默认的
+    EXPECT_EQ(countHeader(raw, "connection"), 1u);
+    auto res = test::splitResponses(raw);
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].headers["server"], "custom");
+    EXPECT_EQ(res[0].headers["date"], "Thu, 01 Jan 1970 00:00:00 GMT");
+    EXPECT_EQ(res[0].headers["connection"], "keep-alive");
+
+    raw = get("/close");
+    EXPECT_EQ(countHeader(raw, "connection"), 1u);
+    EXPECT_EQ(countHeader(raw, "server"), 1u);
+    EXPECT_EQ(countHeader(raw, "date"), 1u);
+    res = test::splitResponses(raw);
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].headers["connection"], "close");
+}
+
+TEST_F(DefaultHeadersTest, UserHeadersMatchCaseInsensitively) {
+    auto raw = get("/lower");
+    EXPECT_EQ(countHeader(raw, "connection"), 1u);
+    EXPECT_EQ(countHeader(raw, "server"), 1u);
+    EXPECT_EQ(countHeader(raw, "date"), 1u);
+    auto res = test::splitResponses(raw);
+    ASSERT_EQ(res.size(), 1u);
+    EXPECT_EQ(res[0].headers["server"], "lower");
+}
+
+} // namespace
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <HXLibs/coroutine/loop/Scheduler.hpp>
+
+using namespace HX::coroutine;
+using namespace std::chrono_literals;
+
+namespace {
+
+/**
+ * @brief 等待条件成立 (最多 10s), 避免出错时测试卡死
+ */
+template <typename Pred>
+bool waitFor(Pred&& pred) {
+    auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+Task<> findLoop(std::atomic<EventLoop*>& res) {
+    res = &Scheduler::currentLoop();
+    co_return;
+}
+
+TEST(SchedulerTest, EveryTaskRunsExactlyOnceUnderSkewedLoad) {
+    constexpr std::size_t kTaskNum = 200;
+    constexpr std::size_t kRoundNum = 20;
+    std::vector<std::atomic_int> startNum(kTaskNum);
+    std::vector<std::atomic_size_t> roundNum(kTaskNum);
+    std::atomic_size_t doneNum{0};
+    std::mutex mtx;
+    std::set<std::thread::id> threadIds;
+    {
+        Scheduler s{4};
+        std::atomic<EventLoop*> hot{nullptr};
+        s.spawn(findLoop(hot));
+        ASSERT_TRUE(waitFor([&] { return hot.load() != nullptr; }));
+        auto work = [&](std::size_t id) -> Task<> {
+            ++startNum[id];
+            // 全部先切换到同一个事件循环, 之后只能靠窃取分散到其他线程
+            co_await hot.load()->schedule();
+            for (std::size_t r = 0; r < kRoundNum; ++r) {
+                {
+                    std::lock_guard _{mtx};
+                    threadIds.insert(std::this_thread::get_id());
+                }
+                std::this_thread::sleep_for(10us);
+                ++roundNum[id];
+                co_await s.yield();
+            }
+            ++doneNum;
+        };
+        for (std::size_t i = 0; i < kTaskNum; ++i) {
+            s.spawn(work(i));
+        }
+        ASSERT_TRUE(waitFor([&] { return doneNum.load() == kTaskNum; }));
+    }
+    for (std::size_t i = 0; i < kTaskNum; ++i) {
+        EXPECT_EQ(startNum[i].load(), 1) << "task " << i;
+        EXPECT_EQ(roundNum[i].load(), kRoundNum) << "task " << i;
+    }
+    EXPECT_EQ(doneNum.load(), kTaskNum);
+    // 热点线程上的就绪协程被其他线程窃取了
+    EXPECT_GT(threadIds.size(), 1u);
+}
+
+TEST(SchedulerTest, YieldThrowsWhenStopped) {
+    constexpr int kTaskNum = 8;
+    std::atomic_int startNum{0}, thrownNum{0};
+    Scheduler s{2};
+    auto yielder = [&]() -> Task<> {
+        ++startNum;
+        try {
+            // 不停地让出: stop() 时要么在就绪队列中, 要么正要放回队列
+            for (;;) {
+                co_await s.yield();
+            }
+        } catch (std::runtime_error const&) {
+            ++thrownNum;
+        }
+    };
+    for (int i = 0; i < kTaskNum; ++i) {
+        s.spawn(yielder());
+    }
+    ASSERT_TRUE(waitFor([&] { return startNum.load() == kTaskNum; }));
+    s.stop();
+    EXPECT_EQ(thrownNum.load(), kTaskNum);
+}
+
+TEST(SchedulerTest, SpawnAfterStopNeverRuns) {
+    Scheduler s{2};
+    s.stop();
+    bool isRun = false;
+    s.spawn([&]() -> Task<> {
+        isRun = true;
+        co_return;
+    }());
+    EXPECT_FALSE(isRun);
+    // 重复 stop 不会出错
+    s.stop();
+    EXPECT_FALSE(isRun);
+}
+
+} // namespace
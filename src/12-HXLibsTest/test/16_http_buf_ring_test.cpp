@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <HXLibs/net/Api.hpp>
+
+#include <RawHttpClient.hpp>
+
+using namespace HX;
+using namespace std::string_literals;
+
+namespace {
+
+constexpr uint16_t kPort = 28316;
+
+// 同 IoUring::kBufRingEntries; 并发的请求比它多, 才会把环耗尽
+constexpr int kRingEntries = 256;
+constexpr int kConnNum = kRingEntries + 44;
+
+// bidOf 的特殊结果
+constexpr int kHeapBuf = -1;    // 退化为自己申请的缓冲区
+constexpr int kNoRing = -2;     // 内核不支持 provided buffer ring
+
+std::atomic_bool gIsReleased{false};
+std::atomic_int gEnteredNum{0};
+std::mutex gMtx;
+std::vector<int> gBids;
+
+/**
+ * @brief 视图所在的 provided buffer 的 id
+ */
+int bidOf(char const* p) {
+    auto* ring = coroutine::EventLoop::current()->getEventDrive().getProvidedBufRing();
+    if (!ring) {
+        return kNoRing;
+    }
+    auto off = p - ring->getBuf(0).data();
+    auto bufSize = static_cast<std::ptrdiff_t>(ring->bufSize());
+    if (off < 0 || off >= kRingEntries * bufSize) {
+        return kHeapBuf;
+    }
+    return static_cast<int>(off / bufSize);
+}
+
+class HttpBufRingTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        _ser = std::make_unique<net::HttpServer>("127.0.0.1", std::to_string(kPort));
+        _ser->addEndpoint<net::GET>("/", [] ENDPOINT {
+            co_await res.setStatusAndContent(net::Status::CODE_200, "hello").sendRes();
+        });
+        _ser->addEndpoint<net::GET>("/wait", [] ENDPOINT {
+            auto bid = bidOf(req.getHeadersView().at("x-id").data());
+            {
+                std::lock_guard _{gMtx};
+                gBids.push_back(bid);
+            }
+            ++gEnteredNum;
+            // 等到所有连接都在处理中 (最多等 10s, 以免测试挂起), 期间请求头一直固定在缓冲区中
+            for (int i = 0; i < 2000 && !gIsReleased; ++i) {
+                co_await coroutine::EventLoop::current()->makeTimer().sleepFor(
+                    std::chrono::milliseconds{5});
+            }
+            // 等待之后再读取视图: 如果缓冲区被重复分配给了其他连接, 内容就会被覆盖
+            auto id = std::string{req.getHeadersView().at("x-id")};
+            co_await res.setStatusAndContent(
+                net::Status::CODE_200, id + ";" + std::to_string(bid)).sendRes();
+        });
+        // 单个事件循环, 所有连接共享一个环
+        _ser->asyncRun(1);
+        test::waitForServer(kPort);
+    }
+
+    static void TearDownTestSuite() {
+        gIsReleased = true;
+        _ser.reset();
+    }
+
+    void SetUp() override {
+        reset();
+    }
+
+    static void reset() {
+        gIsReleased = false;
+        gEnteredNum = 0;
+        std::lock_guard _{gMtx};
+        gBids.clear();
+    }
+
+    static std::string waitReq(std::string_view id) {
+        return "GET /wait HTTP/1.1\r\nHost: x\r\nX-Id: "s + std::string{id} + "\r\n\r\n";
+    }
+
+    static bool waitEntered(int n) {
+        for (int i = 0; i < 1000 && gEnteredNum < n; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+        return gEnteredNum == n;
+    }
+
+    /**
+     * @brief 发送 kConnNum 个同时处理中的请求, 检查环被用尽并且每个 bid 同时只属于一个连接,
+     *        之后检查每个连接收到的是自己的请求头
+     * @return int 使用 provided buffer 的连接数; 内核不支持时为 kNoRing
+     */
+    static int runExhaustingRound() {
+        // 第一个连接一定拿到 provided buffer; 它的第二个请求只到达了一部分,
+        // 要跨越 clear() 中的 unpin() 留在同一个缓冲区, 再接收剩余部分
+        auto const second = waitReq("p2");
+        auto const split = second.size() / 2;
+        test::RawHttpClient piped{kPort};
+        piped.send(waitReq("p1") + second.substr(0, split));
+        EXPECT_TRUE(waitEntered(1));
+
+        std::vector<std::unique_ptr<test::RawHttpClient>> clis;
+        for (int i = 1; i < kConnNum; ++i) {
+            clis.push_back(std::make_unique<test::RawHttpClient>(kPort));
+            clis.back()->send(waitReq(std::to_string(i)));
+        }
+        bool isAllEntered = waitEntered(kConnNum);
+        std::vector<int> bids;
+        {
+            std::lock_guard _{gMtx};
+            bids = gBids;
+        }
+        gIsReleased = true;
+        EXPECT_TRUE(isAllEntered);
+
+        for (int i = 1; i < kConnNum; ++i) {
+            auto res = test::splitResponses(clis[static_cast<std::size_t>(i - 1)]->recvSome());
+            EXPECT_EQ(res.size(), 1u) << "conn " << i;
+            if (!res.empty()) {
+                EXPECT_TRUE(res[0].body.starts_with(std::to_string(i) + ";"))
+                    << "conn " << i << ": " << res[0].body;
+            }
+        }
+
+        auto first = test::splitResponses(piped.recvSome());
+        EXPECT_EQ(first.size(), 1u);
+        piped.send(second.substr(split));
+        auto next = test::splitResponses(piped.recvSome());
+        EXPECT_EQ(next.size(), 1u);
+        if (first.size() == 1 && next.size() == 1) {
+            auto bid = first[0].body.substr(3);
+            EXPECT_EQ(first[0].body, "p1;" + bid);
+            // unpin() 之后仍在同一个缓冲区中
+            EXPECT_EQ(next[0].body, "p2;" + bid);
+        }
+
+        if (bids.size() && bids.front() == kNoRing) {
+            return kNoRing;
+        }
+        std::set<int> uniq;
+        int providedNum = 0;
+        for (auto bid : bids) {
+            if (bid != kHeapBuf) {
+                ++providedNum;
+                // 同一个 bid 同时属于两个连接, 说明它被重复归还了
+                EXPECT_TRUE(uniq.insert(bid).second) << "bid " << bid;
+            }
+        }
+        return providedNum;
+    }
+
+    inline static std::unique_ptr<net::HttpServer> _ser{};
+};
+
+TEST_F(HttpBufRingTest, ExhaustedRingFallsBackAndBuffersAreRecycled) {
+    auto providedNum = runExhaustingRound();
+    if (providedNum == kNoRing) {
+        GTEST_SKIP() << "provided buffer ring is not supported";
+    }
+    // 环中的缓冲区全部用上, 其余的连接退化为 hold()
+    EXPECT_EQ(providedNum, kRingEntries);
+
+    // 上一轮的响应 (及之后的 clear()) 都先于这个请求处理完, 此时缓冲区应该已经全部归还
+    auto probe = test::splitResponses(
+        test::request(kPort, "GET / HTTP/1.1\r\nConnection: close\r\n\r\n"));
+    ASSERT_EQ(probe.size(), 1u);
+    EXPECT_EQ(probe[0].body, "hello");
+
+    // 如果有 bid 丢失 (没有归还), 这一轮就拿不满环
+    reset();
+    EXPECT_EQ(runExhaustingRound(), kRingEntries);
+}
+
+} // namespace